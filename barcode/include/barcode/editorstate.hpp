@@ -30,6 +30,7 @@
 #include <hydra/system/bulletsystem.hpp>
 #include <hydra/system/playersystem.hpp>
 #include <hydra/system/renderersystem.hpp>
+#include <hydra/system/transformsystem.hpp>
 #include <hydra/system/animationsystem.hpp>
 
 #include <hydra/component/cameracomponent.hpp>
@@ -56,6 +57,7 @@ namespace Barcode {
 		inline Hydra::IO::IMeshLoader* getMeshLoader() final { return _meshLoader.get(); }
 		inline Hydra::IO::ITextFactory* getTextFactory() final { return _textFactory.get(); }
 		inline Hydra::World::ISystem* getPhysicsSystem() final { return &_physicsSystem; }
+		inline Hydra::World::ISystem* getProjectileSystem() final { return nullptr; }
 
 	private:
 		ComponentMenu* _componentMenu;
@@ -83,6 +85,7 @@ namespace Barcode {
 		Hydra::System::BulletPhysicsSystem _physicsSystem;
 		Hydra::System::BulletSystem _bulletSystem;
 		Hydra::System::PlayerSystem _playerSystem;
+		Hydra::System::TransformSystem _transformSystem;
 		Hydra::System::RendererSystem _rendererSystem;
 		Hydra::System::AnimationSystem _animationSystem;
 
@@ -11,6 +11,7 @@
 
 #include <hydra/engine.hpp>
 #include <hydra/world/world.hpp>
+#include <hydra/world/jobgraph.hpp>
 #include <hydra/renderer/renderer.hpp>
 #include <hydra/renderer/uirenderer.hpp>
 #include <hydra/io/meshloader.hpp>
@@ -40,8 +41,10 @@
 #include <hydra/system/aisystem.hpp>
 #include <hydra/system/bulletphysicssystem.hpp>
 #include <hydra/system/bulletsystem.hpp>
+#include <hydra/system/projectilesystem.hpp>
 #include <hydra/system/playersystem.hpp>
 #include <hydra/system/renderersystem.hpp>
+#include <hydra/system/transformsystem.hpp>
 #include <hydra/system/spawnersystem.hpp>
 #include <hydra/system/soundfxsystem.hpp>
 #include <hydra/system/perksystem.hpp>
@@ -70,6 +73,7 @@ namespace Barcode {
 		inline Hydra::IO::IMeshLoader* getMeshLoader() final { return _meshLoader.get(); }
 		inline Hydra::IO::ITextFactory* getTextFactory() final { return _textFactory.get(); }
 		inline Hydra::World::ISystem* getPhysicsSystem() final { return &_physicsSystem; }
+		inline Hydra::World::ISystem* getProjectileSystem() final { return &_projectileSystem; }
 
 	private:
 		Hydra::IEngine* _engine;
@@ -84,7 +88,9 @@ namespace Barcode {
 		Hydra::System::AISystem _aiSystem;
 		Hydra::System::BulletPhysicsSystem _physicsSystem;
 		Hydra::System::BulletSystem _bulletSystem;
+		Hydra::System::ProjectileSystem _projectileSystem;
 		Hydra::System::PlayerSystem _playerSystem;
+		Hydra::System::TransformSystem _transformSystem;
 		Hydra::System::RendererSystem _rendererSystem;
 		Hydra::System::SpawnerSystem _spawnerSystem;
 		Hydra::System::SoundFxSystem _soundFxSystem;
@@ -93,6 +99,10 @@ namespace Barcode {
 		Hydra::System::PickUpSystem _pickUpSystem;
 		Hydra::System::TextSystem _textSystem;
 		Hydra::System::LightSystem _lightSystem;
+		Hydra::World::JobGraph _jobGraph;
+		bool _systemTimingsOpen = false;
+		bool _allocationsOpen = false;
+		std::vector<Hydra::World::AllocationStats> _allocationStats;
 
 		std::unique_ptr<DefaultGraphicsPipeline> _dgp;
 		RenderBatch<Hydra::Renderer::Batch> _hitboxBatch;
@@ -120,8 +130,8 @@ namespace Barcode {
 
 		void _initSystem();
 		void _initWorld();
-		static void _onPlayerShoot(Hydra::Component::WeaponComponent& weapon, Hydra::World::Entity* bullet, void* userdata);
-		static void _onUpdatePVS(nlohmann::json&& json, void* userdata);
+		static void _onPlayerShoot(Hydra::Component::WeaponComponent& weapon, const Hydra::System::Projectile& bullet, void* userdata);
+		static void _onUpdatePVS(const PVS& pvs, void* userdata);
 		static void _onWin(void* userdata);
 		static void _onNoPVS(void* userdata);
 		static void _onUpdatePathMap(bool* map, void* userdata);
@@ -18,6 +18,7 @@
 #include <hydra/system/camerasystem.hpp>
 #include <hydra/system/particlesystem.hpp>
 #include <hydra/system/renderersystem.hpp>
+#include <hydra/system/transformsystem.hpp>
 #include <hydra/system/animationsystem.hpp>
 
 namespace Barcode {
@@ -35,6 +36,7 @@ namespace Barcode {
 		inline Hydra::IO::IMeshLoader* getMeshLoader() final { return _meshLoader.get(); }
 		inline Hydra::IO::ITextFactory* getTextFactory() final { return _textFactory.get(); }
 		inline Hydra::World::ISystem* getPhysicsSystem() final { return &_physicsSystem; }
+		inline Hydra::World::ISystem* getProjectileSystem() final { return nullptr; }
 
 	private:
 		Hydra::IEngine* _engine;
@@ -45,6 +47,7 @@ namespace Barcode {
 		Hydra::System::CameraSystem _cameraSystem;
 		Hydra::System::ParticleSystem _particleSystem;
 		Hydra::System::BulletPhysicsSystem _physicsSystem;
+		Hydra::System::TransformSystem _transformSystem;
 		Hydra::System::RendererSystem _rendererSystem;
 		Hydra::System::AnimationSystem _animationSystem;
 
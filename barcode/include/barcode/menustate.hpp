@@ -39,6 +39,7 @@ namespace Barcode {
 		inline Hydra::IO::IMeshLoader* getMeshLoader() final { return _meshLoader.get(); }
 		inline Hydra::IO::ITextFactory* getTextFactory() final { return _textFactory.get(); }
 		inline Hydra::World::ISystem* getPhysicsSystem() final { return &_physicsSystem; }
+		inline Hydra::World::ISystem* getProjectileSystem() final { return nullptr; }
 
 	private:
 		enum class Menu : uint8_t {
@@ -29,6 +29,7 @@
 #include <hydra/system/bulletsystem.hpp>
 #include <hydra/system/playersystem.hpp>
 #include <hydra/system/renderersystem.hpp>
+#include <hydra/system/transformsystem.hpp>
 #include <hydra/system/animationsystem.hpp>
 
 #include <hydra/component/meshcomponent.hpp>
@@ -71,6 +72,7 @@ namespace Barcode {
 		inline Hydra::IO::IMeshLoader* getMeshLoader() final { return _meshLoader.get();}
 		inline Hydra::IO::ITextFactory* getTextFactory() final { return _textFactory.get();}
 		inline Hydra::World::ISystem* getPhysicsSystem() final { return &_physicsSystem;}
+		inline Hydra::World::ISystem* getProjectileSystem() final { return nullptr; }
 
 		int oldMeshID = 0;
 
@@ -87,6 +89,7 @@ namespace Barcode {
 		Hydra::System::CameraSystem _cameraSystem;
 		Hydra::System::BulletPhysicsSystem _physicsSystem;
 		Hydra::System::PlayerSystem _playerSystem;
+		Hydra::System::TransformSystem _transformSystem;
 		Hydra::System::RendererSystem _rendererSystem;
 
 		std::unique_ptr<DefaultGraphicsPipeline> _dgp;
@@ -7,6 +7,8 @@
 
 #include <hydra/system/camerasystem.hpp>
 #include <hydra/component/roomcomponent.hpp>
+#include <hydra/pathing/pvs.hpp>
+#include <hydra/system/projectilesystem.hpp>
 
 #include <glm/glm.hpp>
 
@@ -105,12 +107,14 @@ namespace Barcode {
 	class DefaultGraphicsPipeline final : public IGraphicsPipeline {
 	public:
 		bool disablePVS = false;
+		// Drawn with the bullet batch, can be null
+		const Hydra::System::ProjectileSystem* projectiles = nullptr;
 
 		DefaultGraphicsPipeline(Hydra::System::CameraSystem& cameraSystem, const glm::ivec2& size);
 		~DefaultGraphicsPipeline();
 		void render(const glm::vec3& cameraPos, Hydra::Component::CameraComponent& cc, Hydra::Component::TransformComponent& playerTransform) final;
 
-		void updatePVS(nlohmann::json&& json);
+		void updatePVS(const PVS& pvs);
 
 	private:
 		Hydra::System::CameraSystem& _cameraSystem;
@@ -131,6 +135,7 @@ namespace Barcode {
 
 		RenderBatch<Hydra::Renderer::Batch> _copyBatch;
 		RenderBatch<Hydra::Renderer::Batch> _bulletBatch;
+		std::shared_ptr<Hydra::Renderer::IMesh> _projectileMeshes[Hydra::System::ProjectileSystem::MESH_COUNT];
 
 		RenderBatch<Hydra::Renderer::ParticleBatch> _particleBatch;
 		std::shared_ptr<Hydra::Renderer::ITexture> _particleAtlases;
@@ -145,6 +150,10 @@ namespace Barcode {
 		};
 		RenderSet _renderSets[ROOM_GRID_SIZE][ROOM_GRID_SIZE];
 
+		Hydra::World::Query<Hydra::Component::MeshComponent, Hydra::Component::DrawObjectComponent, Hydra::Component::TransformComponent> _drawables;
+		Hydra::World::Query<Hydra::Component::ParticleComponent> _emitters;
+		Hydra::World::Query<Hydra::Component::TextComponent, Hydra::Component::DrawObjectComponent> _texts;
+
 
 		static void _collectObjects(RenderSet& rs, Hydra::World::Entity* e);
 		std::vector<glm::vec3> _getSSAOKernel(size_t size);
@@ -78,7 +78,7 @@ namespace Barcode {
 			ImGui::Separator();
 			if (ImGui::MenuItem("Clear room")) {
 				if (FileTree::getRoomEntity() != nullptr)
-					FileTree::getRoomEntity()->dead = true;
+					FileTree::getRoomEntity()->kill();
 
 				auto room = world::newEntity("Workspace", world::root());
 				auto t = room->addComponent<Hydra::Component::TransformComponent>();
@@ -99,6 +99,7 @@ namespace Barcode {
 		_playerSystem.tick(delta);
 		_abilitySystem.tick(delta);
 		_particleSystem.tick(delta);
+		_transformSystem.tick(delta);
 		_rendererSystem.tick(delta);
 		_animationSystem.tick(delta);
 
@@ -170,7 +171,7 @@ namespace Barcode {
 			_componentMenu->render(_showComponentMenu, _physicsSystem);
 	}
 	void EditorState::_initSystem() {
-		const std::vector<Hydra::World::ISystem*> systems = { _engine->getDeadSystem(), &_cameraSystem, &_particleSystem, &_abilitySystem, &_aiSystem, &_physicsSystem, &_bulletSystem, &_playerSystem, &_rendererSystem };
+		const std::vector<Hydra::World::ISystem*> systems = { _engine->getDeadSystem(), &_cameraSystem, &_particleSystem, &_abilitySystem, &_aiSystem, &_physicsSystem, &_bulletSystem, &_playerSystem, &_transformSystem, &_rendererSystem };
 		_engine->getUIRenderer()->registerSystems(systems);
 	}
 	void EditorState::_initWorld() {
@@ -29,7 +29,7 @@ namespace Barcode {
 	char GameState::addr[256] = "127.0.0.1";
 	int GameState::port = 4545;
 
-	GameState::GameState() : _engine(Hydra::IEngine::getInstance()) {}
+	GameState::GameState() : _engine(Hydra::IEngine::getInstance()), _projectileSystem(_physicsSystem) {}
 	  
 	void GameState::load() {
 		Hydra::Network::NetClient::reset();
@@ -39,12 +39,19 @@ namespace Barcode {
 
 		auto windowSize = _engine->getView()->getSize();
 		_dgp = std::make_unique<DefaultGraphicsPipeline>(_cameraSystem, windowSize);
+		_dgp->projectiles = &_projectileSystem;
+		_projectileSystem.clear();
 
 		{
 			_hitboxBatch = RenderBatch<Hydra::Renderer::Batch>("assets/shaders/hitboxdebug.vert", "", "assets/shaders/hitboxdebug.frag", _engine->getView());
 			_hitboxBatch.batch.clearFlags = ClearFlags::none;
 		}
 
+		// Same order as they used to tick in, systems that conflict still tick in this order
+		for (Hydra::World::ISystem* system : std::initializer_list<Hydra::World::ISystem*>{ &_physicsSystem, &_projectileSystem, &_cameraSystem, &_bulletSystem, &_playerSystem, &_abilitySystem, &_particleSystem, &_transformSystem, &_rendererSystem,
+			&_animationSystem, &_spawnerSystem, &_soundFxSystem, &_perkSystem, &_lifeSystem, &_pickUpSystem, &_textSystem, &_lightSystem })
+			_jobGraph.add(system);
+
 		_initWorld();
 
 		aiInspector = new AIInspector();
@@ -60,6 +67,11 @@ namespace Barcode {
 			ImGui::MenuItem("AI Inspector...", nullptr, &aiInspectorOpen);
 			ImGui::EndMenu();
 		}
+		if (ImGui::BeginMenu("Debug")) {
+			ImGui::MenuItem("System timings...", nullptr, &_systemTimingsOpen);
+			ImGui::MenuItem("Allocations...", nullptr, &_allocationsOpen);
+			ImGui::EndMenu();
+		}
 	}
 
 	void GameState::runFrame(float delta) {
@@ -129,21 +141,38 @@ namespace Barcode {
 		if (_paused)
 			delta = 0;
 
-		_physicsSystem.tick(delta);
-		_cameraSystem.tick(delta);
-		_bulletSystem.tick(delta);
-		_playerSystem.tick(delta);
-		_abilitySystem.tick(delta);
-		_particleSystem.tick(delta);
-		_rendererSystem.tick(delta); 
-		_animationSystem.tick(delta);
-		_spawnerSystem.tick(delta);
-		_soundFxSystem.tick(delta);
-		_perkSystem.tick(delta);
-		_lifeSystem.tick(delta);
-		_pickUpSystem.tick(delta);
-		_textSystem.tick(delta);
-		_lightSystem.tick(delta);
+		_jobGraph.run(delta);
+		if (_systemTimingsOpen) {
+			ImGui::Begin("System timings", &_systemTimingsOpen, ImGuiWindowFlags_AlwaysAutoResize);
+			_jobGraph.registerUI();
+			ImGui::End();
+		}
+
+		if (_allocationsOpen) {
+			ImGui::Begin("Allocations", &_allocationsOpen, ImGuiWindowFlags_AlwaysAutoResize);
+			world::getAllocationStats(_allocationStats);
+			ImGui::Columns(6);
+			for (const char* title : { "Type", "Live", "Peak", "Allocations", "Chunks", "Fallbacks" }) {
+				ImGui::Text("%s", title);
+				ImGui::NextColumn();
+			}
+			for (const Hydra::World::AllocationStats& a : _allocationStats) {
+				ImGui::Text("%s (%zu B)", a.name.c_str(), a.blockSize);
+				ImGui::NextColumn();
+				ImGui::Text("%zu", a.stats.live());
+				ImGui::NextColumn();
+				ImGui::Text("%zu", a.stats.peak);
+				ImGui::NextColumn();
+				ImGui::Text("%zu", a.stats.allocations);
+				ImGui::NextColumn();
+				ImGui::Text("%zu", a.chunks);
+				ImGui::NextColumn();
+				ImGui::Text("%zu", a.stats.fallbacks);
+				ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+			ImGui::End();
+		}
 
 		static bool enableHitboxDebug = false;
 	/*	ImGui::Checkbox("Enable Hitbox Debug", &enableHitboxDebug);
@@ -492,7 +521,7 @@ namespace Barcode {
 	}
 
 	void GameState::_initSystem() {
-		const std::vector<Hydra::World::ISystem*> systems = { _engine->getDeadSystem(), &_cameraSystem, &_particleSystem, &_abilitySystem, &_aiSystem, &_physicsSystem, &_bulletSystem, &_playerSystem, &_rendererSystem, &_spawnerSystem };
+		const std::vector<Hydra::World::ISystem*> systems = { _engine->getDeadSystem(), &_cameraSystem, &_particleSystem, &_abilitySystem, &_aiSystem, &_physicsSystem, &_projectileSystem, &_bulletSystem, &_playerSystem, &_transformSystem, &_rendererSystem, &_spawnerSystem };
 		_engine->getUIRenderer()->registerSystems(systems);
 	}
 
@@ -582,16 +611,16 @@ namespace Barcode {
 		}
 	} 
 
-	void GameState::_onPlayerShoot(Hydra::Component::WeaponComponent& weapon, Hydra::World::Entity* bullet, void* userdata) {
+	void GameState::_onPlayerShoot(Hydra::Component::WeaponComponent& weapon, const Hydra::System::Projectile& bullet, void* userdata) {
 		GameState* this_ = static_cast<GameState*>(userdata);
-		Hydra::Network::NetClient::updateBullet(bullet->id);
-		Hydra::Network::NetClient::shoot(bullet->getComponent<Hydra::Component::TransformComponent>().get(), bullet->getComponent<Hydra::Component::BulletComponent>()->direction);
+		Hydra::Network::NetClient::updateBullet(bullet);
+		Hydra::Network::NetClient::shoot(bullet);
 	}
 
-	void GameState::_onUpdatePVS(nlohmann::json&& json, void* userdata) {
+	void GameState::_onUpdatePVS(const PVS& pvs, void* userdata) {
 		GameState* this_ = static_cast<GameState*>(userdata);
-		this_->_engine->log(Hydra::LogLevel::error, "Have PVS: %zu", json.size());
-		this_->_dgp->updatePVS(std::move(json));
+		this_->_engine->log(Hydra::LogLevel::error, "Have PVS");
+		this_->_dgp->updatePVS(pvs);
 	}  
 
 	void GameState::_onWin(void* userdata) {
@@ -73,7 +73,7 @@ void ImporterMenu::render(bool &closeBool, Hydra::Renderer::Batch* previewBatch,
 			{
 				if (getRoomEntity() != nullptr)
 				{
-					getRoomEntity().get()->dead = true;
+					getRoomEntity().get()->kill();
 				}
 				auto room = world::newEntity("Room", world::root());
 				auto bp = BlueprintLoader::load(workingDir + "/" + selectedNode->reverseEngineerPath());
@@ -39,6 +39,7 @@ namespace Barcode {
 		_physicsSystem.tick(delta);
 		_cameraSystem.tick(delta);
 		_particleSystem.tick(delta);
+		_transformSystem.tick(delta);
 		_rendererSystem.tick(delta);
 		_animationSystem.tick(delta);
 
@@ -91,7 +92,7 @@ namespace Barcode {
 	}
 
 	void LoseState::_initSystem() {
-		const std::vector<Hydra::World::ISystem*> systems = { _engine->getDeadSystem(), &_cameraSystem, &_particleSystem, &_physicsSystem, &_rendererSystem, &_animationSystem };
+		const std::vector<Hydra::World::ISystem*> systems = { _engine->getDeadSystem(), &_cameraSystem, &_particleSystem, &_physicsSystem, &_transformSystem, &_rendererSystem, &_animationSystem };
 		_engine->getUIRenderer()->registerSystems(systems);
 	}
 
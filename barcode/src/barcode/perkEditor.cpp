@@ -34,7 +34,7 @@ namespace Barcode
 		if (bullet.mesh != oldMeshID)
 		{
 			
-			entities[0]->dead = true;
+			entities[0]->kill();
 
 			auto newBullet = world::newEntity("bullet", world::root());
 			auto t = newBullet->addComponent<Hydra::Component::TransformComponent>();
@@ -67,6 +67,7 @@ namespace Barcode
 		_cameraSystem.tick(delta);
 		_physicsSystem.tick(delta);
 		_playerSystem.tick(delta);
+		_transformSystem.tick(delta);
 		_rendererSystem.tick(delta);
 
 		const glm::vec3 camPos = _playTrans->position;
@@ -154,7 +155,7 @@ namespace Barcode
 
 	void PerkEditorState::_initSystem()
 	{
-		const std::vector<Hydra::World::ISystem*> system = { _engine->getDeadSystem(), &_cameraSystem,&_physicsSystem,&_playerSystem, &_rendererSystem};
+		const std::vector<Hydra::World::ISystem*> system = { _engine->getDeadSystem(), &_cameraSystem,&_physicsSystem,&_playerSystem, &_transformSystem, &_rendererSystem};
 		_engine->getUIRenderer()->registerSystems(system);
 	}
 
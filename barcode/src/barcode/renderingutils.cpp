@@ -216,14 +216,13 @@ namespace Barcode {
 		auto& rs = _renderSets[gp.y][gp.x];
 
 		constexpr float radius = 5.f;
-		std::vector<std::shared_ptr<Entity>> entities;
-		world::getEntitiesWithComponents<Hydra::Component::MeshComponent, Hydra::Component::DrawObjectComponent, Hydra::Component::TransformComponent>(entities);
+		auto& entities = _drawables.getEntities();
 
 		size_t animatedObjectCounter = 0;
 		size_t animatedObjectTotal = 0;
 		size_t objectCounter = 0;
 		size_t objectTotalNormal = 0;
-		for (auto e : entities) {
+		for (auto& e : entities) {
 			auto tc = e->getComponent<Hydra::Component::TransformComponent>();
 			auto drawObj = e->getComponent<Hydra::Component::DrawObjectComponent>()->drawObject;
 			if (drawObj->disable || !drawObj->mesh || e->getComponent<Hydra::Component::BulletComponent>())
@@ -363,6 +362,23 @@ namespace Barcode {
 				auto drawObj = Hydra::World::World::getEntity(bc->entityID)->getComponent<Hydra::Component::DrawObjectComponent>()->drawObject;
 				_bulletBatch.batch.objects[drawObj->mesh].push_back(drawObj->modelMatrix);
 			}
+			if (projectiles && projectiles->size()) {
+				if (!_projectileMeshes[0])
+					for (int i = 0; i < Hydra::System::ProjectileSystem::MESH_COUNT; i++)
+						_projectileMeshes[i] = Hydra::IEngine::getInstance()->getState()->getMeshLoader()->getMesh(Hydra::System::ProjectileSystem::meshes[i]);
+				const auto& positions = projectiles->getPositions();
+				const auto& rotations = projectiles->getRotations();
+				const auto& sizes = projectiles->getSizes();
+				const auto& meshTypes = projectiles->getMeshTypes();
+				const auto& colours = projectiles->getColours();
+				for (size_t i = 0; i < projectiles->size(); i++) {
+					const glm::mat3 r = glm::mat3_cast(rotations[i]) * sizes[i];
+					_bulletBatch.batch.objects[_projectileMeshes[meshTypes[i]].get()].push_back(glm::mat4(glm::vec4(r[0], 0), glm::vec4(r[1], 0), glm::vec4(r[2], 0), glm::vec4(positions[i], 1)));
+				}
+				colour = glm::vec3(colours.back());
+				glow = colours.back().w > 0;
+				glowIntensity = colours.back().w;
+			}
 			//auto wp = Hydra::Component::WeaponComponent();
 			//glm::vec3 colour(wp.color[0], wp.color[1], wp.color[2]);
 
@@ -467,9 +483,7 @@ namespace Barcode {
 				kv.second.clear();
 				_particleBatch.batch.textureInfo.clear();
 			}
-			std::vector<std::shared_ptr<Entity>> emitters;
-			world::getEntitiesWithComponents<Hydra::Component::ParticleComponent>(emitters);
-			for (auto& ee : emitters) { // Emitter Entities
+			for (auto& ee : _emitters.getEntities()) { // Emitter Entities
 				auto pc = ee->getComponent<Hydra::Component::ParticleComponent>();
 				auto drawObj = ee->getComponent<Hydra::Component::DrawObjectComponent>();
 				auto t = ee->getComponent<Hydra::Component::TransformComponent>();
@@ -512,9 +526,7 @@ namespace Barcode {
 			_textBatch.batch.lifeFade.clear();
 			_textBatch.batch.colors.clear();
 
-			std::vector<std::shared_ptr<Entity>> entities;
-			world::getEntitiesWithComponents<Hydra::Component::TextComponent, Hydra::Component::DrawObjectComponent>(entities);
-			for (auto e : entities) {
+			for (auto& e : _texts.getEntities()) {
 				auto textC = e->getComponent<Hydra::Component::TextComponent>();
 				auto drawObj = e->getComponent<Hydra::Component::DrawObjectComponent>()->drawObject;
 				auto textData = textC->renderingData;
@@ -541,7 +553,7 @@ namespace Barcode {
 
 	}
 
-	void DefaultGraphicsPipeline::updatePVS(nlohmann::json&& json) {
+	void DefaultGraphicsPipeline::updatePVS(const PVS& pvs) {
 		// First find rooms
 		std::shared_ptr<RoomComponent> rooms[ROOM_GRID_SIZE * ROOM_GRID_SIZE];
 
@@ -605,11 +617,13 @@ namespace Barcode {
 			_collectObjects(rs, world::getEntity(room->entityID).get());
 
 			// Collect PVS info rooms
-			for (nlohmann::json& entry : json[std::to_string(room->gridPosition.y * ROOM_GRID_SIZE + room->gridPosition.x)]) {
-				auto roomID = entry.get<size_t>();
+			const size_t roomIdx = PVS::roomIndex(room->gridPosition);
+			for (size_t roomID = 0; roomID < PVS::ROOM_COUNT; roomID++) {
+				auto& r = rooms[roomID];
+				if (roomID == roomIdx || !r || !pvs.isVisible(roomIdx, roomID))
+					continue;
 				glm::ivec2 grid = {roomID % ROOM_GRID_SIZE, roomID / ROOM_GRID_SIZE};
 				auto wpOther = gridToWorld(grid);
-				auto& r = rooms[grid.y * ROOM_GRID_SIZE + grid.x];
 				rs.worldBox.push_back(glm::vec4{wpOther.x - ROOM_SIZE / 2, wpOther.y - ROOM_SIZE / 2, ROOM_SIZE, ROOM_SIZE});
 				_collectObjects(rs, world::getEntity(r->entityID).get());
 			}
@@ -38,6 +38,7 @@ namespace Barcode {
 		_physicsSystem.tick(delta);
 		_cameraSystem.tick(delta);
 		_particleSystem.tick(delta);
+		_transformSystem.tick(delta);
 		_rendererSystem.tick(delta);
 		_animationSystem.tick(delta);
 
@@ -89,7 +90,7 @@ namespace Barcode {
 	}
 
 	void WinState::_initSystem() {
-		const std::vector<Hydra::World::ISystem*> systems = { _engine->getDeadSystem(), &_cameraSystem, &_particleSystem, &_physicsSystem, &_rendererSystem, &_animationSystem };
+		const std::vector<Hydra::World::ISystem*> systems = { _engine->getDeadSystem(), &_cameraSystem, &_particleSystem, &_physicsSystem, &_transformSystem, &_rendererSystem, &_animationSystem };
 		_engine->getUIRenderer()->registerSystems(systems);
 	}
 
@@ -6,6 +6,7 @@
 
 #include <hydra/view/sdlview.hpp>
 #include <hydra/renderer/glrenderer.hpp>
+#include <hydra/world/commandbuffer.hpp>
 
 #include <hydra/component/componentmanager.hpp>
 #include <hydra/component/componentmanager_graphics.hpp>
@@ -37,10 +38,7 @@ static inline void reportMemoryLeaks() {}
 #endif
 
 static void onQuit() {
-	// Mirror Hydra::World::World::reset, but without creating a new world root
-	Hydra::World::World::_isResetting = true;
-	Hydra::World::World::_entities.clear();
-	Hydra::World::World::_map.clear();
+	Hydra::World::World::clear();
 }
 
 namespace Barcode {
@@ -58,10 +56,7 @@ namespace Barcode {
 		}
 		~Engine() final {
 			_state.reset();
-			// Mirror Hydra::World::World::reset, but without creating a new world root
-			Hydra::World::World::_isResetting = true;
-			Hydra::World::World::_entities.clear();
-			Hydra::World::World::_map.clear();
+			Hydra::World::World::clear();
 		}
 		void run() final {
 			auto lastTime = std::chrono::high_resolution_clock::now();
@@ -85,6 +80,8 @@ namespace Barcode {
 				_renderer->cleanup();
 
 				_state->runFrame(delta);
+				// For the states that tick their systems directly instead of through a JobGraph
+				Hydra::World::World::applyCommands();
 				_uiRenderer->render(delta);
 				_view->finalize();
 
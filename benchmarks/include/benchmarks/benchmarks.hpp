@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <hydra/system/bulletphysicssystem.hpp>
+#include <hydra/system/projectilesystem.hpp>
+
+namespace BarcodeBench {
+	// The engine state hands it out to the weapons, set it back to nullptr when the benchmark is done
+	void setProjectileSystem(Hydra::System::ProjectileSystem* projectileSystem);
+
+	// Spawns entities shaped like ability bullets in waves, and removes them the same way BulletSystem and DeadSystem do
+	int benchmarkEntities(size_t count);
+
+	// Fires count bullets per second at a wall, for ten seconds of server ticks, and lets ProjectileSystem move them
+	int benchmarkProjectiles(size_t count);
+
+	// Every alien finds a new path to the player each frame: with A* over the whole level, with A* over the cached room
+	// routes, and by sampling the player's flow field.
+	// Then through PathQueue, where every alien asks for a new path as soon as it has its last one and the frames are a
+	// server tick apart. Only the time spent on the main thread is counted.
+	// Last, every alien checks if it can see the player.
+	// The player takes a step to a random neighbouring tile between the frames.
+	int benchmarkPathing(size_t count);
+
+	// count random start and goal tiles, anywhere in the level, are searched with A* and then through the room cache, on
+	// four generated levels. The searches may visit the whole level. Every path that is found is walked to check that it
+	// goes from the start to the goal over open tiles, one step at a time.
+	int benchmarkAStar(size_t count);
+
+	// Aliens and players take a random step every frame, all over the level.
+	// Every alien looks for its closest player by going through every player entity like GameServer::_tick used to, and
+	// then in a SpatialIndex of the players that is filled every frame.
+	// Last, every player finds the aliens within chasing distance, by going through all of them and in an index that
+	// follows the Query of the aliens.
+	int benchmarkSpatial(size_t count);
+
+	// The level is generated the same way every run and count aliens walk around in it, shooting a bullet each every
+	// second. It is stepped single threaded first and then with btDiscreteDynamicsWorldMt on more and more threads.
+	int benchmarkPhysics(size_t count);
+
+	// Aliens chase a player that takes a random step every tick, with their rays tested in the physics system that the
+	// engine state hands out. First every alien runs on the main thread like AISystem used to, then through AISystem,
+	// where they think on the WorkerPool. Only the AI is timed, the physics step and the bullets are not.
+	int benchmarkAI(size_t count, Hydra::System::BulletPhysicsSystem& physicsSystem);
+
+	// count entities with Transform, RigidBody and AI, and half as many with only a Transform, are ticked in the ways the
+	// systems find their entities: through the components of the first type and World::getEntity like before the
+	// archetypes, with getEntitiesWithComponents, through a Query, and with forEachEntityWithComponents.
+	// Every tick moves the transform by the AI radius, so every way reads all three components.
+	int benchmarkECS(size_t count);
+
+	// A 20 player session is played and recorded first: the players run around, turning every tick, and aliens come out
+	// of the spawners, chase the closest player, attack it and die. Every one of the count ticks is then replayed through
+	// the snapshots like GameServer::_sendWorld does, to clients with a few ticks of latency, a bit of packet loss and
+	// one client that stalls for longer than the snapshot history. Every client decodes what it gets and checks it
+	// against the recording. The bytes are compared to the full EntUpdate for every entity that was sent before.
+	int benchmarkSnapshots(size_t count);
+
+	// Feeds PacketRingBuffer a random stream of count packets, cut into pieces from one byte up to many coalesced packets,
+	// and checks that every packet comes out whole, in order, aligned and still intact when the buffer is released.
+	// A packet with an invalid length must break the stream. Last, the same packets are framed from large reads to see
+	// how fast it is.
+	int benchmarkFraming(size_t count);
+
+#ifdef __linux__
+	// Connects count sockets over loopback to an EpollClientHandler, plus a few more than its connection limit.
+	// Every round each socket sends a packet in up to three pieces and the server sends a packet to every socket, but
+	// every tenth socket never reads, so its data is queued on the server. Last, half of the sockets send one more packet
+	// and close right after it.
+	int benchmarkEpoll(size_t count);
+#endif
+}
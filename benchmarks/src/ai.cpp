@@ -0,0 +1,148 @@
+#include <benchmarks/benchmarks.hpp>
+#include <hydra/world/world.hpp>
+#include <hydra/world/workerpool.hpp>
+#include <hydra/system/aisystem.hpp>
+#include <hydra/component/transformcomponent.hpp>
+#include <hydra/component/rigidbodycomponent.hpp>
+#include <hydra/component/aicomponent.hpp>
+#include <hydra/component/lifecomponent.hpp>
+#include <hydra/component/meshcomponent.hpp>
+#include <hydra/component/movementcomponent.hpp>
+#include <hydra/component/weaponcomponent.hpp>
+#include <hydra/pathing/pathfinding.hpp>
+#include <hydra/pathing/pathqueue.hpp>
+#include <server/tilegeneration.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+int BarcodeBench::benchmarkAI(size_t count, Hydra::System::BulletPhysicsSystem& physicsSystem) {
+	using world = Hydra::World::World;
+	using clock = std::chrono::high_resolution_clock;
+	const size_t tickRate = 30;
+	const size_t ticks = tickRate * 5;
+	const float delta = 1.0f / tickRate;
+
+	printf("%zu aliens, %zu ticks at %zu Hz, %zu worker threads\n", count, ticks, tickRate, Hydra::World::WorkerPool::instance().getThreadCount());
+	printf("%10s %12s %12s %10s %10s %8s\n", "AI", "Tick (ms)", "Worst (ms)", "Attacking", "Rays", "Speedup");
+	double serialTime = 0;
+	for (bool parallel : { false, true }) {
+		srand(1337);
+		std::mt19937 rng(1337);
+		world::reset();
+		Hydra::System::ProjectileSystem projectileSystem(physicsSystem);
+		Hydra::System::AISystem aiSystem;
+		// The aliens fire into the ProjectileSystem of the engine state
+		setProjectileSystem(&projectileSystem);
+
+		BarcodeServer::TileGeneration tiles(31, "assets/room/starterRoom.room", nullptr, nullptr, 0);
+		tiles.buildMap();
+		PathFinding::setRoomGrid(tiles.roomGrid);
+		const PathMap* map = tiles.pathfindingMap;
+		auto toWorld = [](const glm::ivec2& tile) { return glm::vec3((tile.x + 0.5f) / ROOM_SCALE, 0, (tile.y + 0.5f) / ROOM_SCALE); };
+		glm::ivec2 playerTile(WORLD_MAP_SIZE / 2, WORLD_MAP_SIZE / 2);
+		for (int i = 0; i < WORLD_MAP_SIZE && !map->isOpen(playerTile); i++)
+			playerTile.x++;
+		if (!map->isOpen(playerTile)) {
+			printf("No walkable tile in the middle room\n");
+			return 1;
+		}
+
+		auto floor = world::newEntity("Floor", world::root());
+		floor->addComponent<Hydra::Component::TransformComponent>();
+		floor->addComponent<Hydra::Component::RigidBodyComponent>()->createStaticPlane(glm::vec3(0, 1, 0), 0, Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_FLOOR, 0, 0, 0, 0.6f, 0);
+
+		auto player = world::newEntity("Player", world::root());
+		auto playerTransform = player->addComponent<Hydra::Component::TransformComponent>();
+		playerTransform->position = toWorld(playerTile);
+		auto playerLife = player->addComponent<Hydra::Component::LifeComponent>();
+		playerLife->maxHP = FLT_MAX;
+		playerLife->health = FLT_MAX;
+		auto playerBody = player->addComponent<Hydra::Component::RigidBodyComponent>();
+		playerBody->createBox(glm::vec3(1.0f, 2.0f, 1.0f), glm::vec3(0, 2, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_PLAYER, 0, 0, 0, 0, 0);
+
+		// Made like the aliens of TileGeneration, within chasing distance of the player
+		std::uniform_int_distribution<int> offset(-40, 40);
+		std::vector<std::shared_ptr<Hydra::Component::AIComponent>> aliens;
+		for (size_t tries = 0; aliens.size() < count && tries < count * 1000; tries++) {
+			const glm::ivec2 tile = playerTile + glm::ivec2(offset(rng), offset(rng));
+			if (!map->isOpen(tile) || glm::distance(toWorld(tile), toWorld(playerTile)) >= 50.0f)
+				continue;
+			auto alien = world::newEntity("Alien", world::root());
+			alien->addComponent<Hydra::Component::MeshComponent>();
+			auto a = alien->addComponent<Hydra::Component::AIComponent>();
+			a->damage = 4;
+			a->radius = 1;
+			auto h = alien->addComponent<Hydra::Component::LifeComponent>();
+			h->maxHP = 60;
+			h->health = 60;
+			auto w = alien->addComponent<Hydra::Component::WeaponComponent>();
+			w->bulletSpread = 0.2f;
+			w->bulletsPerShot = 1;
+			w->damage = 4;
+			w->bulletSize = 0.3;
+			alien->addComponent<Hydra::Component::MovementComponent>()->movementSpeed = 10.0f;
+			alien->addComponent<Hydra::Component::TransformComponent>()->position = toWorld(tile);
+			auto rgbc = alien->addComponent<Hydra::Component::RigidBodyComponent>();
+			rgbc->createBox(glm::vec3(0.5f, 1.0f, 0.5f), glm::vec3(0, 1, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_ENEMY, 100.0f, 0, 0, 0.6f, 1.0f);
+			rgbc->createCapsuleY(0.5f, 1.0f, glm::vec3(0, 2.6, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_HEAD, 10000, 0, 0, 0.0f, 0);
+			rgbc->setActivationState(Hydra::Component::RigidBodyComponent::ActivationState::disableDeactivation);
+			rgbc->setAngularForce(glm::vec3(0));
+			// The components are there before the behaviour looks for them
+			a->behaviour = std::make_shared<AlienBehaviour>(alien);
+			a->behaviour->setPathMap(map);
+			a->behaviour->originalRange = 4.0f;
+			a->behaviour->savedRange = a->behaviour->originalRange;
+			a->behaviour->setTargetPlayer(player);
+			aliens.push_back(a);
+		}
+
+		for (auto& rb : Hydra::Component::RigidBodyComponent::componentHandler->getActiveComponents())
+			physicsSystem.enable(static_cast<Hydra::Component::RigidBodyComponent*>(rb.get()));
+
+		physicsSystem.resetRayCounters();
+		std::uniform_int_distribution<int> step(-1, 1);
+		double aiTime = 0;
+		double worstTick = 0;
+		size_t attacking = 0;
+		for (size_t tick = 0; tick < ticks; tick++) {
+			const glm::ivec2 next = playerTile + glm::ivec2(step(rng), step(rng));
+			if (map->isOpen(next))
+				playerTile = next;
+			playerTransform->position = toWorld(playerTile);
+			playerBody->refreshTransform();
+
+			const auto start = clock::now();
+			if (parallel)
+				aiSystem.tick(delta);
+			else {
+				PathQueue::instance().update();
+				for (auto& a : aliens)
+					a->behaviour->run(delta);
+			}
+			const double time = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+			aiTime += time;
+			worstTick = std::max(worstTick, time);
+
+			physicsSystem.tick(delta);
+			projectileSystem.tick(delta);
+			world::applyCommands();
+			for (auto& a : aliens)
+				attacking += a->behaviour->state == Behaviour::ATTACKING;
+		}
+
+		if (!parallel)
+			serialTime = aiTime;
+		printf("%10s %12.3f %12.3f %10zu %10zu %7.2fx\n", parallel ? "AISystem" : "Serial", aiTime / ticks, worstTick, attacking / ticks, physicsSystem.getRayCount() / ticks, serialTime / aiTime);
+
+		// The bodies leave the world before the next one is made
+		aliens.clear();
+		projectileSystem.clear();
+		setProjectileSystem(nullptr);
+		PathQueue::instance().clear();
+		world::reset();
+	}
+	return 0;
+}
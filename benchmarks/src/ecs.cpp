@@ -0,0 +1,131 @@
+#include <benchmarks/benchmarks.hpp>
+#include <hydra/world/world.hpp>
+#include <hydra/world/commandbuffer.hpp>
+#include <hydra/system/deadsystem.hpp>
+#include <hydra/component/transformcomponent.hpp>
+#include <hydra/component/bulletcomponent.hpp>
+#include <hydra/component/rigidbodycomponent.hpp>
+#include <hydra/component/aicomponent.hpp>
+
+#include <chrono>
+#include <cstdio>
+
+int BarcodeBench::benchmarkEntities(size_t count) {
+	using world = Hydra::World::World;
+	using clock = std::chrono::high_resolution_clock;
+	const size_t waveSize = 1000;
+
+	world::reset();
+	Hydra::System::DeadSystem deadSystem;
+	std::vector<std::shared_ptr<Hydra::World::Entity>> bullets;
+
+	std::vector<Hydra::World::AllocationStats> before, after;
+	world::getAllocationStats(before);
+	double spawnTime = 0;
+	double removeTime = 0;
+	for (size_t spawned = 0; spawned < count; spawned += waveSize) {
+		auto start = clock::now();
+		for (size_t i = 0; i < waveSize && spawned + i < count; i++) {
+			world::commands().spawn("Bullet", world::rootID, [](const std::shared_ptr<Hydra::World::Entity>& e) {
+				e->addComponent<Hydra::Component::BulletComponent>()->direction = glm::vec3(0, 0, 1);
+				e->addComponent<Hydra::Component::TransformComponent>()->position = glm::vec3(0, 1, 0);
+			});
+		}
+		world::applyCommands();
+		spawnTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+		start = clock::now();
+		world::getEntitiesWithComponents<Hydra::Component::BulletComponent>(bullets);
+		for (auto& bullet : bullets)
+			world::commands().destroy(bullet->id);
+		bullets.clear();
+		world::applyCommands();
+		deadSystem.tick(0);
+		removeTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	}
+	world::getAllocationStats(after);
+
+	printf("%zu entities in waves of %zu\n", count, waveSize);
+	printf("Spawn:  %8.2f ms (%.2f us per entity)\n", spawnTime, spawnTime * 1000 / count);
+	printf("Remove: %8.2f ms (%.2f us per entity)\n", removeTime, removeTime * 1000 / count);
+	printf("%-24s %12s %8s %8s %10s\n", "Type", "Allocations", "Peak", "Chunks", "Fallbacks");
+	for (size_t i = 0; i < after.size(); i++) {
+		const auto& a = after[i];
+		const auto& b = before[i];
+		if (a.stats.allocations == b.stats.allocations && a.stats.fallbacks == b.stats.fallbacks)
+			continue;
+		printf("%-24s %12zu %8zu %8zu %10zu\n", a.name.c_str(), a.stats.allocations - b.stats.allocations, a.stats.peak, a.chunks - b.chunks, a.stats.fallbacks - b.stats.fallbacks);
+	}
+	return 0;
+}
+
+int BarcodeBench::benchmarkECS(size_t count) {
+	using world = Hydra::World::World;
+	using clock = std::chrono::high_resolution_clock;
+	using namespace Hydra::Component;
+	const size_t ticks = 100;
+	const float delta = 1.0f / 30;
+
+	world::reset();
+	// Created before the entities, so it is filled as they are added like the queries of the systems
+	Hydra::World::Query<TransformComponent, RigidBodyComponent, AIComponent> query;
+	auto start = clock::now();
+	for (size_t i = 0; i < count + count / 2; i++) {
+		auto entity = world::newEntity("Entity", world::root());
+		entity->addComponent<TransformComponent>();
+		if (i % 3 == 2)
+			continue;
+		entity->addComponent<RigidBodyComponent>();
+		entity->addComponent<AIComponent>()->radius = 0.5f;
+	}
+	const double createTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	auto step = [delta](Hydra::World::Entity& entity) {
+		auto transform = entity.getComponent<TransformComponent>();
+		auto ai = entity.getComponent<AIComponent>();
+		if (entity.getComponent<RigidBodyComponent>())
+			transform->position.x += ai->radius * delta;
+	};
+	auto time = [&](auto&& tick) {
+		const auto start = clock::now();
+		for (size_t i = 0; i < ticks; i++)
+			tick();
+		return std::chrono::duration<double, std::milli>(clock::now() - start).count() / ticks;
+	};
+
+	const double handlerTime = time([&]() {
+		for (auto& component : TransformComponent::componentHandler->getActiveComponents()) {
+			auto entity = world::getEntity(component->entityID);
+			if (entity->hasComponents(RigidBodyComponent::bits | AIComponent::bits))
+				step(*entity);
+		}
+	});
+	std::vector<std::shared_ptr<Hydra::World::Entity>> entities;
+	const double copyTime = time([&]() {
+		world::getEntitiesWithComponents<TransformComponent, RigidBodyComponent, AIComponent>(entities);
+		for (auto& entity : entities)
+			step(*entity);
+	});
+	const double queryTime = time([&]() {
+		for (auto& entity : query.getEntities())
+			step(*entity);
+	});
+	const double forEachTime = time([&]() {
+		world::forEachEntityWithComponents<TransformComponent, RigidBodyComponent, AIComponent>(step);
+	});
+
+	size_t moved = 0;
+	for (auto& entity : query.getEntities())
+		moved += entity->getComponent<TransformComponent>()->position.x > 0;
+
+	printf("%zu entities with Transform, RigidBody and AI, %zu with only Transform, created in %.2f ms\n", count, count / 2, createTime);
+	printf("Per tick, %zu ticks:\n", ticks);
+	printf("  Transform handler + getEntity:   %8.3f ms\n", handlerTime);
+	printf("  getEntitiesWithComponents:       %8.3f ms\n", copyTime);
+	printf("  Query:                           %8.3f ms\n", queryTime);
+	printf("  forEachEntityWithComponents:     %8.3f ms\n", forEachTime);
+	printf("%zu of %zu entities moved\n", moved, query.getEntities().size());
+
+	world::reset();
+	return moved == query.getEntities().size() ? 0 : 1;
+}
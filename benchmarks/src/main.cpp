@@ -0,0 +1,167 @@
+#include <benchmarks/benchmarks.hpp>
+#include <hydra/engine.hpp>
+#include <hydra/world/world.hpp>
+#include <hydra/component/componentmanager.hpp>
+#include <hydra/component/componentmanager_network.hpp>
+#include <hydra/component/componentmanager_graphics.hpp>
+#include <hydra/component/componentmanager_physics.hpp>
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#ifdef __linux__
+#include <signal.h>
+#endif
+
+using namespace Hydra;
+
+namespace {
+	// Headless engine, like the one in the server. The state only hands out the systems.
+	class Engine final : public IEngine {
+	public:
+		class State final : public IState {
+		public:
+			World::ISystem* physicsSystem = nullptr;
+			World::ISystem* projectileSystem = nullptr;
+
+			void load() final {}
+			void onMainMenu() final {}
+			void runFrame(float) final {}
+			IO::ITextureLoader* getTextureLoader() final { return nullptr; }
+			IO::IMeshLoader* getMeshLoader() final { return nullptr; }
+			IO::ITextFactory* getTextFactory() final { return nullptr; }
+			World::ISystem* getPhysicsSystem() final { return physicsSystem; }
+			World::ISystem* getProjectileSystem() final { return projectileSystem; }
+		} state;
+
+		Engine() { IEngine::getInstance() = this; }
+		~Engine() final { World::World::clear(); }
+
+		void run() final {}
+		void quit() final {}
+		void onMainMenu() final {}
+		void setState_(std::unique_ptr<IState>) final {}
+		IState* getState() final { return &state; }
+		View::IView* getView() final { return nullptr; }
+		Renderer::IRenderer* getRenderer() final { return nullptr; }
+		Renderer::IUIRenderer* getUIRenderer() final { return nullptr; }
+		Hydra::System::DeadSystem* getDeadSystem() final { return nullptr; }
+
+		void log(LogLevel level, const char* fmt, ...) final {
+			va_list va;
+			va_start(va, fmt);
+#ifdef __linux__
+			static const char* color[] = { "\x1b[39;1m", "\x1b[33;1m", "\x1b[31;1m", "\x1b[37;41;1m" };
+			fputs(color[static_cast<int>(level)], stderr);
+#endif
+			vfprintf(stderr, fmt, va);
+#ifdef __linux__
+			fputs("\x1b[0m", stderr);
+#endif
+			fputc('\n', stderr);
+			va_end(va);
+		}
+	};
+}
+
+// Destroyed after the engine, so it is still there when the world is cleared
+static Hydra::System::BulletPhysicsSystem physicsSystem;
+
+void BarcodeBench::setProjectileSystem(Hydra::System::ProjectileSystem* projectileSystem) {
+	static_cast<Engine*>(IEngine::getInstance())->state.projectileSystem = projectileSystem;
+}
+
+static int usage(const char* program) {
+	printf("Usage: %s [--entities [N]] [--projectiles [N]] [--pathing [N]] [--astar [N]] [--spatial [N]] [--physics [N]] [--ai [N]] [--ecs [N]] [--snapshots [N]] [--framing [N]] [--epoll [N]]\n", program);
+	return 1;
+}
+
+// The count of a flag, or its default if the next argument isn't a number
+static size_t countArgument(int argc, char** argv, int& i, size_t defaultCount) {
+	return (i + 1 < argc && argv[i + 1][0] != '-') ? strtoul(argv[++i], nullptr, 10) : defaultCount;
+}
+
+int main(int argc, char** argv) {
+	srand(time(NULL));
+#ifdef __linux__
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	size_t entities = 0;
+	size_t projectiles = 0;
+	size_t pathing = 0;
+	size_t astar = 0;
+	size_t spatial = 0;
+	size_t physics = 0;
+	size_t ai = 0;
+	size_t ecs = 0;
+	size_t snapshots = 0;
+	size_t framing = 0;
+	size_t epoll = 0;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--entities"))
+			entities = countArgument(argc, argv, i, 100000);
+		else if (!strcmp(argv[i], "--projectiles"))
+			projectiles = countArgument(argc, argv, i, 10000);
+		else if (!strcmp(argv[i], "--pathing"))
+			pathing = countArgument(argc, argv, i, 200);
+		else if (!strcmp(argv[i], "--astar"))
+			astar = countArgument(argc, argv, i, 5000);
+		else if (!strcmp(argv[i], "--spatial"))
+			spatial = countArgument(argc, argv, i, 5000);
+		else if (!strcmp(argv[i], "--physics"))
+			physics = countArgument(argc, argv, i, 300);
+		else if (!strcmp(argv[i], "--ai"))
+			ai = countArgument(argc, argv, i, 500);
+		else if (!strcmp(argv[i], "--ecs"))
+			ecs = countArgument(argc, argv, i, 50000);
+		else if (!strcmp(argv[i], "--snapshots"))
+			snapshots = countArgument(argc, argv, i, 3600);
+		else if (!strcmp(argv[i], "--framing"))
+			framing = countArgument(argc, argv, i, 200000);
+		else if (!strcmp(argv[i], "--epoll"))
+			epoll = countArgument(argc, argv, i, 500);
+		else
+			return usage(argv[0]);
+	}
+	if (argc < 2)
+		return usage(argv[0]);
+
+	using namespace Hydra::Component::ComponentManager;
+	auto& map = createOrGetComponentMap();
+	Engine engine;
+	registerComponents_graphics(map);
+	registerComponents_network(map);
+	registerComponents_physics(map);
+	engine.state.physicsSystem = &physicsSystem;
+
+	// Every benchmark that was asked for runs, in this order, and the result is a failure if any of them failed
+	int result = 0;
+	if (entities)
+		result |= BarcodeBench::benchmarkEntities(entities);
+	if (projectiles)
+		result |= BarcodeBench::benchmarkProjectiles(projectiles);
+	if (pathing)
+		result |= BarcodeBench::benchmarkPathing(pathing);
+	if (astar)
+		result |= BarcodeBench::benchmarkAStar(astar);
+	if (spatial)
+		result |= BarcodeBench::benchmarkSpatial(spatial);
+	if (physics)
+		result |= BarcodeBench::benchmarkPhysics(physics);
+	if (ai)
+		result |= BarcodeBench::benchmarkAI(ai, physicsSystem);
+	if (ecs)
+		result |= BarcodeBench::benchmarkECS(ecs);
+	if (snapshots)
+		result |= BarcodeBench::benchmarkSnapshots(snapshots);
+	if (framing)
+		result |= BarcodeBench::benchmarkFraming(framing);
+#ifdef __linux__
+	if (epoll)
+		result |= BarcodeBench::benchmarkEpoll(epoll);
+#endif
+	return result;
+}
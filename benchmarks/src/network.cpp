@@ -0,0 +1,555 @@
+#include <benchmarks/benchmarks.hpp>
+#include <hydra/network/packetbuffer.hpp>
+#include <hydra/network/snapshot.hpp>
+#include <server/epollclienthandler.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#endif
+
+int BarcodeBench::benchmarkSnapshots(size_t count) {
+	using namespace Hydra::Network;
+	using clock = std::chrono::high_resolution_clock;
+	const size_t tickRate = 30;
+	const float delta = 1.0f / tickRate;
+	const size_t playerCount = 20;
+	const size_t spawnerCount = 8;
+	const size_t propCount = 40;
+	const size_t maxAliens = 150;
+	const float arenaSize = 100;
+
+	// The update packet before the snapshots, one EntUpdate for every network entity to every player every tick
+	struct LegacyEntUpdate {
+		ServerID entityid;
+		TransformInfo ti;
+		int life;
+		int animationIndex;
+	};
+
+	struct RecordedEntity {
+		ServerID id;
+		TransformInfo ti;
+		int32_t life;
+		int32_t animationIndex;
+	};
+	struct Actor {
+		ServerID id;
+		glm::vec3 position;
+		glm::vec3 velocity;
+		float yaw;
+		int32_t life;
+		int32_t animationIndex;
+	};
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> unit(0, 1);
+	auto randomPosition = [&]() { return glm::vec3(unit(rng) * arenaSize, 0, unit(rng) * arenaSize); };
+
+	ServerID nextID = 2; // 1 is the world root
+	std::vector<Actor> players;
+	std::vector<Actor> aliens;
+	std::vector<Actor> statics;
+	for (size_t i = 0; i < playerCount; i++)
+		players.push_back(Actor{nextID++, randomPosition(), glm::vec3(0), 0, 100, 0});
+	for (size_t i = 0; i < spawnerCount + propCount; i++)
+		statics.push_back(Actor{nextID++, randomPosition(), glm::vec3(0), unit(rng) * glm::two_pi<float>(), i < spawnerCount ? 500 : INT32_MAX, 0});
+
+	auto record = [](std::vector<RecordedEntity>& frame, const Actor& actor) {
+		TransformInfo ti;
+		ti.pos = actor.position;
+		ti.scale = glm::vec3(1);
+		ti.rot = glm::angleAxis(actor.yaw, glm::vec3(0, 1, 0));
+		frame.push_back(RecordedEntity{actor.id, ti, actor.life, actor.animationIndex});
+	};
+
+	auto start = clock::now();
+	std::vector<std::vector<RecordedEntity>> session(count);
+	for (size_t tick = 0; tick < count; tick++) {
+		for (auto& player : players) {
+			if (unit(rng) < 1.0f / tickRate) {
+				const float angle = unit(rng) * glm::two_pi<float>();
+				player.velocity = unit(rng) < 0.2f ? glm::vec3(0) : glm::vec3(std::cos(angle), 0, std::sin(angle)) * 6.0f;
+			}
+			player.position = glm::clamp(player.position + player.velocity * delta, glm::vec3(0), glm::vec3(arenaSize));
+			player.yaw += (unit(rng) - 0.5f) * 0.2f;
+			player.animationIndex = player.velocity != glm::vec3(0);
+		}
+
+		if (tick % tickRate == 0)
+			for (size_t i = 0; i < spawnerCount && aliens.size() < maxAliens; i++)
+				aliens.push_back(Actor{nextID++, statics[i].position, glm::vec3(0), 0, 100, 0});
+
+		for (auto& alien : aliens) {
+			const Actor* target = &players[0];
+			for (auto& player : players)
+				if (glm::distance(player.position, alien.position) < glm::distance(target->position, alien.position))
+					target = &player;
+			const glm::vec3 toTarget = target->position - alien.position;
+			const float distance = glm::length(toTarget);
+			if (distance > 2) {
+				alien.position += toTarget / distance * 3.0f * delta;
+				alien.yaw = std::atan2(toTarget.x, toTarget.z);
+				alien.animationIndex = 1;
+			} else
+				alien.animationIndex = 2;
+			// The players shoot back
+			if (unit(rng) < 0.02f)
+				alien.life -= 25;
+		}
+		aliens.erase(std::remove_if(aliens.begin(), aliens.end(), [](const Actor& alien) { return alien.life <= 0; }), aliens.end());
+		for (auto& player : players)
+			if (unit(rng) < 0.01f)
+				player.life = player.life > 10 ? player.life - 10 : 100;
+
+		auto& frame = session[tick];
+		for (auto& actor : players)
+			record(frame, actor);
+		for (auto& actor : statics)
+			record(frame, actor);
+		for (auto& actor : aliens)
+			record(frame, actor);
+	}
+	const double recordTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	struct InFlight {
+		size_t arrival;
+		std::vector<uint8_t> data;
+	};
+	struct Client {
+		size_t latency; // Ticks each way
+		float loss;
+		uint32_t lastSnapshot = 0; // What the server has heard from the client
+		uint32_t newestSnapshot = 0;
+		SnapshotHistory snapshots;
+		std::vector<InFlight> toClient;
+		std::vector<std::pair<size_t, uint32_t>> acks; // Arrival tick and sequence
+	};
+	std::vector<Client> clients(playerCount);
+	for (size_t i = 0; i < playerCount; i++) {
+		clients[i].latency = 1 + i % 5;
+		clients[i].loss = i % 4 == 0 ? 0.05f : 0.01f;
+	}
+	// The last client stops reading for three seconds in the middle of the session
+	const size_t stallBegin = count / 2;
+	const size_t stallEnd = stallBegin + tickRate * 3;
+
+	SnapshotHistory history;
+	SnapshotPackets packets;
+	size_t legacyBytes = 0;
+	size_t deltaBytes = 0;
+	size_t fullSnapshots = 0;
+	size_t sent = 0;
+	size_t lost = 0;
+	size_t decoded = 0;
+	size_t errors = 0;
+	size_t largestPacket = 0;
+	float maxPositionError = 0;
+	float minRotationDot = 1;
+	double encodeTime = 0;
+
+	for (size_t tick = 0; tick < count; tick++) {
+		const uint32_t sequence = (uint32_t)tick + 1;
+		const auto& frame = session[tick];
+
+		for (auto& client : clients) {
+			for (auto& ack : client.acks)
+				if (ack.first <= tick)
+					client.lastSnapshot = std::max(client.lastSnapshot, ack.second);
+			client.acks.erase(std::remove_if(client.acks.begin(), client.acks.end(), [tick](const auto& ack) { return ack.first <= tick; }), client.acks.end());
+		}
+
+		// What _sendWorld does, except that the entities are already sorted
+		const auto encodeStart = clock::now();
+		Snapshot& snapshot = history.push(sequence);
+		for (auto& entity : frame)
+			snapshot.entities.emplace_back(entity.id, entity.ti, entity.life, entity.animationIndex);
+		packets.clear();
+		encodeTime += std::chrono::duration<double, std::milli>(clock::now() - encodeStart).count();
+
+		for (size_t i = 0; i < playerCount; i++) {
+			Client& client = clients[i];
+			const auto getStart = clock::now();
+			const auto& data = packets.get(history, sequence, client.lastSnapshot);
+			encodeTime += std::chrono::duration<double, std::milli>(clock::now() - getStart).count();
+			legacyBytes += sizeof(Packet) + frame.size() * sizeof(LegacyEntUpdate);
+			deltaBytes += data.size();
+			largestPacket = std::max(largestPacket, data.size());
+			fullSnapshots += ((const ServerUpdatePacket*)data.data())->baseline == 0;
+			sent++;
+			if (unit(rng) < client.loss) {
+				lost++;
+				continue;
+			}
+			client.toClient.push_back(InFlight{tick + client.latency, data});
+		}
+
+		for (size_t i = 0; i < playerCount; i++) {
+			Client& client = clients[i];
+			if (i == playerCount - 1 && tick >= stallBegin && tick < stallEnd)
+				continue;
+			for (auto& packet : client.toClient) {
+				if (packet.arrival > tick)
+					continue;
+				const ServerUpdatePacket* sup = (const ServerUpdatePacket*)packet.data.data();
+				if (sup->sequence <= client.newestSnapshot)
+					continue;
+				const Snapshot* baseline = client.snapshots.find(sup->baseline);
+				if (!baseline) {
+					errors++;
+					continue;
+				}
+				// The recording is sorted on id like the snapshots, so the entities can be compared in order
+				const auto& recorded = session[sup->sequence - 1];
+				Snapshot& received = client.snapshots.push(sup->sequence);
+				if (!readSnapshotDelta(sup->data, sup->size(), *baseline, received) || received.entities.size() != recorded.size()) {
+					errors++;
+					received.sequence = 0;
+					continue;
+				}
+				for (size_t e = 0; e < received.entities.size(); e++) {
+					const EntitySnapshot& entity = received.entities[e];
+					const EntitySnapshot expected(recorded[e].id, recorded[e].ti, recorded[e].life, recorded[e].animationIndex);
+					if (entity.entityid != expected.entityid || entity != expected) {
+						errors++;
+						break;
+					}
+					const TransformInfo ti = entity.getTransform();
+					const glm::vec3 error = glm::abs(ti.pos - recorded[e].ti.pos);
+					maxPositionError = std::max(maxPositionError, std::max(error.x, std::max(error.y, error.z)));
+					minRotationDot = std::min(minRotationDot, std::fabs(glm::dot(ti.rot, recorded[e].ti.rot)));
+				}
+				decoded++;
+				client.newestSnapshot = sup->sequence;
+				client.acks.emplace_back(tick + client.latency, sup->sequence);
+			}
+			if (!(i == playerCount - 1 && tick >= stallBegin && tick < stallEnd))
+				client.toClient.erase(std::remove_if(client.toClient.begin(), client.toClient.end(), [tick](const InFlight& packet) { return packet.arrival <= tick; }), client.toClient.end());
+		}
+	}
+
+	const double seconds = (double)count / tickRate;
+	printf("%zu players, %zu ticks at %zu Hz, %zu entities in the last tick, recorded in %.1f ms\n", playerCount, count, tickRate, session.back().size(), recordTime);
+	printf("EntUpdate for every entity: %12zu bytes, %8.1f kbit/s per player\n", legacyBytes, legacyBytes * 8 / 1000.0 / seconds / playerCount);
+	printf("Snapshot deltas:            %12zu bytes, %8.1f kbit/s per player, %.1fx smaller\n", deltaBytes, deltaBytes * 8 / 1000.0 / seconds / playerCount, (double)legacyBytes / deltaBytes);
+	printf("%zu of %zu packets were full snapshots, the largest packet was %zu bytes\n", fullSnapshots, sent, largestPacket);
+	printf("%zu packets lost, %zu snapshots decoded, %zu errors\n", lost, decoded, errors);
+	printf("Largest position error %.5f, smallest rotation dot %.5f\n", maxPositionError, minRotationDot);
+	printf("Encoding: %.3f ms per tick\n", encodeTime / count);
+
+	const bool ok = !errors && decoded && maxPositionError <= 0.5f / SNAPSHOT_POSITION_PRECISION + 0.0001f && minRotationDot > 0.999f;
+	return ok ? 0 : 1;
+}
+
+int BarcodeBench::benchmarkFraming(size_t count) {
+	using clock = std::chrono::high_resolution_clock;
+	const size_t maxPacketLength = 4096;
+	std::mt19937 rng(1337);
+
+	// The payload is a pattern of the packet index, so a packet can be checked without keeping a copy
+	std::uniform_int_distribution<size_t> smallPacket(sizeof(Hydra::Network::Packet), 300);
+	std::uniform_int_distribution<size_t> anyPacket(sizeof(Hydra::Network::Packet), maxPacketLength);
+	std::vector<uint8_t> stream;
+	std::vector<size_t> lengths;
+	for (size_t i = 0; i < count; i++) {
+		const size_t len = i % 16 ? smallPacket(rng) : anyPacket(rng);
+		const size_t start = stream.size();
+		stream.resize(start + len);
+		const Hydra::Network::Packet header(Hydra::Network::PacketType::ClientPing, len);
+		memcpy(stream.data() + start, &header, sizeof(header));
+		for (size_t j = sizeof(Hydra::Network::Packet); j < len; j++)
+			stream[start + j] = (uint8_t)(i * 31 + j);
+		lengths.push_back(len);
+	}
+	auto intact = [](const Hydra::Network::Packet* p, size_t index, size_t len) {
+		if (p->len != len || p->type != Hydra::Network::PacketType::ClientPing)
+			return false;
+		const uint8_t* bytes = (const uint8_t*)p;
+		for (size_t j = sizeof(Hydra::Network::Packet); j < len; j++)
+			if (bytes[j] != (uint8_t)(index * 31 + j))
+				return false;
+		return true;
+	};
+
+	Hydra::Network::PacketRingBuffer buffer(maxPacketLength);
+	std::vector<std::pair<const Hydra::Network::Packet*, size_t>> held;
+	std::uniform_int_distribution<int> pieceKind(0, 3);
+	std::uniform_int_distribution<size_t> tinyPiece(1, 16);
+	std::uniform_int_distribution<size_t> bigPiece(1, maxPacketLength * 3);
+	std::uniform_int_distribution<int> releaseChance(0, 7);
+	size_t fed = 0;
+	size_t parsed = 0;
+	size_t broken = 0;
+	size_t misaligned = 0;
+	size_t releases = 0;
+	auto releaseHeld = [&]() {
+		for (auto& h : held)
+			broken += !intact(h.first, h.second, lengths[h.second]);
+		held.clear();
+		buffer.release();
+		releases++;
+	};
+	auto start = clock::now();
+	while (parsed < count && !buffer.isBroken()) {
+		size_t room;
+		uint8_t* out = buffer.writePointer(room);
+		if (!room) {
+			// Full, every packet that is in it has been handed out
+			releaseHeld();
+			continue;
+		}
+		const size_t piece = std::min({ room, stream.size() - fed, pieceKind(rng) ? tinyPiece(rng) : bigPiece(rng) });
+		memcpy(out, stream.data() + fed, piece);
+		buffer.commitWrite(piece);
+		fed += piece;
+		while (Hydra::Network::Packet* p = buffer.next()) {
+			misaligned += (uintptr_t)p % alignof(Hydra::Network::Packet) != 0;
+			broken += !intact(p, parsed, lengths[parsed]);
+			held.emplace_back(p, parsed++);
+		}
+		if (!releaseChance(rng))
+			releaseHeld();
+	}
+	releaseHeld();
+	const double fuzzTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	// The length of the first packet is set to one byte more than the limit
+	Hydra::Network::PacketRingBuffer invalid(maxPacketLength);
+	Hydra::Network::Packet tooLong(Hydra::Network::PacketType::ClientPing, maxPacketLength + 1);
+	size_t room;
+	memcpy(invalid.writePointer(room), &tooLong, sizeof(tooLong));
+	invalid.commitWrite(sizeof(tooLong));
+	const bool rejected = !invalid.next() && invalid.isBroken();
+
+	// Reads as large as the buffer lets them be, like a busy socket
+	const size_t laps = std::max<size_t>(1, (256u << 20) / stream.size());
+	Hydra::Network::PacketRingBuffer fast(maxPacketLength);
+	size_t framed = 0;
+	start = clock::now();
+	for (size_t lap = 0; lap < laps; lap++) {
+		size_t offset = 0;
+		while (offset < stream.size()) {
+			uint8_t* out = fast.writePointer(room);
+			const size_t piece = std::min(room, stream.size() - offset);
+			memcpy(out, stream.data() + offset, piece);
+			fast.commitWrite(piece);
+			offset += piece;
+			while (fast.next())
+				framed++;
+			fast.release();
+		}
+	}
+	const double throughputTime = std::chrono::duration<double>(clock::now() - start).count();
+
+	printf("Fuzz:       %zu packets, %.2f MB, %zu releases in %.2f ms\n", count, stream.size() / (1024.0 * 1024.0), releases, fuzzTime);
+	printf("            %zu of %zu parsed, %zu broken, %zu misaligned, invalid length %s\n", parsed, count, broken, misaligned, rejected ? "rejected" : "NOT rejected");
+	printf("Throughput: %.1f MB/s, %.2f M packets/s (%zu packets)\n", stream.size() * laps / (1024.0 * 1024.0) / throughputTime, framed / throughputTime / 1e6, framed);
+	return parsed == count && !broken && !misaligned && rejected && framed == count * laps ? 0 : 1;
+}
+
+#ifdef __linux__
+int BarcodeBench::benchmarkEpoll(size_t count) {
+	using clock = std::chrono::high_resolution_clock;
+	const int port = 4546;
+	const size_t extra = 16;
+	const size_t rounds = 100;
+	const size_t serverPacketSize = 4096;
+	const size_t slowPacketSize = 48 * 1024;
+
+	// Both ends of every connection are in this process
+	rlimit limit;
+	if (!getrlimit(RLIMIT_NOFILE, &limit)) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+		if (limit.rlim_cur < (count + extra) * 2 + 64) {
+			printf("Can only open %zu files, %zu sockets need %zu\n", (size_t)limit.rlim_cur, count, (count + extra) * 2 + 64);
+			return 1;
+		}
+	}
+
+	BarcodeServer::EpollClientHandler handler;
+	handler.setLoopbackOnly(true);
+	if (!handler.listen(port, count)) {
+		printf("Could not listen on port %d\n", port);
+		return 1;
+	}
+
+	std::vector<int> sockets;
+	for (size_t i = 0; i < count + extra; i++) {
+		int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		// The sockets that never read get a small buffer, so that the data piles up on the server instead
+		int receiveBuffer = 4096;
+		if (fd != -1 && i % 10 == 0)
+			setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(port);
+		if (fd == -1 || connect(fd, (sockaddr*)&addr, sizeof(addr)) == -1) {
+			perror("connect");
+			return 1;
+		}
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		sockets.push_back(fd);
+	}
+
+	auto start = clock::now();
+	size_t accepted = 0;
+	while (accepted < count && std::chrono::duration<double>(clock::now() - start).count() < 5)
+		while (handler.checkForNewClients() != -1)
+			accepted++;
+	const double acceptTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	// The sockets over the limit are closed by the server, they get an end of file instead of data
+	size_t refused = 0;
+	for (size_t i = count; i < sockets.size(); i++) {
+		char byte;
+		pollfd pfd{sockets[i], POLLIN, 0};
+		if (poll(&pfd, 1, 1000) == 1 && recv(sockets[i], &byte, 1, 0) == 0)
+			refused++;
+		close(sockets[i]);
+	}
+	sockets.resize(count);
+
+	// The first 8 bytes after the header say which socket and round the packet is from, the rest is a pattern of them
+	std::mt19937 rng(1337);
+	std::uniform_int_distribution<size_t> payloadSize(8, 256);
+	std::vector<uint8_t> packet;
+	auto makePacket = [&](uint32_t socketIndex, uint32_t round) {
+		packet.assign(sizeof(Hydra::Network::Packet) + payloadSize(rng), 0);
+		new (packet.data()) Hydra::Network::Packet(Hydra::Network::PacketType::ClientPing, packet.size());
+		uint8_t* payload = packet.data() + sizeof(Hydra::Network::Packet);
+		memcpy(payload, &socketIndex, 4);
+		memcpy(payload + 4, &round, 4);
+		for (size_t i = 8; i < packet.size() - sizeof(Hydra::Network::Packet); i++)
+			payload[i] = (uint8_t)(socketIndex + round + i);
+	};
+	auto sendPieces = [&](int fd) {
+		const size_t first = std::uniform_int_distribution<size_t>(0, packet.size())(rng);
+		const size_t second = std::uniform_int_distribution<size_t>(first, packet.size())(rng);
+		const size_t cuts[] = { 0, first, second, packet.size() };
+		for (size_t i = 0; i < 3; i++)
+			if (cuts[i + 1] > cuts[i] && send(fd, packet.data() + cuts[i], cuts[i + 1] - cuts[i], MSG_NOSIGNAL) != (ssize_t)(cuts[i + 1] - cuts[i]))
+				return false;
+		return true;
+	};
+	// The id the server gave to each socket
+	std::unordered_map<int, uint32_t> owners;
+	// Returns how many packets were intact, sets done to how many it got
+	auto check = [&](const std::vector<Hydra::Network::Packet*>& packets, size_t& done, uint32_t round) {
+		size_t intact = 0;
+		for (Hydra::Network::Packet* p : packets) {
+			done++;
+			const uint8_t* payload = (const uint8_t*)p + sizeof(Hydra::Network::Packet);
+			uint32_t socketIndex, packetRound;
+			if (p->type != Hydra::Network::PacketType::ClientPing || p->len < sizeof(Hydra::Network::Packet) + 8)
+				continue;
+			memcpy(&socketIndex, payload, 4);
+			memcpy(&packetRound, payload + 4, 4);
+			if (socketIndex < sockets.size())
+				owners[p->client] = socketIndex;
+			bool ok = packetRound == round;
+			for (size_t i = 8; ok && i < p->len - sizeof(Hydra::Network::Packet); i++)
+				ok = payload[i] == (uint8_t)(socketIndex + packetRound + i);
+			intact += ok;
+		}
+		return intact;
+	};
+
+	std::vector<char> serverPacket(serverPacketSize, 0);
+	new (serverPacket.data()) Hydra::Network::Packet(Hydra::Network::PacketType::ServerPong, serverPacket.size());
+	// More than the kernel buffers hold, for the sockets that never read
+	std::vector<char> slowPacket(slowPacketSize, 0);
+	new (slowPacket.data()) Hydra::Network::Packet(Hydra::Network::PacketType::ServerPong, slowPacket.size());
+	std::vector<char> drain(64 * 1024);
+	const std::vector<int> clients = handler.getAllClients();
+	size_t sent = 0;
+	size_t received = 0;
+	size_t intact = 0;
+	size_t bytes = 0;
+	size_t bytesRead = 0;
+	double worstPoll = 0;
+	double worstSend = 0;
+	start = clock::now();
+	for (uint32_t round = 0; round < rounds; round++) {
+		for (uint32_t i = 0; i < sockets.size(); i++) {
+			makePacket(i, round);
+			if (sendPieces(sockets[i])) {
+				sent++;
+				bytes += packet.size();
+			}
+		}
+
+		size_t done = 0;
+		const auto roundStart = clock::now();
+		while (done < count && std::chrono::duration<double>(clock::now() - roundStart).count() < 2) {
+			const auto pollStart = clock::now();
+			const auto packets = handler.receiveData();
+			worstPoll = std::max(worstPoll, std::chrono::duration<double, std::milli>(clock::now() - pollStart).count());
+			intact += check(packets, done, round);
+		}
+		received += done;
+
+		const auto sendStart = clock::now();
+		for (int id : clients)
+			handler.sendData(serverPacket.data(), (int)serverPacket.size(), id);
+		for (int id : clients)
+			if (owners.count(id) && owners[id] % 10 == 0)
+				handler.sendData(slowPacket.data(), (int)slowPacket.size(), id);
+		worstSend = std::max(worstSend, std::chrono::duration<double, std::milli>(clock::now() - sendStart).count());
+		for (size_t i = 0; i < sockets.size(); i++) {
+			if (i % 10 == 0)
+				continue;
+			ssize_t r;
+			while ((r = recv(sockets[i], drain.data(), drain.size(), MSG_DONTWAIT)) > 0)
+				bytesRead += r;
+		}
+	}
+	const double roundTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	size_t congested = 0;
+	for (int id : clients)
+		congested += handler.isCongested(id);
+	const size_t connected = handler.getNrOfClients();
+
+	// The last packet is sent right before the close, the server must still hand it out
+	size_t closed = 0;
+	for (uint32_t i = 0; i < sockets.size(); i += 2) {
+		makePacket(i, rounds);
+		closed += sendPieces(sockets[i]);
+		close(sockets[i]);
+		sockets[i] = -1;
+	}
+	size_t finalDone = 0;
+	size_t finalIntact = 0;
+	size_t disconnects = 0;
+	start = clock::now();
+	while ((finalDone < closed || disconnects < closed) && std::chrono::duration<double>(clock::now() - start).count() < 2) {
+		finalIntact += check(handler.receiveData(), finalDone, rounds);
+		disconnects += handler.getDisconnectedClients().size();
+	}
+
+	printf("%zu sockets over loopback, %zu over the limit\n", count, extra);
+	printf("Accepted:   %zu of %zu in %.2f ms, %zu of %zu refused\n", accepted, count, acceptTime, refused, extra);
+	printf("Rounds:     %zu, %.3f ms per round, worst receiveData %.3f ms, worst sendData to everyone %.3f ms\n", rounds, roundTime / rounds, worstPoll, worstSend);
+	printf("Received:   %zu of %zu packets, %zu intact, %.2f MB\n", received, sent, intact, bytes / (1024.0 * 1024.0));
+	printf("Sent:       %.2f MB read by the clients, %zu of %zu clients congested, %zu still connected\n", bytesRead / (1024.0 * 1024.0), congested, clients.size(), connected);
+	printf("Closed:     %zu sockets, %zu of %zu last packets intact, %zu disconnects\n", closed, finalIntact, closed, disconnects);
+
+	for (int fd : sockets)
+		if (fd != -1)
+			close(fd);
+	const size_t slow = (count + 9) / 10;
+	return accepted == count && refused == extra && intact == sent && congested == slow && finalIntact == closed && disconnects == closed ? 0 : 1;
+}
+#endif
@@ -0,0 +1,239 @@
+#include <benchmarks/benchmarks.hpp>
+#include <hydra/world/world.hpp>
+#include <hydra/pathing/pathfinding.hpp>
+#include <hydra/pathing/flowfield.hpp>
+#include <hydra/pathing/pathqueue.hpp>
+#include <server/tilegeneration.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+int BarcodeBench::benchmarkPathing(size_t count) {
+	using clock = std::chrono::high_resolution_clock;
+	const size_t frames = 60;
+
+	Hydra::World::World::reset();
+	BarcodeServer::TileGeneration tiles(31, "assets/room/starterRoom.room", nullptr, nullptr, 0);
+	tiles.buildMap();
+	PathFinding::setRoomGrid(tiles.roomGrid);
+	const PathMap* map = tiles.pathfindingMap;
+
+	std::mt19937 rng(1337);
+	auto open = [map](const glm::ivec2& tile) { return map->isOpen(tile); };
+	auto toWorld = [](const glm::ivec2& tile) { return glm::vec3((tile.x + 0.5f) / ROOM_SCALE, 0, (tile.y + 0.5f) / ROOM_SCALE); };
+
+	glm::ivec2 player(WORLD_MAP_SIZE / 2, WORLD_MAP_SIZE / 2);
+	for (int i = 0; i < WORLD_MAP_SIZE && !open(player); i++)
+		player.x++;
+	if (!open(player)) {
+		printf("No walkable tile in the middle room\n");
+		return 1;
+	}
+
+	// Same distance as the aliens start chasing from
+	std::vector<glm::vec3> aliens;
+	std::uniform_int_distribution<int> offset(-40, 40);
+	for (size_t tries = 0; aliens.size() < count && tries < count * 1000; tries++) {
+		const glm::ivec2 tile = player + glm::ivec2(offset(rng), offset(rng));
+		if (open(tile) && glm::distance(toWorld(tile), toWorld(player)) < 50.0f)
+			aliens.push_back(toWorld(tile));
+	}
+
+	std::vector<glm::ivec2> walk{player};
+	std::uniform_int_distribution<int> step(-1, 1);
+	while (walk.size() < frames) {
+		const glm::ivec2 tile = walk.back() + glm::ivec2(step(rng), step(rng));
+		if (open(tile))
+			walk.push_back(tile);
+	}
+
+	std::vector<PathFinding> searches(aliens.size());
+	for (auto& search : searches)
+		search.map = map;
+	auto runAStar = [&](double& time, size_t& found) {
+		found = 0;
+		const auto start = clock::now();
+		for (const glm::ivec2& tile : walk)
+			for (size_t i = 0; i < aliens.size(); i++)
+				found += searches[i].findPath(aliens[i], toWorld(tile));
+		time = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	};
+	double aStarTime, cachedTime;
+	size_t aStarFound, cachedFound;
+	runAStar(aStarTime, aStarFound);
+	auto start = clock::now();
+	PathFinding::buildRoomCache(map);
+	const double cacheBuildTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	runAStar(cachedTime, cachedFound);
+
+	FlowField field;
+	double updateTime = 0;
+	double sampleTime = 0;
+	size_t flowFound = 0;
+	size_t visited = 0;
+	glm::vec3 next;
+	for (const glm::ivec2& tile : walk) {
+		start = clock::now();
+		field.update(toWorld(tile), map);
+		const auto updated = clock::now();
+		for (const glm::vec3& alien : aliens)
+			flowFound += field.next(alien, next);
+		sampleTime += std::chrono::duration<double, std::milli>(clock::now() - updated).count();
+		updateTime += std::chrono::duration<double, std::milli>(updated - start).count();
+		visited += field.getTilesVisited();
+	}
+
+	PathQueue& queue = PathQueue::instance();
+	std::vector<PathQueue::Ticket> tickets(aliens.size(), PathQueue::INVALID_TICKET);
+	std::vector<glm::vec3> path;
+	double queueTime = 0;
+	double queueWorst = 0;
+	size_t queued = 0;
+	size_t queueDone = 0;
+	size_t queueFound = 0;
+	for (const glm::ivec2& tile : walk) {
+		start = clock::now();
+		for (size_t i = 0; i < aliens.size(); i++) {
+			bool found;
+			if (tickets[i] != PathQueue::INVALID_TICKET) {
+				if (!queue.poll(tickets[i], path, found))
+					continue;
+				queueDone++;
+				queueFound += found;
+			}
+			tickets[i] = queue.request(aliens[i], toWorld(tile), map);
+			queued++;
+		}
+		const double frame = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+		queueTime += frame;
+		queueWorst = std::max(queueWorst, frame);
+		std::this_thread::sleep_for(std::chrono::milliseconds(33));
+	}
+	for (PathQueue::Ticket ticket : tickets)
+		queue.cancel(ticket);
+
+	size_t visible = 0;
+	start = clock::now();
+	for (const glm::ivec2& tile : walk)
+		for (const glm::vec3& alien : aliens)
+			visible += map->lineOfSight(PathFinding::worldToMapCoords(alien).baseVec, tile);
+	const double sightTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	printf("%zu aliens, %zu frames, %zu field updates (%zu tiles per update)\n", aliens.size(), frames, field.getUpdateCount(), visited / frames);
+	printf("A*:         %8.2f ms per frame, %zu of %zu paths found\n", aStarTime / frames, aStarFound, aliens.size() * frames);
+	printf("Room cache: %8.2f ms per frame, %zu of %zu paths found (%.2f ms to build)\n", cachedTime / frames, cachedFound, aliens.size() * frames, cacheBuildTime);
+	printf("Flow field: %8.2f ms per frame (%.2f ms updating, %.4f ms sampling), %zu of %zu reachable\n", (updateTime + sampleTime) / frames, updateTime / frames, sampleTime / frames, flowFound, aliens.size() * frames);
+	printf("Path queue: %8.2f ms per frame (%.2f ms at most), %zu of %zu requests done in time, %zu paths found, %zu threads\n", queueTime / frames, queueWorst, queueDone, queued, queueFound, queue.getThreadCount());
+	printf("Line of sight: %.4f ms per frame, %zu of %zu see the player\n", sightTime / frames, visible, aliens.size() * frames);
+	return 0;
+}
+
+int BarcodeBench::benchmarkAStar(size_t count) {
+	using clock = std::chrono::high_resolution_clock;
+	const size_t levels = 4;
+
+	struct Result {
+		std::vector<double> times;
+		size_t found = 0;
+		size_t visited = 0;
+		size_t invalid = 0;
+		std::vector<float> lengths; // 0 if not found
+	};
+	Result aStar;
+	Result cached;
+
+	auto run = [&](Result& result, PathFinding& search, const PathMap* map, const glm::ivec2& from, const glm::ivec2& to) {
+		auto toWorld = [](const glm::ivec2& tile) { return glm::vec3((tile.x + 0.5f) / ROOM_SCALE, 0, (tile.y + 0.5f) / ROOM_SCALE); };
+		auto toTile = [](const glm::vec3& pos) { return glm::ivec2((int)std::lround(pos.x * ROOM_SCALE), (int)std::lround(pos.z * ROOM_SCALE)); };
+
+		const auto start = clock::now();
+		const bool found = search.findPath(toWorld(from), toWorld(to));
+		result.times.push_back(std::chrono::duration<double, std::milli>(clock::now() - start).count());
+		result.visited += search.visitedList.size();
+		if (!found) {
+			result.lengths.push_back(0);
+			return;
+		}
+		result.found++;
+
+		// pathToEnd goes from the goal to the start
+		const auto& path = search.pathToEnd;
+		bool valid = !path.empty() && toTile(path.front()) == to && toTile(path.back()) == from;
+		float length = 0;
+		for (size_t i = 0; valid && i < path.size(); i++) {
+			const glm::ivec2 tile = toTile(path[i]);
+			valid = map->isOpen(tile);
+			if (i > 0) {
+				const glm::ivec2 step = glm::abs(tile - toTile(path[i - 1]));
+				valid = valid && step.x <= 1 && step.y <= 1;
+				length += glm::length(glm::vec2(step));
+			}
+		}
+		result.invalid += !valid;
+		result.lengths.push_back(valid ? length : 0);
+	};
+
+	std::mt19937 rng(1337);
+	size_t pairs = 0;
+	for (size_t level = 0; level < levels; level++) {
+		srand(1337 + level);
+		Hydra::World::World::reset();
+		BarcodeServer::TileGeneration tiles(31, "assets/room/starterRoom.room", nullptr, nullptr, 0);
+		tiles.buildMap();
+		PathFinding::setRoomGrid(tiles.roomGrid);
+		const PathMap* map = tiles.pathfindingMap;
+
+		std::uniform_int_distribution<int> coord(0, WORLD_MAP_SIZE - 1);
+		auto randomTile = [&]() {
+			for (size_t tries = 0; tries < 100000; tries++) {
+				const glm::ivec2 tile(coord(rng), coord(rng));
+				if (map->isOpen(tile))
+					return tile;
+			}
+			return glm::ivec2(-1);
+		};
+		std::vector<std::pair<glm::ivec2, glm::ivec2>> levelPairs;
+		for (size_t i = level * count / levels; i < (level + 1) * count / levels; i++)
+			levelPairs.emplace_back(randomTile(), randomTile());
+		if (!levelPairs.empty() && levelPairs[0].first.x < 0) {
+			printf("No open tiles in level %zu\n", level);
+			return 1;
+		}
+		pairs += levelPairs.size();
+
+		PathFinding search;
+		search.map = map;
+		search.maxVisited = WORLD_MAP_SIZE * WORLD_MAP_SIZE;
+		PathFinding::clearRoomCache();
+		for (auto& pair : levelPairs)
+			run(aStar, search, map, pair.first, pair.second);
+		PathFinding::buildRoomCache(map);
+		for (auto& pair : levelPairs)
+			run(cached, search, map, pair.first, pair.second);
+	}
+	PathFinding::clearRoomCache();
+
+	// Only the pairs that both found a path are compared
+	double aStarLength = 0;
+	double cachedLength = 0;
+	for (size_t i = 0; i < pairs; i++) {
+		if (aStar.lengths[i] > 0 && cached.lengths[i] > 0) {
+			aStarLength += aStar.lengths[i];
+			cachedLength += cached.lengths[i];
+		}
+	}
+
+	printf("%zu random pairs on %zu levels\n", pairs, levels);
+	printf("%12s %10s %10s %10s %10s %14s %8s\n", "", "Mean (ms)", "p99 (ms)", "Max (ms)", "Found", "Tiles visited", "Invalid");
+	for (auto* result : { &aStar, &cached }) {
+		std::vector<double> times = result->times;
+		std::sort(times.begin(), times.end());
+		double total = 0;
+		for (double time : times)
+			total += time;
+		printf("%12s %10.4f %10.4f %10.4f %10zu %14zu %8zu\n", result == &aStar ? "A*" : "Room cache", total / pairs, times[times.size() * 99 / 100], times.back(), result->found, result->visited / pairs, result->invalid);
+	}
+	printf("The room cache paths are %.3fx as long as the A* paths\n", cachedLength / aStarLength);
+	return aStar.invalid || cached.invalid ? 1 : 0;
+}
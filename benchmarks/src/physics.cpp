@@ -0,0 +1,117 @@
+#include <benchmarks/benchmarks.hpp>
+#include <hydra/world/world.hpp>
+#include <hydra/component/transformcomponent.hpp>
+#include <hydra/component/rigidbodycomponent.hpp>
+#include <hydra/component/ghostobjectcomponent.hpp>
+#include <server/tilegeneration.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+int BarcodeBench::benchmarkPhysics(size_t count) {
+	using world = Hydra::World::World;
+	using clock = std::chrono::high_resolution_clock;
+	const size_t tickRate = 30;
+	const size_t ticks = tickRate * 5;
+	const float delta = 1.0f / tickRate;
+
+	std::vector<size_t> threadCounts = { 0 };
+	const size_t cpus = std::max(std::thread::hardware_concurrency(), 1u);
+	for (size_t threads = 1; threads < cpus; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(cpus);
+
+	printf("%zu aliens, %zu ticks at %zu Hz, %zu bullets per second\n", count, ticks, tickRate, count);
+	printf("%8s %12s %12s %12s %8s\n", "Threads", "Step (ms)", "Worst (ms)", "Bullets (ms)", "Speedup");
+	double singleThreaded = 0;
+	for (size_t threads : threadCounts) {
+		srand(1337);
+		std::mt19937 rng(1337);
+		world::reset();
+		Hydra::System::BulletPhysicsSystem physicsSystem;
+		Hydra::System::ProjectileSystem projectileSystem(physicsSystem);
+		physicsSystem.setThreadCount(threads);
+
+		BarcodeServer::TileGeneration tiles(31, "assets/room/starterRoom.room", nullptr, nullptr, 0);
+		tiles.buildMap();
+		const PathMap* map = tiles.pathfindingMap;
+		std::vector<glm::vec3> open;
+		for (int x = 0; x < WORLD_MAP_SIZE; x++)
+			for (int z = 0; z < WORLD_MAP_SIZE; z++)
+				if (map->isOpen(glm::ivec2(x, z)))
+					open.push_back(glm::vec3((x + 0.5f) / ROOM_SCALE, 0, (z + 0.5f) / ROOM_SCALE));
+		if (open.empty()) {
+			printf("No walkable tiles in the level\n");
+			return 1;
+		}
+
+		auto floor = world::newEntity("Floor", world::root());
+		floor->addComponent<Hydra::Component::TransformComponent>();
+		floor->addComponent<Hydra::Component::RigidBodyComponent>()->createStaticPlane(glm::vec3(0, 1, 0), 0, Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_FLOOR, 0, 0, 0, 0.6f, 0);
+
+		// Made like the aliens of TileGeneration
+		std::uniform_int_distribution<size_t> anyTile(0, open.size() - 1);
+		std::vector<std::shared_ptr<Hydra::Component::RigidBodyComponent>> aliens;
+		for (size_t i = 0; i < count; i++) {
+			auto alien = world::newEntity("Alien", world::root());
+			auto t = alien->addComponent<Hydra::Component::TransformComponent>();
+			t->position = open[anyTile(rng)];
+			auto rgbc = alien->addComponent<Hydra::Component::RigidBodyComponent>();
+			rgbc->createBox(glm::vec3(0.5f, 1.0f, 0.5f), glm::vec3(0, 1, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_ENEMY, 100.0f, 0, 0, 0.6f, 1.0f);
+			rgbc->createCapsuleY(0.5f, 1.0f, glm::vec3(0, 2.6, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_HEAD, 10000, 0, 0, 0.0f, 0);
+			rgbc->setActivationState(Hydra::Component::RigidBodyComponent::ActivationState::disableDeactivation);
+			rgbc->setAngularForce(glm::vec3(0));
+			aliens.push_back(rgbc);
+		}
+
+		for (auto& rb : Hydra::Component::RigidBodyComponent::componentHandler->getActiveComponents())
+			physicsSystem.enable(static_cast<Hydra::Component::RigidBodyComponent*>(rb.get()));
+		for (auto& goc : Hydra::Component::GhostObjectComponent::componentHandler->getActiveComponents()) {
+			static_cast<Hydra::Component::GhostObjectComponent*>(goc.get())->updateWorldTransform();
+			physicsSystem.enable(static_cast<Hydra::Component::GhostObjectComponent*>(goc.get()));
+		}
+
+		std::uniform_real_distribution<float> direction(-1, 1);
+		double stepTime = 0;
+		double worstStep = 0;
+		double bulletTime = 0;
+		for (size_t tick = 0; tick < ticks; tick++) {
+			for (size_t i = 0; i < aliens.size(); i++) {
+				// A new direction every second, at different ticks for every alien
+				if ((tick + i) % tickRate)
+					continue;
+				const glm::vec3 walk = glm::vec3(direction(rng), 0, direction(rng)) * 10.0f;
+				aliens[i]->setLinearVelocity(walk);
+				Hydra::System::Projectile bullet;
+				bullet.position = aliens[i]->getPosition() + glm::vec3(0, 2, 0);
+				bullet.direction = glm::normalize(glm::vec3(direction(rng), 0, direction(rng)) + glm::vec3(0.001f, 0, 0));
+				bullet.velocity = 40;
+				bullet.collisionType = Hydra::System::BulletPhysicsSystem::COLL_ENEMY_PROJECTILE;
+				projectileSystem.fire(bullet);
+			}
+
+			auto start = clock::now();
+			physicsSystem.tick(delta);
+			const double step = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+			stepTime += step;
+			worstStep = std::max(worstStep, step);
+
+			start = clock::now();
+			projectileSystem.tick(delta);
+			bulletTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+			world::applyCommands();
+		}
+
+		if (!threads)
+			singleThreaded = stepTime;
+		printf("%8zu %12.3f %12.3f %12.3f %7.2fx\n", threads, stepTime / ticks, worstStep, bulletTime / ticks, singleThreaded / stepTime);
+
+		// The bodies leave the world before it is gone
+		aliens.clear();
+		projectileSystem.clear();
+		world::reset();
+	}
+	return 0;
+}
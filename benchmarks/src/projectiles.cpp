@@ -0,0 +1,71 @@
+#include <benchmarks/benchmarks.hpp>
+#include <hydra/world/world.hpp>
+#include <hydra/component/transformcomponent.hpp>
+#include <hydra/component/weaponcomponent.hpp>
+#include <hydra/component/rigidbodycomponent.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+int BarcodeBench::benchmarkProjectiles(size_t count) {
+	using world = Hydra::World::World;
+	using clock = std::chrono::high_resolution_clock;
+	const size_t tickRate = 30;
+	const size_t ticks = tickRate * 10;
+	const float delta = 1.0f / tickRate;
+
+	world::reset();
+	Hydra::System::BulletPhysicsSystem physicsSystem;
+	Hydra::System::ProjectileSystem projectileSystem(physicsSystem);
+	// The weapon fires into the ProjectileSystem of the engine state
+	setProjectileSystem(&projectileSystem);
+	auto shooter = world::newEntity("Shooter", world::root());
+	shooter->addComponent<Hydra::Component::TransformComponent>();
+	auto weapon = shooter->addComponent<Hydra::Component::WeaponComponent>();
+	weapon->maxmagammo = 0;
+	weapon->bulletSpread = 0;
+
+	// About two seconds away for the bullets
+	auto wall = world::newEntity("Wall", world::root());
+	wall->addComponent<Hydra::Component::TransformComponent>()->position = glm::vec3(0, 0, 80);
+	auto rigidBody = wall->addComponent<Hydra::Component::RigidBodyComponent>();
+	rigidBody->createBox(glm::vec3(100, 100, 1), glm::vec3(0), Hydra::System::BulletPhysicsSystem::COLL_WALL);
+	physicsSystem.enable(rigidBody.get());
+
+	std::mt19937 rng(1337);
+	std::uniform_real_distribution<float> aim(-0.5f, 0.5f);
+	double fireTime = 0;
+	double tickTime = 0;
+	double worstTick = 0;
+	size_t peak = 0;
+	size_t fired = 0;
+	for (size_t tick = 0; tick < ticks; tick++) {
+		auto start = clock::now();
+		const size_t shots = count * (tick + 1) / tickRate - count * tick / tickRate;
+		for (size_t i = 0; i < shots; i++) {
+			weapon->fireRateTimer = 0;
+			weapon->shoot(glm::vec3(0, 1, 0), glm::normalize(glm::vec3(aim(rng), aim(rng), 1)), glm::quat(), 40, Hydra::System::BulletPhysicsSystem::COLL_ENEMY_PROJECTILE);
+		}
+		fired += shots;
+		fireTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+		start = clock::now();
+		physicsSystem.tick(delta);
+		projectileSystem.tick(delta);
+		world::applyCommands();
+		const double time = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+		tickTime += time;
+		worstTick = std::max(worstTick, time);
+		peak = std::max(peak, projectileSystem.size());
+	}
+
+	printf("%zu bullets per second for %zu ticks at %zu Hz, %zu fired\n", count, ticks, tickRate, fired);
+	printf("Fire:   %8.3f ms per tick\n", fireTime / ticks);
+	printf("Tick:   %8.3f ms per tick, %.3f ms at worst\n", tickTime / ticks, worstTick);
+	printf("Peak:   %8zu bullets in flight\n", peak);
+	printf("Hits:   %8zu\n", projectileSystem.getHitCount());
+	setProjectileSystem(nullptr);
+	return 0;
+}
@@ -0,0 +1,108 @@
+#include <benchmarks/benchmarks.hpp>
+#include <hydra/world/world.hpp>
+#include <hydra/world/spatialindex.hpp>
+#include <hydra/component/transformcomponent.hpp>
+#include <hydra/component/aicomponent.hpp>
+#include <server/gameserver.hpp>
+
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+int BarcodeBench::benchmarkSpatial(size_t count) {
+	using world = Hydra::World::World;
+	using clock = std::chrono::high_resolution_clock;
+	const size_t frames = 60;
+	const size_t playerCount = 32;
+	const float levelSize = WORLD_MAP_SIZE / ROOM_SCALE;
+	const float chaseDistance = 50.0f;
+
+	world::reset();
+	std::mt19937 rng(1337);
+	std::uniform_real_distribution<float> anywhere(0, levelSize);
+	std::uniform_real_distribution<float> step(-1, 1);
+	Hydra::World::Query<Hydra::Component::TransformComponent, Hydra::Component::AIComponent> alienQuery;
+	std::vector<Hydra::Component::TransformComponent*> transforms;
+	std::vector<Hydra::World::EntityID> players;
+	for (size_t i = 0; i < count + playerCount; i++) {
+		auto entity = world::newEntity(i < count ? "Alien" : "Player", world::root());
+		auto transform = entity->addComponent<Hydra::Component::TransformComponent>();
+		transform->setPosition(glm::vec3(anywhere(rng), 0, anywhere(rng)));
+		transforms.push_back(transform.get());
+		if (i < count)
+			entity->addComponent<Hydra::Component::AIComponent>();
+		else
+			players.push_back(entity->id);
+	}
+
+	Hydra::World::SpatialIndex playerIndex(BarcodeServer::GameServer::PLAYER_CELL_SIZE);
+	Hydra::World::SpatialIndex alienIndex;
+	std::vector<Hydra::World::SpatialIndex::Hit> hits;
+	double linearTime = 0;
+	double gridTime = 0;
+	double fillTime = 0;
+	double radiusLinearTime = 0;
+	double radiusGridTime = 0;
+	double syncTime = 0;
+	size_t mismatches = 0;
+	size_t linearInRange = 0;
+	size_t gridInRange = 0;
+	std::vector<Hydra::World::EntityID> linearTargets(alienQuery.getEntities().size());
+	for (size_t frame = 0; frame < frames; frame++) {
+		for (auto* transform : transforms)
+			transform->setPosition(glm::clamp(transform->position + glm::vec3(step(rng), 0, step(rng)), glm::vec3(0), glm::vec3(levelSize)));
+		const auto& aliens = alienQuery.getEntities();
+
+		auto start = clock::now();
+		for (size_t i = 0; i < aliens.size(); i++) {
+			auto* alien = aliens[i]->getComponent<Hydra::Component::TransformComponent>().get();
+			float distance = FLT_MAX;
+			linearTargets[i] = world::invalidID;
+			for (Hydra::World::EntityID player : players) {
+				const float d = glm::distance(alien->position, world::getEntity(player)->getComponent<Hydra::Component::TransformComponent>()->position);
+				if (d < distance) {
+					distance = d;
+					linearTargets[i] = player;
+				}
+			}
+		}
+		linearTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+		start = clock::now();
+		playerIndex.clear();
+		for (Hydra::World::EntityID player : players)
+			playerIndex.set(player, world::getEntity(player)->getComponent<Hydra::Component::TransformComponent>()->position);
+		const auto filled = clock::now();
+		for (size_t i = 0; i < aliens.size(); i++)
+			mismatches += playerIndex.nearest(aliens[i]->getComponent<Hydra::Component::TransformComponent>()->position) != linearTargets[i];
+		gridTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+		fillTime += std::chrono::duration<double, std::milli>(filled - start).count();
+
+		start = clock::now();
+		for (Hydra::World::EntityID player : players) {
+			const glm::vec3 position = world::getEntity(player)->getComponent<Hydra::Component::TransformComponent>()->position;
+			for (const auto& alien : aliens)
+				linearInRange += glm::distance(position, alien->getComponent<Hydra::Component::TransformComponent>()->position) <= chaseDistance;
+		}
+		radiusLinearTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+		start = clock::now();
+		alienIndex.sync(alienQuery);
+		const auto synced = clock::now();
+		for (Hydra::World::EntityID player : players) {
+			hits.clear();
+			alienIndex.queryRadius(world::getEntity(player)->getComponent<Hydra::Component::TransformComponent>()->position, chaseDistance, hits);
+			gridInRange += hits.size();
+		}
+		radiusGridTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+		syncTime += std::chrono::duration<double, std::milli>(synced - start).count();
+	}
+
+	printf("%zu aliens, %zu players, %zu frames, %.0fx%.0f level\n", count, playerCount, frames, levelSize, levelSize);
+	printf("Closest player, linear: %8.3f ms per frame\n", linearTime / frames);
+	printf("Closest player, grid:   %8.3f ms per frame (%.3f ms filling), %zu of %zu differ\n", gridTime / frames, fillTime / frames, mismatches, count * frames);
+	printf("Aliens in range, linear: %7.3f ms per frame, %zu found\n", radiusLinearTime / frames, linearInRange);
+	printf("Aliens in range, grid:   %7.3f ms per frame (%.3f ms syncing), %zu found\n", radiusGridTime / frames, syncTime / frames, gridInRange);
+	return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include <hydra/network/tcpclient.hpp>
+#include <hydra/network/snapshot.hpp>
+
+namespace BarcodeBot {
+	struct Stats {
+		size_t bytesReceived = 0;
+		size_t bytesSent = 0;
+		size_t packetsReceived = 0;
+		std::vector<float> latencies; // Ping round trip, in milliseconds
+		std::vector<float> tickTimes; // Server tick time from the pongs, in milliseconds
+
+		void add(const Stats& other);
+		void clear();
+	};
+
+	///<summary>
+	///Headless client that walks in a circle around its spawn point and shoots, without loading any assets.
+	///Used to measure how many players the server can handle.
+	///</summary>
+	class Bot final {
+	public:
+		Bot(int id);
+
+		bool connect(char* ip, int port);
+		bool isConnected();
+
+		///<summary>
+		///Receives and handles all packets, then sends the scripted input. time is seconds since the bot started.
+		///</summary>
+		void update(float time, Stats& stats);
+
+	private:
+		int _id;
+		Hydra::Network::TCPClient _tcp;
+		bool _spawned = false;
+		glm::vec3 _spawnPosition;
+		Hydra::Network::TransformInfo _ti;
+		Hydra::Network::SnapshotHistory _snapshots;
+		uint32_t _newestSnapshot = 0;
+		float _nextShot = 0;
+		float _nextPing = 0;
+
+		void _readSnapshot(Hydra::Network::ServerUpdatePacket* sup);
+		void _send(Hydra::Network::Packet* packet, Stats& stats);
+	};
+}
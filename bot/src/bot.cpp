@@ -0,0 +1,119 @@
+#include <bot/bot.hpp>
+#include <chrono>
+#include <cstdio>
+
+using namespace BarcodeBot;
+using namespace Hydra::Network;
+
+static constexpr float MoveRadius = 4.0f;
+static constexpr float MoveSpeed = 1.5f; // Radians per second
+static constexpr float ShootInterval = 0.5f;
+static constexpr float PingInterval = 0.25f;
+
+static uint64_t now() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Stats::add(const Stats& other) {
+	bytesReceived += other.bytesReceived;
+	bytesSent += other.bytesSent;
+	packetsReceived += other.packetsReceived;
+	latencies.insert(latencies.end(), other.latencies.begin(), other.latencies.end());
+	tickTimes.insert(tickTimes.end(), other.tickTimes.begin(), other.tickTimes.end());
+}
+
+void Stats::clear() {
+	bytesReceived = 0;
+	bytesSent = 0;
+	packetsReceived = 0;
+	latencies.clear();
+	tickTimes.clear();
+}
+
+Bot::Bot(int id) : _id(id) {}
+
+bool Bot::connect(char* ip, int port) {
+	return _tcp.initialize(ip, port);
+}
+
+bool Bot::isConnected() {
+	return _tcp.isConnected();
+}
+
+void Bot::update(float time, Stats& stats) {
+	for (Packet* p : _tcp.receiveData()) {
+		stats.bytesReceived += p->len;
+		stats.packetsReceived++;
+		switch (p->type) {
+		case PacketType::ServerInitialize:
+			_ti = ((ServerInitializePacket*)p)->ti;
+			_spawnPosition = _ti.pos;
+			_spawned = true;
+			break;
+		case PacketType::ServerUpdate:
+			_readSnapshot((ServerUpdatePacket*)p);
+			break;
+		case PacketType::ServerPong: {
+			auto pong = (ServerPongPacket*)p;
+			stats.latencies.push_back((now() - pong->time) / 1000.0f);
+			stats.tickTimes.push_back(pong->tickTime);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	if (!_spawned || !_tcp.isConnected())
+		return;
+
+	// Every bot starts at a different place on the circle so they don't all shoot in the same direction
+	const float angle = time * MoveSpeed + _id;
+	const glm::vec3 direction(-glm::sin(angle), 0, glm::cos(angle));
+	_ti.pos = _spawnPosition + glm::vec3(glm::cos(angle), 0, glm::sin(angle)) * MoveRadius;
+	_ti.rot = glm::angleAxis(angle, glm::vec3(0, -1, 0));
+
+	ClientUpdatePacket cup{};
+	cup.ti = _ti;
+	cup.lastSnapshot = _newestSnapshot;
+	_send(&cup, stats);
+
+	if (time >= _nextShot) {
+		ClientShootPacket csp{};
+		csp.ti = _ti;
+		csp.direction = direction;
+		_send(&csp, stats);
+		_nextShot = time + ShootInterval;
+	}
+
+	if (time >= _nextPing) {
+		ClientPingPacket ping{};
+		ping.time = now();
+		_send(&ping, stats);
+		_nextPing = time + PingInterval;
+	}
+}
+
+void Bot::_readSnapshot(ServerUpdatePacket* sup) {
+	// Same as NetClient::_readSnapshot, the snapshots are only decoded so that they can be acked and used as baselines
+	if (sup->sequence <= _newestSnapshot)
+		return;
+	const Snapshot* baseline = _snapshots.find(sup->baseline);
+	if (!baseline || (sup->baseline && sup->sequence - sup->baseline >= SNAPSHOT_HISTORY_SIZE)) {
+		printf("Bot %d: Missing baseline %u for snapshot %u\n", _id, sup->baseline, sup->sequence);
+		return;
+	}
+
+	Snapshot& snapshot = _snapshots.push(sup->sequence);
+	if (!readSnapshotDelta(sup->data, sup->size(), *baseline, snapshot)) {
+		printf("Bot %d: Malformed snapshot %u\n", _id, sup->sequence);
+		snapshot.sequence = 0;
+		snapshot.entities.clear();
+		return;
+	}
+	_newestSnapshot = sup->sequence;
+}
+
+void Bot::_send(Packet* packet, Stats& stats) {
+	if (_tcp.send(packet, packet->len) > 0)
+		stats.bytesSent += packet->len;
+}
@@ -0,0 +1,118 @@
+#include <bot/bot.hpp>
+
+#include <SDL2/SDL_net.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <signal.h>
+#endif
+
+using namespace BarcodeBot;
+
+static float percentile(std::vector<float>& values, float p) {
+	if (values.empty())
+		return 0;
+	const size_t i = std::min(values.size() - 1, (size_t)(p * values.size()));
+	std::nth_element(values.begin(), values.begin() + i, values.end());
+	return values[i];
+}
+
+static void report(const char* label, Stats& stats, size_t connected, size_t total, float seconds) {
+	float tickAverage = 0;
+	for (float t : stats.tickTimes)
+		tickAverage += t;
+	if (!stats.tickTimes.empty())
+		tickAverage /= stats.tickTimes.size();
+	const float perBot = 1.0f / (std::max<size_t>(connected, 1) * seconds * 1024.0f);
+
+	printf("[%s] %zu/%zu bots, tick avg %.2f ms p99 %.2f ms, per bot %.1f kB/s down %.1f kB/s up, latency p50 %.2f ms p95 %.2f ms p99 %.2f ms\n",
+		label, connected, total, tickAverage, percentile(stats.tickTimes, 0.99f), stats.bytesReceived * perBot, stats.bytesSent * perBot,
+		percentile(stats.latencies, 0.50f), percentile(stats.latencies, 0.95f), percentile(stats.latencies, 0.99f));
+	fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+	char defaultIP[] = "127.0.0.1";
+	char* ip = defaultIP;
+	int port = 4545;
+	size_t botCount = 16;
+	float seconds = 30;
+	float ramp = 0;
+	float rate = 30;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--ip") && i + 1 < argc)
+			ip = argv[++i];
+		else if (!strcmp(argv[i], "--port") && i + 1 < argc)
+			port = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--bots") && i + 1 < argc)
+			botCount = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--seconds") && i + 1 < argc)
+			seconds = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--ramp") && i + 1 < argc)
+			ramp = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--rate") && i + 1 < argc)
+			rate = std::max(1.0, atof(argv[++i]));
+		else {
+			printf("Usage: %s [--ip IP] [--port PORT] [--bots N] [--seconds S] [--ramp S] [--rate HZ]\n", argv[0]);
+			printf("\t--ramp S\tConnect the bots evenly over S seconds instead of all at once\n");
+			printf("\t--rate HZ\tHow many times per second every bot sends its position\n");
+			return 1;
+		}
+	}
+#ifdef __linux__
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	SDLNet_Init();
+
+	std::vector<std::unique_ptr<Bot>> bots;
+	Stats window;
+	Stats total;
+	const auto start = std::chrono::steady_clock::now();
+	const auto frameTime = std::chrono::duration<float>(1.0f / rate);
+	auto nextFrame = start;
+	float lastReport = 0;
+	float time = 0;
+	while (time < seconds) {
+		while (bots.size() < botCount && (ramp <= 0 || time >= ramp * bots.size() / botCount)) {
+			auto bot = std::make_unique<Bot>(bots.size());
+			if (!bot->connect(ip, port))
+				printf("Bot %zu failed to connect to %s:%d\n", bots.size(), ip, port);
+			bots.push_back(std::move(bot));
+		}
+
+		size_t connected = 0;
+		for (auto& bot : bots) {
+			if (!bot->isConnected())
+				continue;
+			bot->update(time, window);
+			connected++;
+		}
+
+		if (time - lastReport >= 1.0f) {
+			char label[32];
+			snprintf(label, sizeof(label), "%.0fs", time);
+			total.add(window);
+			report(label, window, connected, botCount, time - lastReport);
+			window.clear();
+			lastReport = time;
+		}
+
+		nextFrame += std::chrono::duration_cast<std::chrono::steady_clock::duration>(frameTime);
+		std::this_thread::sleep_until(nextFrame);
+		time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	size_t connected = std::count_if(bots.begin(), bots.end(), [](const auto& bot) { return bot->isConnected(); });
+	total.add(window);
+	report("total", total, connected, botCount, time);
+	bots.clear();
+	SDLNet_Quit();
+	return 0;
+}
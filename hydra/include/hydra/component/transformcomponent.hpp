@@ -37,10 +37,13 @@ namespace Hydra::Component {
 		void deserialize(nlohmann::json& json) final;
 		void registerUI() final;
 
+		// Looks up the parents to make sure the matrix is up to date, works for transforms that aren't in the world too
 		inline glm::mat4 getMatrix() {
 			_recalculateMatrix();
 			return _matrix;
 		}
+		// The matrix from the last time TransformSystem ticked, or getMatrix() was called
+		inline const glm::mat4& getWorldMatrix() const { return _matrix; }
 
 		inline glm::vec3 getDirection() {
 			static const glm::vec3 forward = {0, 0, -1};
@@ -64,6 +67,11 @@ namespace Hydra::Component {
 		glm::mat4 _matrix = glm::mat4(1);
 
 		void _recalculateMatrix();
+		inline glm::mat4 _localMatrix() const {
+			// Same as translate * mat4_cast * scale, without multiplying the zeros
+			const glm::mat3 r = glm::mat3_cast(glm::normalize(rotation));
+			return glm::mat4(glm::vec4(r[0] * scale.x, 0), glm::vec4(r[1] * scale.y, 0), glm::vec4(r[2] * scale.z, 0), glm::vec4(position, 1));
+		}
 		std::shared_ptr<Hydra::Component::TransformComponent> _getParentComponent();
 	};
 };
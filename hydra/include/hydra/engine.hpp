@@ -54,6 +54,8 @@ namespace Hydra {
 		virtual IO::IMeshLoader* getMeshLoader() = 0;
 		virtual IO::ITextFactory* getTextFactory() = 0;
 		virtual World::ISystem* getPhysicsSystem() = 0;
+		/// The ProjectileSystem that the weapons fire into, nullptr if the state doesn't have bullets
+		virtual World::ISystem* getProjectileSystem() = 0;
 	};
 	inline IState::~IState() {}
 
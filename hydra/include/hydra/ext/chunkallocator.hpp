@@ -0,0 +1,120 @@
+/**
+ * Fixed-size block storage that hands out memory from large contiguous chunks,
+ * and a std allocator on top of it to be used with std::allocate_shared.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace Hydra::Ext {
+	// The block size is decided by the first allocation, all later allocations that fit inside a block are placed
+	// next to each other in chunks of 'blocksPerChunk' blocks. Freed blocks are reused through a free list.
+	// Memory is only returned to the system when the storage is destroyed.
+	class ChunkStorage final {
+	public:
+		struct Stats final {
+			size_t allocations = 0; // Blocks handed out, including reused ones
+			size_t frees = 0;
+			size_t peak = 0; // Most blocks in use at the same time
+			size_t fallbacks = 0; // Allocations that didn't fit inside a block, ChunkAllocator takes them from the global allocator
+
+			inline size_t live() const { return allocations - frees; }
+		};
+
+		explicit ChunkStorage(size_t blocksPerChunk = 256) : _blocksPerChunk(blocksPerChunk) {}
+		~ChunkStorage() {
+			for (void* chunk : _chunks)
+				::operator delete(chunk);
+		}
+
+		ChunkStorage(const ChunkStorage&) = delete;
+		ChunkStorage& operator=(const ChunkStorage&) = delete;
+
+		inline bool fits(size_t size) const { return size <= _blockSize; }
+
+		void* allocate(size_t size) {
+			if (!_blockSize)
+				_blockSize = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+			if (!fits(size)) {
+				_stats.fallbacks++;
+				return nullptr;
+			}
+
+			_stats.allocations++;
+			_stats.peak = std::max(_stats.peak, _stats.live());
+			if (_freeList) {
+				FreeBlock* block = _freeList;
+				_freeList = block->next;
+				return block;
+			}
+
+			if (_chunks.empty() || _usedInLastChunk == _blocksPerChunk) {
+				_chunks.push_back(::operator new(_blockSize * _blocksPerChunk));
+				_usedInLastChunk = 0;
+			}
+			return static_cast<char*>(_chunks.back()) + _blockSize * _usedInLastChunk++;
+		}
+
+		void deallocate(void* ptr) {
+			_stats.frees++;
+			FreeBlock* block = static_cast<FreeBlock*>(ptr);
+			block->next = _freeList;
+			_freeList = block;
+		}
+
+		inline size_t blockSize() const { return _blockSize; }
+		inline size_t chunkCount() const { return _chunks.size(); }
+		inline size_t blocksPerChunk() const { return _blocksPerChunk; }
+		inline const Stats& stats() const { return _stats; }
+
+	private:
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		size_t _blockSize = 0;
+		size_t _blocksPerChunk;
+		size_t _usedInLastChunk = 0;
+		FreeBlock* _freeList = nullptr;
+		std::vector<void*> _chunks;
+		Stats _stats;
+	};
+
+	// Allocations that do not fit inside the storage blocks (like arrays) fall back to the global allocator.
+	template <typename T>
+	struct ChunkAllocator {
+		typedef T value_type;
+
+		ChunkStorage* storage;
+
+		explicit ChunkAllocator(ChunkStorage* storage) : storage(storage) {}
+		template <typename U>
+		ChunkAllocator(const ChunkAllocator<U>& other) : storage(other.storage) {}
+
+		T* allocate(size_t n) {
+			if (void* ptr = storage->allocate(sizeof(T) * n))
+				return static_cast<T*>(ptr);
+			return static_cast<T*>(::operator new(sizeof(T) * n));
+		}
+
+		void deallocate(T* ptr, size_t n) {
+			if (storage->fits(sizeof(T) * n))
+				storage->deallocate(ptr);
+			else
+				::operator delete(ptr);
+		}
+
+		template <typename U>
+		inline bool operator==(const ChunkAllocator<U>& other) const { return storage == other.storage; }
+		template <typename U>
+		inline bool operator!=(const ChunkAllocator<U>& other) const { return storage != other.storage; }
+	};
+}
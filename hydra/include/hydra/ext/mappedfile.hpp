@@ -0,0 +1,38 @@
+/**
+ * Read-only memory mapped files.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace Hydra::Ext {
+	class HYDRA_BASE_API MappedFile final {
+	public:
+		MappedFile(const std::string& file);
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		inline bool isOpen() const { return _data != nullptr; }
+		// Page aligned
+		inline const uint8_t* data() const { return _data; }
+		inline size_t size() const { return _size; }
+
+		// Size and modification time in nanoseconds, returns false if the file doesn't exist
+		static bool fileStamp(const std::string& file, uint64_t& size, int64_t& modified);
+
+	private:
+		const uint8_t* _data = nullptr;
+		size_t _size = 0;
+#ifdef _WIN32
+		void* _file = nullptr;
+		void* _mapping = nullptr;
+#endif
+	};
+};
@@ -0,0 +1,82 @@
+/**
+ * Baked meshes (.bATTIC), a .mATTIC together with its .wATTIC and .sATTIC files in a form that can be memory mapped
+ * and uploaded as is.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <hydra/renderer/renderer.hpp>
+
+namespace Hydra::IO {
+	namespace BakedMesh {
+		constexpr uint32_t MAGIC = 0x4B414248; // "HBAK"
+		constexpr uint32_t VERSION = 2;
+		// Every block starts at a multiple of this
+		constexpr size_t ALIGNMENT = 64;
+		// Same as the number of animation slots in GLMesh
+		constexpr size_t MAX_ANIMATIONS = 7;
+
+		enum Texture : uint32_t { diffuse = 0, normal, glow, specular, TEXTURE_COUNT };
+
+		struct Header final {
+			uint32_t magic;
+			uint32_t version;
+			uint64_t fileSize;
+			uint32_t vertexSize; // sizeof(Renderer::Vertex)
+			uint32_t hasAnimation;
+			uint32_t vertexCount;
+			uint32_t indexCount;
+			uint64_t vertexOffset;
+			uint64_t indexOffset;
+			uint64_t textureOffset[TEXTURE_COUNT]; // Null terminated paths
+			uint64_t animationOffset; // MAX_ANIMATIONS Animation structs
+			uint64_t sourceCount;
+			uint64_t sourceOffset; // sourceCount Source structs
+		};
+
+		// A file that was read when baking, used to find out of date files
+		struct Source final {
+			uint64_t size; // UINT64_MAX if the file didn't exist
+			int64_t modified; // Nanoseconds, 0 if the file didn't exist
+			uint64_t pathOffset; // Null terminated path
+		};
+
+		struct Animation final {
+			uint32_t joints; // 0 if the slot is not used
+			uint32_t keyframes;
+			uint64_t matrixOffset; // joints * keyframes matrices, matrix [joint * keyframes + keyframe]
+		};
+
+		// Points into the baked data, nothing is copied
+		struct HYDRA_BASE_API View final {
+			const Header* header = nullptr;
+			const Renderer::Vertex* vertices = nullptr;
+			const uint32_t* indices = nullptr;
+			const char* textures[TEXTURE_COUNT] = {};
+			const Animation* animations = nullptr;
+			const glm::mat4* matrices[MAX_ANIMATIONS] = {};
+			const Source* sources = nullptr;
+		};
+
+		// "assets/objects/X.mATTIC" -> "assets/objects/X.bATTIC"
+		HYDRA_BASE_API std::string bakedPath(const std::string& file);
+
+		// Converts a .mATTIC and the files it references, returns false if the .mATTIC is missing or broken.
+		// Missing weight and skeleton files are skipped, like GLMesh used to do.
+		HYDRA_BASE_API bool bake(const std::string& file, std::vector<uint8_t>& out);
+
+		// Checks that the header and all the blocks are valid and fills in view. data must be 16 byte aligned.
+		HYDRA_BASE_API bool parse(const uint8_t* data, size_t size, View& view);
+
+		// False if any of the files the view was baked from has been added, removed or changed since
+		HYDRA_BASE_API bool isCurrent(const View& view);
+	};
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <hydra/world/world.hpp>
+#include <hydra/component/transformcomponent.hpp>
+
+namespace Hydra::System {
+	// Updates all the world matrices in one pass, before anything reads them with TransformComponent::getWorldMatrix().
+	// The transforms are kept sorted so that every parent comes before its children, that order is only rebuilt when
+	// a transform is added or removed.
+	class HYDRA_BASE_API TransformSystem final : public Hydra::World::ISystem {
+	public:
+		TransformSystem();
+		~TransformSystem() final;
+
+		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
+
+		inline const std::string type() const final { return "TransformSystem"; }
+		void registerUI() final;
+
+	private:
+		Hydra::World::Query<Hydra::Component::TransformComponent> _transforms;
+		size_t _version = SIZE_MAX;
+		std::vector<Hydra::Component::TransformComponent*> _order;
+		std::vector<size_t> _parents; // Index in _order, SIZE_MAX if the parent doesn't have a transform
+		size_t _updated = 0;
+
+		// Only used while sorting
+		std::unordered_map<Hydra::World::EntityID, size_t> _index;
+		std::vector<size_t> _depth;
+		std::vector<size_t> _start;
+
+		void _sort();
+	};
+}
@@ -0,0 +1,63 @@
+/**
+ * Entity changes that are recorded while systems tick and applied later, at a point where nothing else touches World.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <hydra/world/world.hpp>
+
+namespace Hydra::World {
+	// Every thread records into its own buffer, get it with World::commands().
+	// World::applyCommands() runs them, in the order they were recorded for each thread. JobGraph::run does this when
+	// all the systems are done, so entities that are spawned or destroyed while ticking show up for the next run.
+	class HYDRA_BASE_API CommandBuffer final {
+	public:
+		CommandBuffer() = default;
+		CommandBuffer(const CommandBuffer&) = delete;
+		CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+		// The entity doesn't have an ID until it is created, so everything that needs it goes into init
+		void spawn(const std::string& name, EntityID parent, std::function<void(const std::shared_ptr<Entity>&)> init);
+		// Entity::kill(), DeadSystem removes it
+		void destroy(EntityID entity);
+		// For anything else that has to wait until the entities are created
+		void defer(std::function<void()> function);
+
+		template <typename T>
+		inline void addComponent(EntityID entity, std::function<void(T&)> init = nullptr) {
+			_commands.push_back(Command{Type::addComponent, entity, std::string(), [init](const std::shared_ptr<Entity>& e) {
+				auto component = e->addComponent<T>();
+				if (init)
+					init(*component);
+			}, nullptr});
+		}
+
+		inline bool empty() const { return _commands.empty(); }
+		inline size_t size() const { return _commands.size(); }
+
+		// Commands that are recorded while applying are kept for the next apply
+		void apply();
+		void clear();
+
+	private:
+		enum class Type { spawn, destroy, addComponent, call };
+		struct Command final {
+			Type type;
+			EntityID entity; // The parent when spawning
+			std::string name;
+			std::function<void(const std::shared_ptr<Entity>&)> init;
+			std::function<void()> function;
+		};
+
+		std::vector<Command> _commands;
+		std::vector<Command> _applying;
+	};
+};
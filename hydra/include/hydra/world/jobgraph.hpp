@@ -0,0 +1,81 @@
+/**
+ * Ticks systems on a pool of worker threads.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <condition_variable>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <hydra/world/world.hpp>
+
+namespace Hydra::World {
+	// Systems that conflict (see SystemAccess) tick in the order they were added, the rest can tick at the same time.
+	// The dependencies are rebuilt every run, so a system may change what it returns from access() between runs.
+	class HYDRA_BASE_API JobGraph final {
+	public:
+		struct Timing final {
+			ISystem* system;
+			float start; // Milliseconds since run started
+			float time; // Milliseconds
+			float pathTime; // The longest chain of dependencies that ends with this system, including its own time
+			size_t pathPrevious; // Index of the previous system in that chain, SIZE_MAX if there is none
+		};
+
+		// threads is the number of worker threads next to the thread that calls run, SIZE_MAX picks it from the CPU count
+		JobGraph(size_t threads = SIZE_MAX);
+		~JobGraph();
+		JobGraph(const JobGraph&) = delete;
+		JobGraph& operator=(const JobGraph&) = delete;
+
+		void add(ISystem* system);
+		void clear();
+
+		// Ticks all the systems, then applies World::commands() and returns
+		void run(float delta);
+
+		// From the last run, in the order the systems were added
+		inline const std::vector<Timing>& getTimings() const { return _timings; }
+		// Wall time of the last run including applying the commands, in milliseconds
+		inline float getTime() const { return _time; }
+		// The chain of dependent systems that took the longest time in the last run, a run can't be faster than this
+		std::vector<ISystem*> getCriticalPath(float* time = nullptr) const;
+		inline size_t getThreadCount() const { return _workers.size() + 1; }
+
+		void registerUI();
+
+	private:
+		struct Job final {
+			ISystem* system;
+			SystemAccess access;
+			std::vector<size_t> dependents;
+			std::vector<size_t> dependencies;
+			size_t remaining;
+		};
+
+		std::vector<ISystem*> _systems;
+		std::vector<Job> _jobs;
+		std::vector<Timing> _timings;
+		float _time = 0;
+
+		std::vector<std::thread> _workers;
+		std::mutex _mutex;
+		std::condition_variable _cv;
+		std::vector<size_t> _ready;
+		size_t _done = 0;
+		float _delta = 0;
+		bool _quit = false;
+		std::chrono::time_point<std::chrono::high_resolution_clock> _start;
+
+		void _build();
+		bool _pop(bool mainThread, size_t& job);
+		void _execute(size_t job, std::unique_lock<std::mutex>& lock);
+		void _worker();
+	};
+};
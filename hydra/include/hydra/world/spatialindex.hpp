@@ -0,0 +1,105 @@
+/**
+ * A uniform grid of entity positions, for finding the entities that are close to a point.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <cfloat>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include <hydra/world/world.hpp>
+
+namespace Hydra::Component {
+	struct TransformComponent;
+};
+
+namespace Hydra::World {
+	// The cells are squares on the x/z plane and are hashed into buckets, so the level can have any size and an empty
+	// cell costs nothing. Distances are still measured in 3D.
+	// Fill it by hand with set() and remove(), or call sync() every tick to make it follow the entities of a Query.
+	// Don't mix the two in the same index.
+	// The queries are const and can run on many threads at the same time, as long as nothing changes the index.
+	class HYDRA_BASE_API SpatialIndex final {
+	public:
+		struct Hit final {
+			EntityID id;
+			glm::vec3 position;
+			float distance;
+		};
+
+		// cellSize should be about the radius that is usually asked for, or the distance to the closest entity
+		SpatialIndex(float cellSize = 16.0f);
+		SpatialIndex(const SpatialIndex&) = delete;
+		SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+		// Adds the entity, or moves it if it is already in the index
+		void set(EntityID id, const glm::vec3& position);
+		void remove(EntityID id);
+		void clear();
+
+		// Makes the index hold every entity in the query at the position of its TransformComponent, so the query must
+		// have TransformComponent. Only the entities that moved to another cell are moved in the grid, until an entity
+		// is added to or removed from the query.
+		void sync(const QueryBase& query);
+
+		// Up to k entities within maxDistance, the closest first
+		void nearest(const glm::vec3& position, size_t k, std::vector<Hit>& out, float maxDistance = FLT_MAX) const;
+		// The closest entity within maxDistance, World::invalidID if there is none
+		EntityID nearest(const glm::vec3& position, float maxDistance = FLT_MAX) const;
+		// Every entity within radius, in no special order. out is not cleared.
+		void queryRadius(const glm::vec3& position, float radius, std::vector<Hit>& out) const;
+
+		inline size_t size() const { return _entries.size(); }
+		inline float getCellSize() const { return _cellSize; }
+
+	private:
+		static constexpr uint32_t NONE = UINT32_MAX;
+
+		// The entries of a bucket are a linked list, a bucket can hold more than one cell
+		struct Entry final {
+			EntityID id;
+			glm::vec3 position;
+			glm::ivec2 cell;
+			uint32_t previous;
+			uint32_t next;
+		};
+
+		float _cellSize;
+		float _invCellSize;
+		std::vector<Entry> _entries;
+		std::vector<uint32_t> _buckets;
+		std::unordered_map<EntityID, uint32_t> _slots;
+		// Every cell that has been used since the last clear is inside these
+		glm::ivec2 _minCell;
+		glm::ivec2 _maxCell;
+
+		// Set by sync, _transforms[i] is the transform of _entries[i]
+		const QueryBase* _query = nullptr;
+		size_t _queryVersion = 0;
+		std::vector<Hydra::Component::TransformComponent*> _transforms;
+
+		inline glm::ivec2 _cellOf(const glm::vec3& position) const {
+			return glm::ivec2((int)glm::floor(position.x * _invCellSize), (int)glm::floor(position.z * _invCellSize));
+		}
+		inline uint32_t _bucketOf(const glm::ivec2& cell) const {
+			return (uint32_t)(((uint32_t)cell.x * 73856093u) ^ ((uint32_t)cell.y * 19349663u)) & (uint32_t)(_buckets.size() - 1);
+		}
+
+		void _link(uint32_t slot);
+		void _unlink(uint32_t slot);
+		void _insert(EntityID id, const glm::vec3& position);
+		void _grow();
+		// Calls f for every entry in the cell
+		template <typename F>
+		inline void _forEachInCell(const glm::ivec2& cell, F&& f) const {
+			for (uint32_t slot = _buckets[_bucketOf(cell)]; slot != NONE; slot = _entries[slot].next)
+				if (_entries[slot].cell == cell)
+					f(_entries[slot]);
+		}
+	};
+};
@@ -0,0 +1,67 @@
+/**
+ * Splits a loop over a pool of worker threads.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Hydra::World {
+	// The calling thread takes chunks of the loop too, and parallelFor returns when every chunk is done.
+	// A system can call it from inside JobGraph, the workers are not the ones that tick the systems.
+	// Calls from many threads take turns, and a call from inside a chunk runs the whole loop on that thread.
+	class HYDRA_BASE_API WorkerPool final {
+	public:
+		// threads is the number of worker threads next to the thread that calls parallelFor, SIZE_MAX picks it from
+		// the CPU count
+		WorkerPool(size_t threads = SIZE_MAX);
+		~WorkerPool();
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		// The pool that the systems share
+		static WorkerPool& instance();
+
+		// Calls f(chunkBegin, chunkEnd) for chunks of at most grainSize of [begin, end), in no special order
+		template <typename F>
+		inline void parallelFor(size_t begin, size_t end, size_t grainSize, F&& f) {
+			using Body = typename std::remove_reference<F>::type;
+			_run(begin, end, grainSize, [](void* body, size_t chunkBegin, size_t chunkEnd) { (*static_cast<Body*>(body))(chunkBegin, chunkEnd); }, (void*)&f);
+		}
+
+		inline size_t getThreadCount() const { return _workers.size() + 1; }
+
+	private:
+		typedef void (*Chunk_f)(void* body, size_t begin, size_t end);
+
+		static thread_local bool _inside;
+
+		std::vector<std::thread> _workers;
+		std::mutex _callMutex;
+		std::mutex _mutex;
+		std::condition_variable _cv;
+		std::condition_variable _doneCv;
+		Chunk_f _chunk = nullptr;
+		void* _body = nullptr;
+		std::atomic<size_t> _next{0};
+		size_t _end = 0;
+		size_t _grainSize = 1;
+		size_t _running = 0;
+		size_t _generation = 0;
+		bool _quit = false;
+
+		void _run(size_t begin, size_t end, size_t grainSize, Chunk_f chunk, void* body);
+		void _runChunks();
+		void _worker(size_t generation);
+	};
+};
@@ -18,6 +18,7 @@
 #undef max
 #include <json.hpp>
 #include <hydra/ext/macros.hpp>
+#include <hydra/ext/chunkallocator.hpp>
 
 namespace Hydra::Renderer { struct HYDRA_BASE_API DrawObject; }
 namespace Hydra::Physics { struct HYDRA_BASE_API PhysicsObject; }
@@ -133,19 +134,37 @@ namespace Hydra::World {
 	template<typename T, typename... Args>
 	constexpr T combine(T first, Args... args) { return first | combine<T>(args...); }
 
+	// Takes its nodes from a ChunkStorage, which has to outlive it. The bucket arrays don't fit and use the global allocator.
+	template <typename Key, typename Value>
+	using ChunkMap = std::unordered_map<Key, Value, std::hash<Key>, std::equal_to<Key>, Hydra::Ext::ChunkAllocator<std::pair<const Key, Value>>>;
+
 	struct HYDRA_BASE_API Entity final {
 		// Entity Core
 		EntityID id;
 		Hydra::Component::ComponentBits activeComponents;
+		// Bumped every time a component is added or removed, so that cached component pointers can tell that a
+		// component was replaced even when activeComponents ends up the same
+		size_t componentGeneration = 0;
 		EntityID parent;
+		// Only changed by World. Removing a child moves the last one into its place.
 		std::vector<EntityID> children;
 
 		// Extra data
 		std::string name;
+		// Set it with kill(), DeadSystem only looks at the entities that have been killed
 		bool dead = false;
 
+		// Where the entity is stored inside World::_archetypes, maintained by World
+		size_t archetype = SIZE_MAX;
+		size_t archetypeSlot = 0;
+		// Where the entity is inside its parent's children, maintained by World
+		size_t childSlot = 0;
+
 		~Entity();
 
+		// Not thread safe, use World::commands().destroy() while systems are ticking
+		void kill();
+
 		inline bool hasComponents(Hydra::Component::ComponentBits cb) const { return (activeComponents & cb) == cb; }
 
 		template <typename T>
@@ -171,7 +190,8 @@ namespace Hydra::World {
 		inline std::shared_ptr<T> addComponent() {
 			if (hasComponents(T::bits))
 				return std::static_pointer_cast<T>(T::componentHandler->getComponent(id));
-			activeComponents |= T::bits;
+			setActiveComponents(activeComponents | T::bits);
+			componentGeneration++;
 			return std::static_pointer_cast<T>(T::componentHandler->addComponent(id));
 		}
 
@@ -179,10 +199,14 @@ namespace Hydra::World {
 		inline void removeComponent() {
 			if (!hasComponents(T::bits))
 				return;
-			activeComponents &= ~T::bits;
+			setActiveComponents(activeComponents & ~T::bits);
+			componentGeneration++;
 			T::componentHandler->removeComponent(id);
 		}
 
+		// Updates activeComponents and moves the entity to the matching archetype
+		void setActiveComponents(Hydra::Component::ComponentBits bits);
+
 		void serialize(nlohmann::json& json) const;
 		void deserialize(nlohmann::json& json);
 	};
@@ -208,24 +232,37 @@ namespace Hydra::World {
 		virtual std::shared_ptr<IComponentBase> getComponent(EntityID entityID) = 0;
 		virtual std::shared_ptr<IComponentBase> addComponent(EntityID entityID) = 0;
 		virtual void removeComponent(EntityID entityID) = 0;
+
+		virtual const std::string& getName() const = 0;
+		virtual const Hydra::Ext::ChunkStorage& getStorage() const = 0;
 	};
 
+	// Components of the same type are allocated next to each other inside the chunks of _storage,
+	// the shared_ptr control block is placed in the same block as the component.
 	template <typename T>
 	class ComponentHandler : public IComponentHandler {
 	public:
-		std::unordered_map<EntityID, size_t> _map;
+		// Declared first, so they outlive the components and the map
+		Hydra::Ext::ChunkStorage _storage;
+		Hydra::Ext::ChunkStorage _mapStorage;
+		ChunkMap<EntityID, size_t> _map;
 		std::vector<std::shared_ptr<IComponentBase>> _components;
+		const std::string _name;
+
+		ComponentHandler(const std::string& name) : _map(Hydra::Ext::ChunkAllocator<EntityID>(&_mapStorage)), _name(name) {}
 
 		const std::vector<std::shared_ptr<IComponentBase>>& getActiveComponents() final { return _components; }
+		const std::string& getName() const final { return _name; }
+		const Hydra::Ext::ChunkStorage& getStorage() const final { return _storage; }
 
 		std::shared_ptr<IComponentBase> getComponent(EntityID entityID) final {
 			return _components[_map[entityID]];
 		}
 
 		std::shared_ptr<IComponentBase> addComponent(EntityID entityID) final {
-			auto t = new T();
+			auto t = std::allocate_shared<T>(Hydra::Ext::ChunkAllocator<T>(&_storage));
 			t->entityID = entityID;
-			_components.emplace_back(std::shared_ptr<IComponentBase>(t));
+			_components.emplace_back(std::move(t));
 			_map[entityID] = _components.size() - 1;
 			return _components.back();
 		}
@@ -332,6 +369,59 @@ namespace Hydra::World {
 	template HYDRA_PHYSICS_API struct IComponent<Hydra::Component::SpawnPointComponent, Hydra::Component::ComponentBits::SpawnPoint>;
 	template HYDRA_NETWORK_API struct IComponent<Hydra::Component::NetworkSyncComponent, Hydra::Component::ComponentBits::NetworkSync>;
 
+	// All entities that have exactly the same set of components. Only the entities are grouped, the components stay in
+	// the ChunkStorage of their ComponentHandler, as getComponent hands out shared_ptrs that must not move.
+	struct HYDRA_BASE_API Archetype final {
+		Hydra::Component::ComponentBits bits;
+		std::vector<std::shared_ptr<Entity>> entities;
+	};
+
+	// A persistent list of all the entities that have atleast the components in 'bits'.
+	// World updates it when components and entities are added or removed, so reading it every tick doesn't allocate.
+	// Entities that are created while iterating are appended, so iterate it by index and don't keep references into it.
+	class HYDRA_BASE_API QueryBase {
+	public:
+		const Hydra::Component::ComponentBits bits;
+
+		QueryBase(Hydra::Component::ComponentBits bits);
+		~QueryBase();
+
+		QueryBase(const QueryBase&) = delete;
+		QueryBase& operator=(const QueryBase&) = delete;
+
+		inline const std::vector<std::shared_ptr<Entity>>& getEntities() const { return _entities; }
+		inline bool matches(Hydra::Component::ComponentBits other) const { return (other & bits) == bits; }
+		// Changes every time an entity is added or removed, so that anything built from the entities knows when to rebuild
+		inline size_t getVersion() const { return _version; }
+
+		void _add(const std::shared_ptr<Entity>& entity);
+		void _remove(EntityID entityID);
+		void _clear();
+
+	private:
+		std::vector<std::shared_ptr<Entity>> _entities;
+		Hydra::Ext::ChunkStorage _slotStorage;
+		ChunkMap<EntityID, size_t> _slots;
+		size_t _version = 0;
+	};
+
+	template <typename Component0, typename... Components>
+	class Query final : public QueryBase {
+	public:
+		Query() : QueryBase(combine<Hydra::Component::ComponentBits>(Component0::bits, Components::bits...)) {}
+	};
+
+	class HYDRA_BASE_API CommandBuffer;
+
+	// How much a ChunkStorage has been used, see World::getAllocationStats
+	struct HYDRA_BASE_API AllocationStats final {
+		std::string name;
+		Hydra::Ext::ChunkStorage::Stats stats;
+		size_t blockSize;
+		size_t chunks;
+		size_t blocksPerChunk;
+	};
+
 	struct HYDRA_BASE_API World final {
 		inline static std::shared_ptr<Entity>& root() {
 			// I'm doing this because the World object will be invalid if it doesn't have an root object
@@ -343,6 +433,8 @@ namespace Hydra::World {
 		static constexpr EntityID rootID = 1;
 
 		static void reset();
+		// Removes every entity, without creating a new root. For shutting down, the world can't be used after it.
+		static void clear();
 
 		inline static std::shared_ptr<Entity> newEntity(const std::string& name, std::shared_ptr<Entity> parent) {
 			return newEntity(name, parent->id);
@@ -352,37 +444,95 @@ namespace Hydra::World {
 		}
 
 		static std::shared_ptr<Entity> newEntity(const std::string& name, EntityID parent);
+		// Also removes the children
 		static void removeEntity(EntityID entityID);
+		// Removes everything that has been killed since the last call, and their children
+		static void removeDeadEntities();
+
+		// The calling thread's CommandBuffer, use it instead of newEntity and Entity::kill while systems are ticking
+		static CommandBuffer& commands();
+		// Applies the commands of every thread. Only call this when no system is ticking.
+		static void applyCommands();
+
+		// One entry for the entities and one for every registered component type
+		static void getAllocationStats(std::vector<AllocationStats>& output);
 
 		inline static std::shared_ptr<Entity> getEntity(EntityID id) {
-			if (!_map.count(id))
-				return std::shared_ptr<Entity>();
-			if (auto pos = _map[id]; pos < _entities.size())
-				return _entities[pos];
-			else
+			auto it = _map.find(id);
+			if (it == _map.end() || it->second >= _entities.size())
 				return std::shared_ptr<Entity>();
+			return _entities[it->second];
 		}
 
+		// Only visits the archetypes that contains all the components, instead of every component of the first type
 		template <typename Component0, typename... Components>
 		inline static void getEntitiesWithComponents(std::vector<std::shared_ptr<Entity>>& output) {
 			output.clear();
-			const Hydra::Component::ComponentBits bits = combine<Hydra::Component::ComponentBits>(Components::bits...);
-			for (auto& c : Component0::componentHandler->getActiveComponents())
-				if (auto e = getEntity(c->entityID); e && e->hasComponents(bits))
-					output.push_back(e);
+			const Hydra::Component::ComponentBits bits = combine<Hydra::Component::ComponentBits>(Component0::bits, Components::bits...);
+			size_t count = 0;
+			for (auto& archetype : _archetypes)
+				if ((archetype.bits & bits) == bits)
+					count += archetype.entities.size();
+			output.reserve(count);
+			for (auto& archetype : _archetypes)
+				if ((archetype.bits & bits) == bits)
+					output.insert(output.end(), archetype.entities.begin(), archetype.entities.end());
+		}
+
+		// Calls f(Entity&) for the same entities, one archetype at a time, without copying the shared_ptrs.
+		// f must not add or remove entities or components, use commands() for that.
+		template <typename Component0, typename... Components, typename F>
+		inline static void forEachEntityWithComponents(F&& f) {
+			const Hydra::Component::ComponentBits bits = combine<Hydra::Component::ComponentBits>(Component0::bits, Components::bits...);
+			for (auto& archetype : _archetypes)
+				if ((archetype.bits & bits) == bits)
+					for (auto& entity : archetype.entities)
+						f(*entity);
 		}
 
-		static std::unordered_map<EntityID, size_t> _map;
+		static size_t _getArchetype(Hydra::Component::ComponentBits bits);
+		static void _addToArchetype(std::shared_ptr<Entity> entity, size_t archetype);
+		static std::shared_ptr<Entity> _removeFromArchetype(Entity& entity);
+		static void _updateQueries(const std::shared_ptr<Entity>& entity, Hydra::Component::ComponentBits oldBits, Hydra::Component::ComponentBits newBits);
+		static void _discardCommands();
+		static void _removeEntities(std::vector<EntityID>& entities);
+
+		static Hydra::Ext::ChunkStorage _entityStorage;
+		static Hydra::Ext::ChunkStorage _mapStorage;
+		static ChunkMap<EntityID, size_t> _map;
 		static std::vector<std::shared_ptr<Entity>> _entities;
+		static std::vector<Archetype> _archetypes;
+		static std::unordered_map<uint64_t /* ComponentBits */, size_t> _archetypeMap;
+		static std::vector<QueryBase*> _queries;
+		static std::vector<EntityID> _dead;
 		static EntityID _idCounter;
 		static bool _isResetting;
 	};
 
+	// What a system touches while ticking, used by JobGraph to find the systems that can tick at the same time.
+	// Two systems conflict if one of them writes a component that the other one reads or writes.
+	struct HYDRA_BASE_API SystemAccess final {
+		Hydra::Component::ComponentBits reads = Hydra::Component::ComponentBits(0);
+		Hydra::Component::ComponentBits writes = Hydra::Component::ComponentBits(0);
+		// Creates or removes entities or components, or kills entities. Conflicts with every other system.
+		// Doing that through World::commands() instead doesn't count, the commands are applied after the run.
+		bool structural = false;
+		// Uses SDL, OpenGL or ImGui, so it has to tick on the thread that calls JobGraph::run
+		bool mainThread = false;
+
+		inline bool conflicts(const SystemAccess& other) const {
+			using Hydra::Component::ComponentBits;
+			return structural || other.structural || (writes & (other.reads | other.writes)) != ComponentBits(0) || (other.writes & reads) != ComponentBits(0);
+		}
+	};
+
 	class HYDRA_BASE_API ISystem {
 	public:
 		virtual ~ISystem() = 0;
 
 		virtual void tick(float delta) = 0;
+		// Systems that don't override this tick alone, on the thread that calls JobGraph::run
+		virtual SystemAccess access() const { SystemAccess a; a.structural = a.mainThread = true; return a; }
 
 		virtual const std::string type() const = 0;
 		virtual void registerUI() = 0;
@@ -9,9 +9,9 @@ namespace Hydra::Component::ComponentManager {
 	std::map<std::string, createOrGetComponent_f>& createOrGetComponentMap() {
 		static std::map<std::string, createOrGetComponent_f> map;
 		if (map.empty()) {
-			IComponent<Hydra::Component::TransformComponent, Hydra::Component::ComponentBits::Transform>::componentHandler = new ComponentHandler<TransformComponent>();
+			IComponent<Hydra::Component::TransformComponent, Hydra::Component::ComponentBits::Transform>::componentHandler = new ComponentHandler<TransformComponent>("TransformComponent");
 			map["TransformComponent"] = &createOrGetComponentHelper<TransformComponent>;
-			IComponent<Hydra::Component::RoomComponent, Hydra::Component::ComponentBits::Room>::componentHandler = new ComponentHandler<RoomComponent>();
+			IComponent<Hydra::Component::RoomComponent, Hydra::Component::ComponentBits::Room>::componentHandler = new ComponentHandler<RoomComponent>("RoomComponent");
 			map["RoomComponent"] = &createOrGetComponentHelper<RoomComponent>;
 		}
 		return map;
@@ -72,15 +72,15 @@ void TransformComponent::_recalculateMatrix() {
 		parentUpdateCounter = p->updateCounter;
 	dirty = false;
 
-	_matrix = parent * (glm::translate(position) * glm::mat4_cast(glm::normalize(rotation)) * glm::scale(scale));
+	_matrix = p ? parent * _localMatrix() : _localMatrix();
 }
 
 std::shared_ptr<Hydra::Component::TransformComponent> TransformComponent::_getParentComponent() {
-	auto& pID = Hydra::World::World::getEntity(entityID)->parent;
-	auto p = Hydra::World::World::getEntity(pID);
-	if (ignoreParent || !p) {
-		pID = Hydra::World::World::invalidID;
+	// Entity::parent is left alone, World uses it to find the entity in its parent's children
+	auto e = Hydra::World::World::getEntity(entityID);
+	auto p = e ? Hydra::World::World::getEntity(e->parent) : nullptr;
+	if (ignoreParent || !p)
 		return std::shared_ptr<TransformComponent>();
-	} else
+	else
 		return p->getComponent<TransformComponent>();
 }
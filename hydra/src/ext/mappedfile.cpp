@@ -0,0 +1,83 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * Read-only memory mapped files.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#include <hydra/ext/mappedfile.hpp>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+using namespace Hydra::Ext;
+
+MappedFile::MappedFile(const std::string& file) {
+#ifdef _WIN32
+	HANDLE handle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return;
+	_file = handle;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(handle, &size) || !size.QuadPart)
+		return;
+	_mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!_mapping)
+		return;
+	_data = (const uint8_t*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (_data)
+		_size = size.QuadPart;
+#else
+	int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			_data = (const uint8_t*)data;
+			_size = st.st_size;
+		}
+	}
+	// The mapping keeps the file alive
+	close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mapping)
+		CloseHandle(_mapping);
+	if (_file)
+		CloseHandle(_file);
+#else
+	if (_data)
+		munmap((void*)_data, _size);
+#endif
+}
+
+bool MappedFile::fileStamp(const std::string& file, uint64_t& size, int64_t& modified) {
+	struct stat st;
+	if (stat(file.c_str(), &st) != 0)
+		return false;
+	size = st.st_size;
+#ifdef _WIN32
+	modified = (int64_t)st.st_mtime * 1000000000;
+#else
+	modified = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+	return true;
+}
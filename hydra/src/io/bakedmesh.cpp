@@ -0,0 +1,343 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * Baked meshes (.bATTIC), a .mATTIC together with its .wATTIC and .sATTIC files in a form that can be memory mapped
+ * and uploaded as is.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#include <hydra/io/bakedmesh.hpp>
+#include <hydra/ext/mappedfile.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace Hydra::IO;
+using namespace Hydra::Renderer;
+
+static_assert(sizeof(Vertex) == 88, "Vertex changed, bump BakedMesh::VERSION");
+
+namespace {
+	struct Reader {
+		std::vector<uint8_t> data;
+		size_t pos = 0;
+		bool ok;
+
+		Reader(const std::string& file) {
+			std::ifstream in(file, std::ios::binary);
+			ok = in.good();
+			if (ok)
+				data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+
+		void read(void* out, size_t size) {
+			if (!ok || data.size() - pos < size) {
+				ok = false;
+				memset(out, 0, size);
+				return;
+			}
+			memcpy(out, data.data() + pos, size);
+			pos += size;
+		}
+
+		void skip(size_t size) {
+			if (!ok || data.size() - pos < size)
+				ok = false;
+			else
+				pos += size;
+		}
+
+		template <typename T>
+		T read() {
+			T value;
+			read(&value, sizeof(T));
+			return value;
+		}
+
+		// Reads a count, and fails if there can't be that many elements of elementSize left in the file
+		size_t readCount(size_t elementSize) {
+			int count = read<int>();
+			if (count < 0 || (size_t)count > (data.size() - pos) / std::max<size_t>(elementSize, 1))
+				ok = false;
+			return ok ? count : 0;
+		}
+
+		std::string readString() {
+			size_t length = readCount(1);
+			std::string str(length, '\0');
+			read(&str[0], length);
+			return str;
+		}
+	};
+
+	struct SourceFile {
+		std::string path;
+		uint64_t size = UINT64_MAX;
+		int64_t modified = 0;
+
+		// Taken before the file is read, so a change while baking makes the result out of date
+		SourceFile(const std::string& path) : path(path) {
+			if (!Hydra::Ext::MappedFile::fileStamp(path, size, modified)) {
+				size = UINT64_MAX;
+				modified = 0;
+			}
+		}
+	};
+
+	struct Skeleton {
+		uint32_t joints = 0;
+		uint32_t keyframes = 0;
+		std::vector<glm::mat4> matrices;
+	};
+
+	// Some weight files have more entries than the mesh has vertices, the extra ones are ignored
+	void loadWeights(const std::string& file, std::vector<Vertex>& vertices) {
+		Reader in(file);
+		const size_t count = std::min(in.readCount(4 * (sizeof(int) + sizeof(float))), vertices.size());
+		for (size_t k = 0; k < count; k++) {
+			for (int i = 0; i < 4; i++) {
+				vertices[k].controllers[i] = in.read<int>();
+				vertices[k].influences[i] = in.read<float>();
+			}
+		}
+	}
+
+	// Missing or broken skeleton files leave the animation slot empty
+	void loadSkeleton(const std::string& file, Skeleton (&skeletons)[BakedMesh::MAX_ANIMATIONS]) {
+		Reader in(file);
+		const int index = in.read<int>();
+		const int keyframes = in.read<int>();
+		const int joints = in.read<int>();
+		if (!in.ok || index < 0 || (size_t)index >= BakedMesh::MAX_ANIMATIONS || keyframes <= 0 || joints <= 0)
+			return;
+		if ((size_t)joints * keyframes * sizeof(glm::mat4) * 2 > in.data.size())
+			return;
+
+		// Only the joints of the first skeleton file for an animation slot are used
+		Skeleton& skeleton = skeletons[index];
+		if (skeleton.joints)
+			return;
+		Skeleton loaded;
+		loaded.joints = joints;
+		loaded.keyframes = keyframes;
+		loaded.matrices.resize((size_t)joints * keyframes);
+
+		for (int joint = 0; joint < joints; joint++) {
+			in.readString(); // Joint name
+			in.skip(sizeof(glm::mat4)); // Global bind pose
+			for (int keyframe = 0; keyframe < keyframes; keyframe++) {
+				// Only the finished transform is used when rendering, the local one before it is skipped
+				in.skip(sizeof(glm::mat4));
+				glm::vec4 columns[4];
+				in.read(columns, sizeof(columns));
+				loaded.matrices[(size_t)joint * keyframes + keyframe] = glm::mat4(columns[0], columns[1], columns[2], columns[3]);
+			}
+		}
+		if (in.ok)
+			skeleton = std::move(loaded);
+	}
+
+	void align(std::vector<uint8_t>& out) {
+		out.resize((out.size() + BakedMesh::ALIGNMENT - 1) & ~(BakedMesh::ALIGNMENT - 1), 0);
+	}
+
+	uint64_t append(std::vector<uint8_t>& out, const void* data, size_t size) {
+		align(out);
+		const uint64_t offset = out.size();
+		out.insert(out.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+		return offset;
+	}
+
+	bool inBounds(const BakedMesh::Header* header, uint64_t offset, uint64_t size) {
+		return offset % BakedMesh::ALIGNMENT == 0 && offset <= header->fileSize && size <= header->fileSize - offset;
+	}
+}
+
+std::string BakedMesh::bakedPath(const std::string& file) {
+	const size_t dot = file.find_last_of('.');
+	if (dot == std::string::npos || dot + 1 == file.size() || file.find('/', dot) != std::string::npos)
+		return file + ".bATTIC";
+	return file.substr(0, dot + 1) + "b" + file.substr(dot + 2);
+}
+
+// Mirrors what GLMesh used to do when it read the .mATTIC directly. The vertices and indices of all the meshes in
+// the file are merged, and the material and the animation flag of the last mesh are used.
+bool BakedMesh::bake(const std::string& file, std::vector<uint8_t>& out) {
+	static const std::string characterPath = "assets/objects/characters/";
+	std::vector<SourceFile> sources{file};
+	Reader in(file);
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	std::string textures[TEXTURE_COUNT];
+	bool hasAnimation = false;
+	Skeleton skeletons[MAX_ANIMATIONS];
+
+	const size_t meshes = in.readCount(1);
+	for (size_t mesh = 0; mesh < meshes && in.ok; mesh++) {
+		const std::string name = in.readString();
+
+		const size_t controlPoints = in.readCount(sizeof(glm::vec3) * 3 + sizeof(glm::vec2));
+		vertices.reserve(vertices.size() + controlPoints);
+		for (size_t k = 0; k < controlPoints; k++) {
+			Vertex vertex = {};
+			vertex.position = in.read<glm::vec3>();
+			vertex.normal = in.read<glm::vec3>();
+			vertex.tangent = in.read<glm::vec3>();
+			vertex.uv = in.read<glm::vec2>();
+			vertices.push_back(vertex);
+		}
+
+		const size_t primitives = in.readCount(sizeof(int) * 3);
+		indices.reserve(indices.size() + primitives * 3);
+		for (size_t i = 0; i < primitives * 3; i++)
+			indices.push_back(in.read<int>());
+
+		std::string diffuse = in.readString();
+		// If a psd file accidentally was used, take the png file instead
+		if (diffuse.size() >= 2 && diffuse.back() == 'd')
+			diffuse.replace(diffuse.size() - 2, 2, "ng");
+		if (name == "AlienBossModel")
+			textures[Texture::diffuse] = "assets/textures/AlienBossTexture.png";
+		else if (!diffuse.empty() && diffuse != "NULL")
+			textures[Texture::diffuse] = "assets/textures/" + diffuse;
+		else
+			textures[Texture::diffuse] = "assets/textures/Floor_specular.png";
+		textures[Texture::specular] = "assets/textures/1x1Gray.png";
+
+		const glm::vec3 color = in.read<glm::vec3>();
+		in.read<float>(); // Specular
+
+		const std::string normal = in.readString();
+		if (normal.size() >= 2 && normal[0] == 'D' && normal[1] == ':')
+			textures[Texture::normal] = "assets/textures/normals/LowPolyArmNormalMap.png";
+		else if (!normal.empty() && normal != "NULL")
+			textures[Texture::normal] = "assets/textures/normals/" + normal;
+		else
+			textures[Texture::normal] = "assets/textures/normals/1x1ErrorNormal.png";
+
+		const std::string glow = in.readString();
+		if (!glow.empty() && glow != "NULL")
+			textures[Texture::glow] = "assets/textures/glow/" + glow;
+		else
+			textures[Texture::glow] = "assets/textures/glow/errorGlow.png";
+
+		for (Vertex& vertex : vertices)
+			vertex.color = color;
+
+		// Some files end inside the transform, they are treated as not animated
+		if (mesh + 1 == meshes && in.data.size() - in.pos < sizeof(glm::vec3) * 3 + sizeof(bool)) {
+			hasAnimation = false;
+			break;
+		}
+		in.skip(sizeof(glm::vec3) * 3); // Position, rotation and scale
+		hasAnimation = in.read<bool>();
+		if (!hasAnimation)
+			continue;
+
+		const size_t animationFiles = in.readCount(sizeof(int));
+		sources.emplace_back(characterPath + in.readString() + ".wATTIC");
+		loadWeights(sources.back().path, vertices);
+		for (size_t i = 0; i < animationFiles && in.ok; i++) {
+			sources.emplace_back(characterPath + in.readString() + ".sATTIC");
+			loadSkeleton(sources.back().path, skeletons);
+		}
+	}
+	if (!in.ok)
+		return false;
+
+	Header header = {};
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.vertexSize = sizeof(Vertex);
+	header.hasAnimation = hasAnimation;
+	header.vertexCount = vertices.size();
+	header.indexCount = indices.size();
+
+	Animation animations[MAX_ANIMATIONS] = {};
+	out.clear();
+	out.resize(sizeof(Header));
+	header.vertexOffset = append(out, vertices.data(), vertices.size() * sizeof(Vertex));
+	header.indexOffset = append(out, indices.data(), indices.size() * sizeof(uint32_t));
+	for (size_t i = 0; i < TEXTURE_COUNT; i++)
+		header.textureOffset[i] = append(out, textures[i].c_str(), textures[i].size() + 1);
+	for (size_t i = 0; i < MAX_ANIMATIONS; i++) {
+		animations[i].joints = skeletons[i].joints;
+		animations[i].keyframes = skeletons[i].keyframes;
+		animations[i].matrixOffset = append(out, skeletons[i].matrices.data(), skeletons[i].matrices.size() * sizeof(glm::mat4));
+	}
+	header.animationOffset = append(out, animations, sizeof(animations));
+	std::vector<Source> sourceHeaders(sources.size());
+	for (size_t i = 0; i < sources.size(); i++) {
+		sourceHeaders[i].size = sources[i].size;
+		sourceHeaders[i].modified = sources[i].modified;
+		sourceHeaders[i].pathOffset = append(out, sources[i].path.c_str(), sources[i].path.size() + 1);
+	}
+	header.sourceCount = sources.size();
+	header.sourceOffset = append(out, sourceHeaders.data(), sourceHeaders.size() * sizeof(Source));
+	align(out);
+	header.fileSize = out.size();
+	memcpy(out.data(), &header, sizeof(header));
+	return true;
+}
+
+bool BakedMesh::parse(const uint8_t* data, size_t size, View& view) {
+	if (size < sizeof(Header) || (uintptr_t)data % 16)
+		return false;
+	const Header* header = (const Header*)data;
+	if (header->magic != MAGIC || header->version != VERSION || header->fileSize != size || header->vertexSize != sizeof(Vertex))
+		return false;
+	if (!inBounds(header, header->vertexOffset, (uint64_t)header->vertexCount * sizeof(Vertex)) ||
+		!inBounds(header, header->indexOffset, (uint64_t)header->indexCount * sizeof(uint32_t)) ||
+		!inBounds(header, header->animationOffset, sizeof(Animation) * MAX_ANIMATIONS) ||
+		header->sourceCount > header->fileSize / sizeof(Source) || !inBounds(header, header->sourceOffset, header->sourceCount * sizeof(Source)))
+		return false;
+
+	view.header = header;
+	view.vertices = (const Vertex*)(data + header->vertexOffset);
+	view.indices = (const uint32_t*)(data + header->indexOffset);
+	for (size_t i = 0; i < TEXTURE_COUNT; i++) {
+		const uint64_t offset = header->textureOffset[i];
+		if (!inBounds(header, offset, 1) || !memchr(data + offset, '\0', size - offset))
+			return false;
+		view.textures[i] = (const char*)(data + offset);
+	}
+
+	view.animations = (const Animation*)(data + header->animationOffset);
+	for (size_t i = 0; i < MAX_ANIMATIONS; i++) {
+		const Animation& animation = view.animations[i];
+		if (!inBounds(header, animation.matrixOffset, (uint64_t)animation.joints * animation.keyframes * sizeof(glm::mat4)))
+			return false;
+		if (animation.joints && !animation.keyframes)
+			return false;
+		view.matrices[i] = (const glm::mat4*)(data + animation.matrixOffset);
+	}
+
+	view.sources = (const Source*)(data + header->sourceOffset);
+	for (size_t i = 0; i < header->sourceCount; i++) {
+		const uint64_t offset = view.sources[i].pathOffset;
+		if (!inBounds(header, offset, 1) || !memchr(data + offset, '\0', size - offset))
+			return false;
+	}
+	return true;
+}
+
+bool BakedMesh::isCurrent(const View& view) {
+	if (!view.header || !view.header->sourceCount)
+		return false;
+	for (size_t i = 0; i < view.header->sourceCount; i++) {
+		const Source& source = view.sources[i];
+		uint64_t size;
+		int64_t modified;
+		if (!Ext::MappedFile::fileStamp((const char*)view.header + source.pathOffset, size, modified)) {
+			size = UINT64_MAX;
+			modified = 0;
+		}
+		if (size != source.size || modified != source.modified)
+			return false;
+	}
+	return true;
+}
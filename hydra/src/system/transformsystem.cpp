@@ -0,0 +1,98 @@
+#include <hydra/system/transformsystem.hpp>
+
+#include <algorithm>
+#include <imgui/imgui.h>
+
+using namespace Hydra::System;
+using Hydra::Component::TransformComponent;
+
+TransformSystem::TransformSystem() {}
+TransformSystem::~TransformSystem() {}
+
+void TransformSystem::tick(float /*delta*/) {
+	if (_version != _transforms.getVersion())
+		_sort();
+
+	// Same check as TransformComponent::_recalculateMatrix, but the parent has already been updated
+	_updated = 0;
+	for (size_t i = 0; i < _order.size(); i++) {
+		TransformComponent* t = _order[i];
+		TransformComponent* p = _parents[i] == SIZE_MAX || t->ignoreParent ? nullptr : _order[_parents[i]];
+		if (!t->dirty && !(p && p->updateCounter != t->parentUpdateCounter))
+			continue;
+		t->updateCounter++;
+		t->dirty = false;
+		if (p) {
+			t->parentUpdateCounter = p->updateCounter;
+			t->_matrix = p->_matrix * t->_localMatrix();
+		} else
+			t->_matrix = t->_localMatrix();
+		_updated++;
+	}
+}
+
+Hydra::World::SystemAccess TransformSystem::access() const {
+	Hydra::World::SystemAccess access;
+	access.writes = Hydra::Component::ComponentBits::Transform;
+	return access;
+}
+
+void TransformSystem::registerUI() {
+	ImGui::Text("%zu transforms, %zu updated", _order.size(), _updated);
+}
+
+void TransformSystem::_sort() {
+	const auto& entities = _transforms.getEntities();
+	const size_t count = entities.size();
+	_version = _transforms.getVersion();
+
+	_index.clear();
+	for (size_t i = 0; i < count; i++)
+		_index[entities[i]->id] = i;
+
+	// _parents is indexed like entities until the end
+	_parents.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		auto it = _index.find(entities[i]->parent);
+		_parents[i] = it != _index.end() ? it->second : SIZE_MAX;
+	}
+
+	// Walks up until it finds a parent with a known depth, then fills in the depths on the way back down
+	size_t maxDepth = 0;
+	_depth.assign(count, SIZE_MAX);
+	_start.clear();
+	for (size_t i = 0; i < count; i++) {
+		size_t top = i;
+		while (_depth[top] == SIZE_MAX && _parents[top] != SIZE_MAX) {
+			_start.push_back(top);
+			top = _parents[top];
+		}
+		if (_depth[top] == SIZE_MAX)
+			_depth[top] = 0;
+		for (size_t depth = _depth[top] + 1; !_start.empty(); depth++) {
+			_depth[_start.back()] = depth;
+			maxDepth = std::max(maxDepth, depth);
+			_start.pop_back();
+		}
+	}
+
+	// Counting sort on the depth, _start ends up as the first index for each depth
+	_start.assign(maxDepth + 2, 0);
+	for (size_t i = 0; i < count; i++)
+		_start[_depth[i] + 1]++;
+	for (size_t depth = 1; depth < _start.size(); depth++)
+		_start[depth] += _start[depth - 1];
+
+	// _depth is reused for the position of every entity in _order
+	_order.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		const size_t pos = _start[_depth[i]]++;
+		_order[pos] = entities[i]->getComponent<TransformComponent>().get();
+		_depth[i] = pos;
+	}
+
+	std::vector<size_t> parents(count);
+	for (size_t i = 0; i < count; i++)
+		parents[_depth[i]] = _parents[i] != SIZE_MAX ? _depth[_parents[i]] : SIZE_MAX;
+	_parents.swap(parents);
+}
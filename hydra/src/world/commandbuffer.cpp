@@ -0,0 +1,125 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * Entity changes that are recorded while systems tick and applied later, at a point where nothing else touches World.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#include <hydra/world/commandbuffer.hpp>
+
+#include <memory>
+#include <mutex>
+
+using namespace Hydra::World;
+
+namespace {
+	// The buffers outlive their threads, so that the commands of a worker that quit before the next apply are not lost.
+	// A free buffer is given to the next thread that needs one.
+	struct Registry {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<CommandBuffer>> buffers;
+		std::vector<CommandBuffer*> free;
+	};
+
+	Registry& registry() {
+		static Registry registry;
+		return registry;
+	}
+
+	struct Slot {
+		CommandBuffer* buffer = nullptr;
+
+		~Slot() {
+			if (!buffer)
+				return;
+			Registry& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			r.free.push_back(buffer);
+		}
+	};
+
+	thread_local Slot slot;
+}
+
+void CommandBuffer::spawn(const std::string& name, EntityID parent, std::function<void(const std::shared_ptr<Entity>&)> init) {
+	_commands.push_back(Command{Type::spawn, parent, name, std::move(init), nullptr});
+}
+
+void CommandBuffer::destroy(EntityID entity) {
+	_commands.push_back(Command{Type::destroy, entity, std::string(), nullptr, nullptr});
+}
+
+void CommandBuffer::defer(std::function<void()> function) {
+	_commands.push_back(Command{Type::call, World::invalidID, std::string(), nullptr, std::move(function)});
+}
+
+void CommandBuffer::apply() {
+	_applying.swap(_commands);
+	for (Command& command : _applying) {
+		switch (command.type) {
+		case Type::spawn:
+			// The parent may have been removed since the spawn was recorded
+			if (command.entity == World::invalidID || World::getEntity(command.entity)) {
+				auto entity = World::newEntity(command.name, command.entity);
+				if (command.init)
+					command.init(entity);
+			}
+			break;
+		case Type::destroy:
+			if (auto entity = World::getEntity(command.entity))
+				entity->kill();
+			break;
+		case Type::addComponent:
+			if (auto entity = World::getEntity(command.entity))
+				command.init(entity);
+			break;
+		case Type::call:
+			command.function();
+			break;
+		}
+	}
+	// Keeps the capacity, so recording doesn't allocate once the buffers have grown
+	_applying.clear();
+}
+
+void CommandBuffer::clear() {
+	_commands.clear();
+}
+
+CommandBuffer& World::commands() {
+	if (slot.buffer)
+		return *slot.buffer;
+
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	if (!r.free.empty()) {
+		slot.buffer = r.free.back();
+		r.free.pop_back();
+	} else {
+		r.buffers.push_back(std::make_unique<CommandBuffer>());
+		slot.buffer = r.buffers.back().get();
+	}
+	return *slot.buffer;
+}
+
+void World::applyCommands() {
+	// Not holding the lock while applying, the commands may record new ones
+	std::vector<CommandBuffer*> buffers;
+	{
+		Registry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		for (auto& buffer : r.buffers)
+			buffers.push_back(buffer.get());
+	}
+	for (CommandBuffer* buffer : buffers)
+		buffer->apply();
+}
+
+void World::_discardCommands() {
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	for (auto& buffer : r.buffers)
+		buffer->clear();
+}
@@ -0,0 +1,192 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * Ticks systems on a pool of worker threads.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#include <hydra/world/jobgraph.hpp>
+#include <hydra/world/commandbuffer.hpp>
+
+#include <algorithm>
+#include <imgui/imgui.h>
+
+using namespace Hydra::World;
+
+JobGraph::JobGraph(size_t threads) {
+	if (threads == SIZE_MAX)
+		threads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+	for (size_t i = 0; i < threads; i++)
+		_workers.emplace_back(&JobGraph::_worker, this);
+}
+
+JobGraph::~JobGraph() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_cv.notify_all();
+	for (auto& worker : _workers)
+		worker.join();
+}
+
+void JobGraph::add(ISystem* system) {
+	_systems.push_back(system);
+}
+
+void JobGraph::clear() {
+	_systems.clear();
+	_jobs.clear();
+	_timings.clear();
+}
+
+void JobGraph::run(float delta) {
+	_build();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_delta = delta;
+	_done = 0;
+	_ready.clear();
+	for (size_t i = 0; i < _jobs.size(); i++)
+		if (!_jobs[i].remaining)
+			_ready.push_back(i);
+	_start = std::chrono::high_resolution_clock::now();
+	_cv.notify_all();
+
+	// This thread helps out, and it is the only one that takes the mainThread systems
+	while (_done < _jobs.size()) {
+		size_t job;
+		if (_pop(true, job))
+			_execute(job, lock);
+		else
+			_cv.wait(lock);
+	}
+	lock.unlock();
+
+	// Nothing is ticking, so this is the sync point for the entities that the systems spawned and destroyed
+	World::applyCommands();
+	_time = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - _start).count();
+
+	// The jobs are in the order they were added and only depend on earlier ones
+	for (size_t i = 0; i < _jobs.size(); i++) {
+		Timing& timing = _timings[i];
+		timing.pathTime = timing.time;
+		timing.pathPrevious = SIZE_MAX;
+		for (size_t dependency : _jobs[i].dependencies) {
+			if (_timings[dependency].pathTime + timing.time > timing.pathTime) {
+				timing.pathTime = _timings[dependency].pathTime + timing.time;
+				timing.pathPrevious = dependency;
+			}
+		}
+	}
+}
+
+std::vector<ISystem*> JobGraph::getCriticalPath(float* time) const {
+	std::vector<ISystem*> path;
+	if (time)
+		*time = 0;
+	if (_timings.empty())
+		return path;
+
+	auto last = std::max_element(_timings.begin(), _timings.end(), [](const Timing& a, const Timing& b) { return a.pathTime < b.pathTime; });
+	if (time)
+		*time = last->pathTime;
+	for (size_t i = last - _timings.begin(); i != SIZE_MAX; i = _timings[i].pathPrevious)
+		path.push_back(_timings[i].system);
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+void JobGraph::registerUI() {
+	float criticalTime;
+	const std::vector<ISystem*> path = getCriticalPath(&criticalTime);
+	float total = 0;
+	for (const Timing& timing : _timings)
+		total += timing.time;
+
+	ImGui::Text("%zu threads, %.2f ms (%.2f ms of work, %.2f ms critical path)", getThreadCount(), _time, total, criticalTime);
+	ImGui::Columns(3);
+	ImGui::Text("System");
+	ImGui::NextColumn();
+	ImGui::Text("Start");
+	ImGui::NextColumn();
+	ImGui::Text("Time");
+	ImGui::NextColumn();
+	for (const Timing& timing : _timings) {
+		const bool critical = std::find(path.begin(), path.end(), timing.system) != path.end();
+		const ImVec4 color = critical ? ImVec4(1, 0.6f, 0.2f, 1) : ImVec4(1, 1, 1, 1);
+		ImGui::TextColored(color, "%s", timing.system->type().c_str());
+		ImGui::NextColumn();
+		ImGui::TextColored(color, "%.2f ms", timing.start);
+		ImGui::NextColumn();
+		ImGui::TextColored(color, "%.2f ms", timing.time);
+		ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+}
+
+void JobGraph::_build() {
+	_jobs.resize(_systems.size());
+	_timings.resize(_systems.size());
+	for (size_t i = 0; i < _systems.size(); i++) {
+		Job& job = _jobs[i];
+		job.system = _systems[i];
+		job.access = _systems[i]->access();
+		job.dependents.clear();
+		job.dependencies.clear();
+		job.remaining = 0;
+		_timings[i] = Timing{_systems[i], 0, 0, 0, SIZE_MAX};
+
+		for (size_t j = 0; j < i; j++) {
+			if (!job.access.conflicts(_jobs[j].access))
+				continue;
+			_jobs[j].dependents.push_back(i);
+			job.dependencies.push_back(j);
+			job.remaining++;
+		}
+	}
+}
+
+bool JobGraph::_pop(bool mainThread, size_t& job) {
+	// The main thread takes the mainThread systems first, so that the workers are not left waiting for them
+	auto it = _ready.end();
+	if (mainThread)
+		it = std::find_if(_ready.begin(), _ready.end(), [this](size_t i) { return _jobs[i].access.mainThread; });
+	if (it == _ready.end())
+		it = std::find_if(_ready.begin(), _ready.end(), [this, mainThread](size_t i) { return mainThread || !_jobs[i].access.mainThread; });
+	if (it == _ready.end())
+		return false;
+	job = *it;
+	_ready.erase(it);
+	return true;
+}
+
+void JobGraph::_execute(size_t job, std::unique_lock<std::mutex>& lock) {
+	const float delta = _delta;
+	lock.unlock();
+	const auto start = std::chrono::high_resolution_clock::now();
+	_jobs[job].system->tick(delta);
+	const auto end = std::chrono::high_resolution_clock::now();
+	lock.lock();
+
+	_timings[job].start = std::chrono::duration<float, std::milli>(start - _start).count();
+	_timings[job].time = std::chrono::duration<float, std::milli>(end - start).count();
+	for (size_t dependent : _jobs[job].dependents)
+		if (!--_jobs[dependent].remaining)
+			_ready.push_back(dependent);
+	_done++;
+	_cv.notify_all();
+}
+
+void JobGraph::_worker() {
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_quit) {
+		size_t job;
+		if (_pop(false, job))
+			_execute(job, lock);
+		else
+			_cv.wait(lock);
+	}
+}
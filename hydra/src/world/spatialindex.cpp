@@ -0,0 +1,206 @@
+/**
+ * A uniform grid of entity positions, for finding the entities that are close to a point.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#include <hydra/world/spatialindex.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <hydra/component/transformcomponent.hpp>
+
+using namespace Hydra::World;
+
+SpatialIndex::SpatialIndex(float cellSize) : _cellSize(cellSize), _invCellSize(1.0f / cellSize), _buckets(64, NONE) {
+	clear();
+}
+
+void SpatialIndex::set(EntityID id, const glm::vec3& position) {
+	auto it = _slots.find(id);
+	if (it == _slots.end()) {
+		_insert(id, position);
+		return;
+	}
+	Entry& entry = _entries[it->second];
+	entry.position = position;
+	const glm::ivec2 cell = _cellOf(position);
+	if (cell != entry.cell) {
+		_unlink(it->second);
+		entry.cell = cell;
+		_link(it->second);
+	}
+}
+
+void SpatialIndex::remove(EntityID id) {
+	auto it = _slots.find(id);
+	if (it == _slots.end())
+		return;
+	const uint32_t slot = it->second;
+	const uint32_t last = (uint32_t)_entries.size() - 1;
+	_slots.erase(it);
+	_unlink(slot);
+	if (slot != last) {
+		_unlink(last);
+		_entries[slot] = _entries[last];
+		_link(slot);
+		_slots[_entries[slot].id] = slot;
+		if (_transforms.size() == _entries.size())
+			_transforms[slot] = _transforms[last];
+	}
+	_entries.pop_back();
+	if (_transforms.size() > _entries.size())
+		_transforms.pop_back();
+}
+
+void SpatialIndex::clear() {
+	_entries.clear();
+	_slots.clear();
+	std::fill(_buckets.begin(), _buckets.end(), NONE);
+	_minCell = glm::ivec2(INT_MAX);
+	_maxCell = glm::ivec2(INT_MIN);
+	_query = nullptr;
+	_transforms.clear();
+}
+
+void SpatialIndex::sync(const QueryBase& query) {
+	const auto& entities = query.getEntities();
+	if (_query != &query || _queryVersion != query.getVersion() || _transforms.size() != _entries.size()) {
+		clear();
+		_query = &query;
+		_queryVersion = query.getVersion();
+		for (const auto& entity : entities) {
+			auto transform = entity->getComponent<Hydra::Component::TransformComponent>();
+			if (!transform)
+				continue;
+			_insert(entity->id, transform->position);
+			_transforms.push_back(transform.get());
+		}
+		return;
+	}
+
+	for (uint32_t slot = 0; slot < _entries.size(); slot++) {
+		Entry& entry = _entries[slot];
+		entry.position = _transforms[slot]->position;
+		const glm::ivec2 cell = _cellOf(entry.position);
+		if (cell != entry.cell) {
+			_unlink(slot);
+			entry.cell = cell;
+			_link(slot);
+		}
+	}
+}
+
+// The cells are visited in square rings around the cell of position. No cell in ring r is closer than
+// (r - 1 + the distance from position to the closest edge of its own cell) cells, so the search stops when that is
+// further away than the k:th hit, or when the ring is outside of every cell that is in use.
+void SpatialIndex::nearest(const glm::vec3& position, size_t k, std::vector<Hit>& out, float maxDistance) const {
+	out.clear();
+	if (!k || _entries.empty())
+		return;
+
+	const glm::ivec2 center = _cellOf(position);
+	const glm::vec2 local = glm::vec2(position.x, position.z) * _invCellSize - glm::vec2(center);
+	const float edge = std::min(std::min(local.x, 1 - local.x), std::min(local.y, 1 - local.y));
+	int maxRing = std::max(std::max(center.x - _minCell.x, _maxCell.x - center.x), std::max(center.y - _minCell.y, _maxCell.y - center.y));
+	if (maxDistance * _invCellSize < (float)maxRing)
+		maxRing = (int)(maxDistance * _invCellSize) + 1;
+
+	auto visit = [&](const Entry& entry) {
+		const float distance = glm::distance(position, entry.position);
+		if (distance > maxDistance || (out.size() == k && distance >= out.back().distance))
+			return;
+		if (out.size() == k)
+			out.pop_back();
+		auto it = std::upper_bound(out.begin(), out.end(), distance, [](float d, const Hit& hit) { return d < hit.distance; });
+		out.insert(it, Hit{entry.id, entry.position, distance});
+	};
+	auto visitRow = [&](int z, int fromX, int toX) {
+		if (z < _minCell.y || z > _maxCell.y)
+			return;
+		for (int x = std::max(fromX, _minCell.x); x <= std::min(toX, _maxCell.x); x++)
+			_forEachInCell(glm::ivec2(x, z), visit);
+	};
+	auto visitColumn = [&](int x, int fromZ, int toZ) {
+		if (x < _minCell.x || x > _maxCell.x)
+			return;
+		for (int z = std::max(fromZ, _minCell.y); z <= std::min(toZ, _maxCell.y); z++)
+			_forEachInCell(glm::ivec2(x, z), visit);
+	};
+
+	for (int ring = 0; ring <= maxRing; ring++) {
+		if (!ring) {
+			visitRow(center.y, center.x, center.x);
+			continue;
+		}
+		const float closest = (ring - 1 + edge) * _cellSize;
+		if (closest > maxDistance || (out.size() == k && closest >= out.back().distance))
+			break;
+		visitRow(center.y - ring, center.x - ring, center.x + ring);
+		visitRow(center.y + ring, center.x - ring, center.x + ring);
+		visitColumn(center.x - ring, center.y - ring + 1, center.y + ring - 1);
+		visitColumn(center.x + ring, center.y - ring + 1, center.y + ring - 1);
+	}
+}
+
+EntityID SpatialIndex::nearest(const glm::vec3& position, float maxDistance) const {
+	static thread_local std::vector<Hit> hits;
+	nearest(position, 1, hits, maxDistance);
+	return hits.empty() ? World::invalidID : hits[0].id;
+}
+
+void SpatialIndex::queryRadius(const glm::vec3& position, float radius, std::vector<Hit>& out) const {
+	if (_entries.empty() || radius < 0)
+		return;
+	// Clamped before it is made into cells, so that a huge radius doesn't overflow
+	const glm::vec2 center = glm::vec2(position.x, position.z) * _invCellSize;
+	const glm::ivec2 from = glm::ivec2(glm::max(glm::floor(center - radius * _invCellSize), glm::vec2(_minCell)));
+	const glm::ivec2 to = glm::ivec2(glm::min(glm::floor(center + radius * _invCellSize), glm::vec2(_maxCell)));
+	for (int z = from.y; z <= to.y; z++)
+		for (int x = from.x; x <= to.x; x++)
+			_forEachInCell(glm::ivec2(x, z), [&](const Entry& entry) {
+				const float distance = glm::distance(position, entry.position);
+				if (distance <= radius)
+					out.push_back(Hit{entry.id, entry.position, distance});
+			});
+}
+
+void SpatialIndex::_link(uint32_t slot) {
+	Entry& entry = _entries[slot];
+	uint32_t& head = _buckets[_bucketOf(entry.cell)];
+	entry.previous = NONE;
+	entry.next = head;
+	if (head != NONE)
+		_entries[head].previous = slot;
+	head = slot;
+	_minCell = glm::min(_minCell, entry.cell);
+	_maxCell = glm::max(_maxCell, entry.cell);
+}
+
+void SpatialIndex::_unlink(uint32_t slot) {
+	Entry& entry = _entries[slot];
+	if (entry.previous != NONE)
+		_entries[entry.previous].next = entry.next;
+	else
+		_buckets[_bucketOf(entry.cell)] = entry.next;
+	if (entry.next != NONE)
+		_entries[entry.next].previous = entry.previous;
+}
+
+void SpatialIndex::_insert(EntityID id, const glm::vec3& position) {
+	const uint32_t slot = (uint32_t)_entries.size();
+	_entries.push_back(Entry{id, position, _cellOf(position), NONE, NONE});
+	_slots[id] = slot;
+	if (_entries.size() > _buckets.size())
+		_grow();
+	else
+		_link(slot);
+}
+
+// Keeps about one entry per bucket, the new entry is linked with the rest
+void SpatialIndex::_grow() {
+	_buckets.assign(_buckets.size() * 2, NONE);
+	for (uint32_t slot = 0; slot < _entries.size(); slot++)
+		_link(slot);
+}
@@ -0,0 +1,87 @@
+/**
+ * Splits a loop over a pool of worker threads.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#include <hydra/world/workerpool.hpp>
+
+#include <algorithm>
+
+using namespace Hydra::World;
+
+thread_local bool WorkerPool::_inside = false;
+
+WorkerPool::WorkerPool(size_t threads) {
+	if (threads == SIZE_MAX)
+		threads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+	for (size_t i = 0; i < threads; i++)
+		_workers.emplace_back(&WorkerPool::_worker, this, _generation);
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_cv.notify_all();
+	for (auto& worker : _workers)
+		worker.join();
+}
+
+WorkerPool& WorkerPool::instance() {
+	static WorkerPool pool;
+	return pool;
+}
+
+void WorkerPool::_run(size_t begin, size_t end, size_t grainSize, Chunk_f chunk, void* body) {
+	if (begin >= end)
+		return;
+	grainSize = std::max(grainSize, (size_t)1);
+	// Nested calls and small loops aren't worth waking the workers for
+	if (_inside || _workers.empty() || end - begin <= grainSize) {
+		chunk(body, begin, end);
+		return;
+	}
+
+	std::lock_guard<std::mutex> call(_callMutex);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_chunk = chunk;
+		_body = body;
+		_next = begin;
+		_end = end;
+		_grainSize = grainSize;
+		_running = _workers.size();
+		_generation++;
+	}
+	_cv.notify_all();
+	_runChunks();
+	std::unique_lock<std::mutex> lock(_mutex);
+	_doneCv.wait(lock, [this] { return !_running; });
+	_chunk = nullptr;
+	_body = nullptr;
+}
+
+void WorkerPool::_runChunks() {
+	_inside = true;
+	for (size_t begin = _next.fetch_add(_grainSize); begin < _end; begin = _next.fetch_add(_grainSize))
+		_chunk(_body, begin, std::min(begin + _grainSize, _end));
+	_inside = false;
+}
+
+void WorkerPool::_worker(size_t generation) {
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_cv.wait(lock, [&] { return _quit || _generation != generation; });
+		if (_quit)
+			return;
+		generation = _generation;
+		lock.unlock();
+		_runChunks();
+		lock.lock();
+		if (!--_running)
+			_doneCv.notify_one();
+	}
+}
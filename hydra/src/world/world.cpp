@@ -29,9 +29,16 @@ IComponentHandler* IComponent<T, bit>::componentHandler;
 template <typename T, Hydra::Component::ComponentBits bit>
 IComponent<T, bit>::~IComponent() {}
 
-std::unordered_map<EntityID, size_t> World::_map;
+// Defined before _entities and _map, so they outlive them
+Hydra::Ext::ChunkStorage World::_entityStorage;
+Hydra::Ext::ChunkStorage World::_mapStorage;
+ChunkMap<EntityID, size_t> World::_map(Hydra::Ext::ChunkAllocator<EntityID>(&World::_mapStorage));
 std::vector<std::shared_ptr<Entity>> World::_entities;
+std::vector<Archetype> World::_archetypes;
+std::unordered_map<uint64_t, size_t> World::_archetypeMap;
+std::vector<QueryBase*> World::_queries;
 EntityID World::_idCounter = 1;
+std::vector<EntityID> World::_dead;
 bool World::_isResetting = false;
 
 namespace {
@@ -86,19 +93,54 @@ namespace {
 			SerializeComponents<Hydra::Ext::TypeTuple<Args...>>::apply(this_, json);
 		}
 	};
+
+	AllocationStats allocationStats(const std::string& name, const Hydra::Ext::ChunkStorage& storage) {
+		return AllocationStats{name, storage.stats(), storage.blockSize(), storage.chunkCount(), storage.blocksPerChunk()};
+	}
+
+	template <typename... Args>
+	struct GetAllocationStats;
+
+	template <>
+	struct GetAllocationStats<Hydra::Ext::TypeTuple<>> {
+		static void apply(std::vector<AllocationStats>&) {}
+	};
+
+	template <typename T, typename... Args>
+	struct GetAllocationStats<Hydra::Ext::TypeTuple<T, Args...>> {
+		static void apply(std::vector<AllocationStats>& output) {
+			// Component types from libraries that are not loaded don't have a handler
+			if (IComponentHandler* handler = T::componentHandler)
+				output.push_back(allocationStats(handler->getName(), handler->getStorage()));
+			GetAllocationStats<Hydra::Ext::TypeTuple<Args...>>::apply(output);
+		}
+	};
 }
 
+// The parent and the children are taken care of by World::_removeEntities
 Entity::~Entity() {
-	if (!World::_isResetting) {
-		if (parent != World::invalidID)
-			if (auto p = World::getEntity(parent); p)
-				p->children.erase(std::remove(p->children.begin(), p->children.end(), id), p->children.end());
+	RemoveComponents<ComponentTypes>::apply(*this);
+}
 
-		for (EntityID child : children)
-			World::removeEntity(child);
-	}
+void Entity::kill() {
+	if (dead)
+		return;
+	dead = true;
+	World::_dead.push_back(id);
+}
 
-	RemoveComponents<ComponentTypes>::apply(*this);
+void Entity::setActiveComponents(ComponentBits bits) {
+	if (bits == activeComponents)
+		return;
+	const ComponentBits oldBits = activeComponents;
+	activeComponents = bits;
+	if (archetype == SIZE_MAX)
+		return;
+
+	// The entity has already been added to the world, move it over to its new archetype
+	size_t newArchetype = World::_getArchetype(bits);
+	World::_addToArchetype(World::_removeFromArchetype(*this), newArchetype);
+	World::_updateQueries(World::_archetypes[archetype].entities[archetypeSlot], oldBits, bits);
 }
 
 void Entity::serialize(nlohmann::json& json) const {
@@ -144,51 +186,199 @@ void Entity::deserialize(nlohmann::json& json) {
 
 
 void World::reset() {
-	// Update barcode/src/main.cpp when changing here
-	_isResetting = true;
-	_entities.clear();
-	_map.clear();
+	_discardCommands();
+	clear();
 	_isResetting = false;
 	_idCounter = rootID;
 	newEntity("World Root", invalidID);
 }
 
+// Leaves _isResetting set, so the components that are destroyed after this don't look for their entities
+void World::clear() {
+	_isResetting = true;
+	_dead.clear();
+	_entities.clear();
+	_map.clear();
+	_archetypes.clear();
+	_archetypeMap.clear();
+	for (QueryBase* query : _queries)
+		query->_clear();
+}
+
 std::shared_ptr<Entity> World::newEntity(const std::string& name, EntityID parent) {
 	EntityID id = _idCounter++;
-	std::shared_ptr<Entity> e = std::make_shared<Entity>();
+	std::shared_ptr<Entity> e = std::allocate_shared<Entity>(Hydra::Ext::ChunkAllocator<Entity>(&_entityStorage));
 	e->id = id;
 	e->name = name;
 	e->parent = parent;
-	if (parent != invalidID)
-		getEntity(parent)->children.push_back(id);
+	if (parent != invalidID) {
+		auto& siblings = getEntity(parent)->children;
+		e->childSlot = siblings.size();
+		siblings.push_back(id);
+	}
 
+	_addToArchetype(e, _getArchetype(e->activeComponents));
 	_entities.emplace_back(std::move(e));
 	_map[id] = _entities.size() - 1;
 	return _entities.back();
 }
 
 void World::removeEntity(EntityID entityID) {
-	if (_isResetting)
+	std::vector<EntityID> entities{entityID};
+	_removeEntities(entities);
+}
+
+void World::removeDeadEntities() {
+	if (_dead.empty())
 		return;
+	// Component destructors may kill more entities, those are removed next time
+	std::vector<EntityID> dead;
+	dead.swap(_dead);
+	_removeEntities(dead);
+	dead.clear();
+	if (_dead.empty())
+		_dead.swap(dead); // Keep the capacity
+}
 
-	if (auto e = getEntity(entityID); e) {
-		for (auto& el : e->children)
-			if (auto ent = getEntity(el); ent)
-				ent->parent = invalidID;
-	} else
+// Costs a few map lookups per removed entity, and doesn't depend on how many entities there are left
+void World::_removeEntities(std::vector<EntityID>& entities) {
+	if (_isResetting)
 		return;
 
-	const size_t pos = _map[entityID];
-	auto& e = _entities[pos];
-	if (!e.get() || e->id != _entities.back()->id) {
-		_map[_entities.back()->id] = pos;
-		e.swap(_entities.back());
+	// Holds on to the entities, so that they are destroyed after World is done with them
+	std::vector<std::shared_ptr<Entity>> removed;
+	std::vector<size_t> slots;
+	// The children are appended while walking the list, so the whole subtree is removed without recursion
+	for (size_t i = 0; i < entities.size(); i++) {
+		auto it = _map.find(entities[i]);
+		if (it == _map.end())
+			continue;
+		auto& e = _entities[it->second];
+		// Already found through its parent or listed twice
+		if (e->archetype == SIZE_MAX)
+			continue;
+		entities.insert(entities.end(), e->children.begin(), e->children.end());
+		_updateQueries(e, e->activeComponents, ComponentBits());
+		_removeFromArchetype(*e);
+		slots.push_back(it->second);
+		removed.push_back(e);
+	}
+
+	// Detach from the parents that are left. The root has most entities as its children, so this can't search for them.
+	for (auto& e : removed) {
+		auto parent = e->parent != invalidID ? getEntity(e->parent) : std::shared_ptr<Entity>();
+		if (!parent || parent->archetype == SIZE_MAX)
+			continue;
+		auto& siblings = parent->children;
+		if (e->childSlot != siblings.size() - 1) {
+			siblings[e->childSlot] = siblings.back();
+			getEntity(siblings[e->childSlot])->childSlot = e->childSlot;
+		}
+		siblings.pop_back();
+	}
+
+	// Swap remove from the back, so that the entity that is moved into a slot is never one that is being removed
+	std::sort(slots.begin(), slots.end(), std::greater<size_t>());
+	for (size_t slot : slots) {
+		_map.erase(_entities[slot]->id);
+		if (slot != _entities.size() - 1) {
+			_entities[slot] = std::move(_entities.back());
+			_map[_entities[slot]->id] = slot;
+		}
+		_entities.pop_back();
+	}
+
+	for (auto& e : removed) {
+		e->parent = invalidID;
+		e->children.clear();
+	}
+}
+
+void World::getAllocationStats(std::vector<AllocationStats>& output) {
+	output.clear();
+	output.push_back(allocationStats("Entity", _entityStorage));
+	GetAllocationStats<ComponentTypes>::apply(output);
+}
+
+size_t World::_getArchetype(ComponentBits bits) {
+	auto it = _archetypeMap.find(static_cast<uint64_t>(bits));
+	if (it != _archetypeMap.end())
+		return it->second;
+
+	_archetypes.push_back(Archetype{bits, {}});
+	_archetypeMap[static_cast<uint64_t>(bits)] = _archetypes.size() - 1;
+	return _archetypes.size() - 1;
+}
+
+void World::_addToArchetype(std::shared_ptr<Entity> entity, size_t archetype) {
+	auto& entities = _archetypes[archetype].entities;
+	entity->archetype = archetype;
+	entity->archetypeSlot = entities.size();
+	entities.push_back(std::move(entity));
+}
+
+std::shared_ptr<Entity> World::_removeFromArchetype(Entity& entity) {
+	if (entity.archetype == SIZE_MAX)
+		return std::shared_ptr<Entity>();
+
+	auto& entities = _archetypes[entity.archetype].entities;
+	std::shared_ptr<Entity> self = std::move(entities[entity.archetypeSlot]);
+	if (entity.archetypeSlot != entities.size() - 1) {
+		entities[entity.archetypeSlot] = std::move(entities.back());
+		entities[entity.archetypeSlot]->archetypeSlot = entity.archetypeSlot;
+	}
+	entities.pop_back();
+	entity.archetype = SIZE_MAX;
+	return self;
+}
+
+void World::_updateQueries(const std::shared_ptr<Entity>& entity, ComponentBits oldBits, ComponentBits newBits) {
+	for (QueryBase* query : _queries) {
+		const bool before = query->matches(oldBits);
+		const bool after = query->matches(newBits);
+		if (before && !after)
+			query->_remove(entity->id);
+		else if (!before && after)
+			query->_add(entity);
+	}
+}
+
+QueryBase::QueryBase(ComponentBits bits) : bits(bits), _slots(Hydra::Ext::ChunkAllocator<EntityID>(&_slotStorage)) {
+	World::_queries.push_back(this);
+	for (auto& archetype : World::_archetypes)
+		if (matches(archetype.bits))
+			for (auto& entity : archetype.entities)
+				_add(entity);
+}
+
+QueryBase::~QueryBase() {
+	World::_queries.erase(std::remove(World::_queries.begin(), World::_queries.end(), this), World::_queries.end());
+}
+
+void QueryBase::_add(const std::shared_ptr<Entity>& entity) {
+	_slots[entity->id] = _entities.size();
+	_entities.push_back(entity);
+	_version++;
+}
+
+void QueryBase::_remove(EntityID entityID) {
+	auto it = _slots.find(entityID);
+	if (it == _slots.end())
+		return;
+	const size_t pos = it->second;
+	if (pos != _entities.size() - 1) {
+		_entities[pos] = std::move(_entities.back());
+		_slots[_entities[pos]->id] = pos;
 	}
-	auto entity = _entities.back();
-	_map.erase(entityID);
 	_entities.pop_back();
+	_slots.erase(it);
+	_version++;
+}
 
-	entity.reset();
+void QueryBase::_clear() {
+	_entities.clear();
+	_slots.clear();
+	_version++;
 }
 
 void Blueprint::spawn(std::shared_ptr<Entity>& root) {
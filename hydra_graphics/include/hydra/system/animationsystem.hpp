@@ -10,6 +10,7 @@ namespace Hydra::System {
 		~AnimationSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		inline const std::string type() const final { return "AnimationSystem"; }
 		void registerUI() final;
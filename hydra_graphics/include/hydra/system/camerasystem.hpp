@@ -16,6 +16,7 @@ namespace Hydra::System {
 		~CameraSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		void setCamInternals(Hydra::Component::CameraComponent& cc);
 		void setCamDef(const glm::vec3& cPos, const glm::vec3& cDir, const glm::vec3& up, const glm::vec3& right, Hydra::Component::CameraComponent& cc);
@@ -11,6 +11,7 @@ namespace Hydra::System {
 		~LightSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		inline const std::string type() const final { return "LightSystem"; }
 		void registerUI() final;
@@ -9,6 +9,7 @@ namespace Hydra::System {
 		~ParticleSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		inline const std::string type() const final { return "ParticleSystem"; }
 		void registerUI() final;
@@ -9,6 +9,7 @@ namespace Hydra::System {
 		~RendererSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		inline const std::string type() const final { return "RendererSystem"; }
 		void registerUI() final;
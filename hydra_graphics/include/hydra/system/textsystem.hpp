@@ -11,6 +11,7 @@ namespace Hydra::System {
 		~TextSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		inline const std::string type() const final { return "TextSystem"; }
 		void registerUI() final;
@@ -13,21 +13,21 @@ using namespace Hydra::World;
 
 namespace Hydra::Component::ComponentManager {
 	void registerComponents_graphics(std::map<std::string, createOrGetComponent_f>& creators) {
-		CameraComponent::componentHandler = new ComponentHandler<CameraComponent>();
+		CameraComponent::componentHandler = new ComponentHandler<CameraComponent>("CameraComponent");
 		creators["CameraComponent"] = &createOrGetComponentHelper<CameraComponent>;
-		MeshComponent::componentHandler = new ComponentHandler<MeshComponent>();
+		MeshComponent::componentHandler = new ComponentHandler<MeshComponent>("MeshComponent");
 		creators["MeshComponent"] = &createOrGetComponentHelper<MeshComponent>;
-		LightComponent::componentHandler = new ComponentHandler<LightComponent>();
+		LightComponent::componentHandler = new ComponentHandler<LightComponent>("LightComponent");
 		creators["LightComponent"] = &createOrGetComponentHelper<LightComponent>;
-		ParticleComponent::componentHandler = new ComponentHandler<ParticleComponent>();
+		ParticleComponent::componentHandler = new ComponentHandler<ParticleComponent>("ParticleComponent");
 		creators["ParticleComponent"] = &createOrGetComponentHelper<ParticleComponent>;
-		PointLightComponent::componentHandler = new ComponentHandler<PointLightComponent>();
+		PointLightComponent::componentHandler = new ComponentHandler<PointLightComponent>("PointLightComponent");
 		creators["PointLightComponent"] = &createOrGetComponentHelper<PointLightComponent>;
-		DrawObjectComponent::componentHandler = new ComponentHandler<DrawObjectComponent>();
+		DrawObjectComponent::componentHandler = new ComponentHandler<DrawObjectComponent>("DrawObjectComponent");
 		creators["DrawObjectComponent"] = &createOrGetComponentHelper<DrawObjectComponent>;
-		PointLightComponent::componentHandler = new ComponentHandler<PointLightComponent>();
+		PointLightComponent::componentHandler = new ComponentHandler<PointLightComponent>("PointLightComponent");
 		creators["PointLightComponent"] = &createOrGetComponentHelper<PointLightComponent>;
-		TextComponent::componentHandler = new ComponentHandler<TextComponent>();
+		TextComponent::componentHandler = new ComponentHandler<TextComponent>("TextComponent");
 		creators["TextComponent"] = &createOrGetComponentHelper<TextComponent>;
 	}
 }
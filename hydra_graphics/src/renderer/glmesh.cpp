@@ -13,9 +13,8 @@
 
 #include <hydra/engine.hpp>
 #include <hydra/component/textcomponent.hpp> // Little Fuling LmAO
-
-#include <iostream>
-#include <fstream>
+#include <hydra/io/bakedmesh.hpp>
+#include <hydra/ext/mappedfile.hpp>
 
 using namespace Hydra;
 using namespace Hydra::Renderer;
@@ -25,7 +24,7 @@ public:
 	GLMeshImpl(std::vector<Vertex> vertices, std::vector<GLuint> indices) {
 		_file = "(internal data)";
 		_makeBuffers();
-		_uploadData(vertices, indices, false, 0, 0, 0);
+		_uploadData(vertices.data(), vertices.size(), indices.data(), indices.size(), false, 0, 0, 0);
 	}
 
 	GLMeshImpl(const std::string& file, GLuint modelMatrixBuffer) {
@@ -34,13 +33,14 @@ public:
 		_currentAnimationIndex = 0;
 		_animationCounter = 0;
 		_animDataUploaded = false;
-		_loadATTICModel(file.c_str(), modelMatrixBuffer);
+		_makeBuffers();
+		_loadATTICModel(file, modelMatrixBuffer);
 	}
 
 	GLMeshImpl(std::vector<Vertex> vertices, std::vector<GLuint> indices, bool animation, GLuint modelMatrixBuffer, GLuint particleExtraBuffer, GLuint textExtraBuffer) {
 		_file = "(internal data, animation, modelMatrixBuffer, ParticleExtraBuffer)";
 		_makeBuffers();
-		_uploadData(vertices, indices, animation, modelMatrixBuffer, particleExtraBuffer, textExtraBuffer);
+		_uploadData(vertices.data(), vertices.size(), indices.data(), indices.size(), animation, modelMatrixBuffer, particleExtraBuffer, textExtraBuffer);
 	}
 
 	~GLMeshImpl() final {
@@ -48,60 +48,15 @@ public:
 		glDeleteBuffers(sizeof(buffers) / sizeof(*buffers), buffers);
 
 		glDeleteVertexArrays(1, &_vao);
-		
-		for (size_t i = 0; i < 7; i++) {
-			for (size_t k = 0; k < skeleton[i].size(); k++) {
-				delete skeleton[i][k];
-			}
-		}
 	}
 
-	struct skelInfo {
-
-		int nrOfClusters;
-		std::string jointName;
-		glm::vec4 globalBindPose0;
-		glm::vec4 globalBindPose1;
-		glm::vec4 globalBindPose2;
-		glm::vec4 globalBindPose3;
-
-		glm::mat4 globalBindPosMat;
-
-		std::vector<glm::vec4> transRow0;
-		std::vector<glm::vec4> transRow1;
-		std::vector<glm::vec4> transRow2;
-		std::vector<glm::vec4> transRow3;
-
-		std::vector<glm::vec4> finishedTransRow0;
-		std::vector<glm::vec4> finishedTransRow1;
-		std::vector<glm::vec4> finishedTransRow2;
-		std::vector<glm::vec4> finishedTransRow3;
-
-		std::vector<glm::mat4> transformMat;
-		std::vector<glm::mat4> finishedTransformMat;
-
-		int nrOfKeys;
-	};
-	std::vector<skelInfo*> skeleton[7];
-	int animationIndex;
-
-	struct weights {
-		int nrOfIndices;
-		std::vector<int> indexPos;
-		std::vector<glm::vec3> polygonVerteciesIndex;
-		std::vector<glm::ivec4> controllers;
-		std::vector<glm::vec4> weightsInfluence;
-	};
-
-	weights weightInfo;
-
 	Material& getMaterial() final { return _material; }
 
 	bool hasAnimation() final { return _meshHasAnimation; }
-	glm::mat4 getTransformationMatrices(int currAnimIdx, int joint, int currentFrame) final { return _finishedMatrices[currAnimIdx][joint]->finishedTransformMat[currentFrame]; }
-	int getNrOfJoints(int currAnimIdx) final { return _finishedMatrices[currAnimIdx][0]->nrOfClusters; }
+	glm::mat4 getTransformationMatrices(int currAnimIdx, int joint, int currentFrame) final { return _view.matrices[currAnimIdx][joint * _view.animations[currAnimIdx].keyframes + currentFrame]; }
+	int getNrOfJoints(int currAnimIdx) final { return _view.animations ? _view.animations[currAnimIdx].joints : 0; }
 	int getCurrentKeyframe() final { return _currentFrame; }
-	int getMaxFramesForAnimation(int currAnimIdx) final { return _finishedMatrices[currAnimIdx][0]->nrOfKeys; }
+	int getMaxFramesForAnimation(int currAnimIdx) final { return _view.animations ? _view.animations[currAnimIdx].keyframes : 0; }
 	int getCurrentAnimationIndex() final { return _currentAnimationIndex; }
 	void setCurrentKeyframe(int frame) { _currentFrame = frame; }
 	void setAnimationIndex(int index) { _currentAnimationIndex = index; }
@@ -117,9 +72,12 @@ private:
 	GLuint _vao; // Vertex Array
 	GLuint _vbo; // Vertices
 	GLuint _ibo; // Indices
-	size_t _indicesCount;
-	
-	std::vector<skelInfo*> _finishedMatrices[7];
+	size_t _indicesCount = 0;
+
+	// The animation matrices are read straight from the baked data, so it is kept around for animated meshes
+	std::unique_ptr<Ext::MappedFile> _mappedFile;
+	std::vector<uint8_t> _bakedData;
+	IO::BakedMesh::View _view;
 	bool _meshHasAnimation = false;
 
 	int _nrOfJoints;
@@ -139,13 +97,13 @@ private:
 		_ibo = buffers[1];
 	}
 
-	void _uploadData(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, bool animation, GLuint modelMatrixBuffer, GLuint particleExtraBuffer, GLuint textExtraBuffer) {
-		_indicesCount = indices.size();
+	void _uploadData(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, bool animation, GLuint modelMatrixBuffer, GLuint particleExtraBuffer, GLuint textExtraBuffer) {
+		_indicesCount = indexCount;
 		glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(GLuint), indices, GL_STATIC_DRAW);
 
 		glEnableVertexAttribArray(VertexLocation::position);
 		glEnableVertexAttribArray(VertexLocation::normal);
@@ -195,332 +153,35 @@ private:
 		}
 	}
 
-	void _loadATTICModel(const char* filePath, GLuint modelMatrixBuffer) {
-		std::vector<Vertex> vertices;
-		std::vector<GLuint> indices;
-
-		glm::vec3 vec3;
-		glm::vec2 vec2;
-		//Open the file
-		std::ifstream in(filePath, std::ios::binary);
-		if (!in.good()) {
-			IEngine::getInstance()->log(LogLevel::error, "Could not load model %s", filePath);
-			return;
-		}
-
-		int nrOfMeshes = 0;
-		//Read the number of meshes in the file
-		in.read(reinterpret_cast<char*>(&nrOfMeshes), sizeof(int));
-
-		for (int i = 0; i < nrOfMeshes; i++) {
-			//meshInfo *info = new meshInfo;
-
-			//Get the name by first getting the number of chars, then read
-			//that ammount of chars
-			std::string name = "";
-			int nrOfChars = 0;
-			in.read(reinterpret_cast<char*>(&nrOfChars), sizeof(int));
-			char *tempName;
-			tempName = new char[nrOfChars];
-			in.read(tempName, nrOfChars);
-			name.append(tempName, nrOfChars);
-
-			std::cout << name << std::endl;
-			delete[] tempName;
-
-			int nrOfControlpoints = 0;
-			//Read the number of vertices on the mesh
-			in.read(reinterpret_cast<char*>(&nrOfControlpoints), sizeof(int));
-			//info->name = name;
-
-			for (int k = 0; k < nrOfControlpoints; k++) {
-				Vertex newVertex = {};
-				vec3 = glm::vec3(0);
-				//Read the Vertex for the vertex
-				in.read(reinterpret_cast<char*>(&vec3), sizeof(vec3));
-				newVertex.position = vec3;
-				//Read the Normal for the vertex
-				in.read(reinterpret_cast<char*>(&vec3), sizeof(vec3));
-				newVertex.normal = vec3;
-				//Read the Tangents for the vertex
-				in.read(reinterpret_cast<char*>(&vec3), sizeof(vec3));
-				newVertex.tangent= vec3;
-				//Read the UV for the vertex
-				in.read(reinterpret_cast<char*>(&vec2), sizeof(vec2));
-				newVertex.uv = vec2;
-
-				vertices.push_back(newVertex);
-			}
-
-			int nrOfPrimitives = 0;
-			//Read the number of triangles on the mesh for the indices
-			in.read(reinterpret_cast<char*>(&nrOfPrimitives), sizeof(int));
-			for (int w = 0; w < nrOfPrimitives; w++) {
-				//Read the indices
-				for (int q = 0; q < 3; q++) {
-					int indexData = 0;
-					in.read(reinterpret_cast<char*>(&indexData), sizeof(int));
-					//info->indices.push_back(indexData);
-					indices.push_back(indexData);
-				}
-			}
-
-			//Read the materials for the mesh as well as the Texture file name
-			int fileNameLength = 0;
-			glm::vec3 diffuse;
-			float specular = 0;
-
-			std::string fileName = "";
-			std::string glowName = "";
-			in.read(reinterpret_cast<char*>(&fileNameLength), sizeof(int));
-			char *tempFileName;
-			tempFileName = new char[fileNameLength];
-			in.read(tempFileName, fileNameLength);
-
-			//If I acidentally used a psd file, just take a png file instead
-			fileName.append(tempFileName, fileNameLength);
-			char lastChar = fileName.back();
-			if (lastChar == 'd') {
-				fileName.erase(fileName.size() - 2, fileName.size());
-				fileName.append("ng", fileNameLength - 2);
-			}
-			if (name != "AlienBossModel") {
-				if (fileName != "NULL" && fileNameLength != 0)
-					_material.diffuse = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/" + fileName);
-				else
-					_material.diffuse = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/Floor_specular.png");
-			}
-			else
-				_material.diffuse = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/AlienBossTexture.png");
-				
-			// _material.diffuse = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textuers/1x1gray.png");
-
-			delete[] tempFileName;
-
-			_material.specular = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/1x1Gray.png");
-
-			//Read the diffuse and specular value
-			in.read(reinterpret_cast<char*>(&diffuse), sizeof(diffuse));
-			in.read(reinterpret_cast<char*>(&specular), sizeof(specular));
-
-			//Read the normal Texture
-			fileName = "";
-			in.read(reinterpret_cast<char*>(&fileNameLength), sizeof(int));
-			char *tempNormalFileName;
-			tempNormalFileName = new char[fileNameLength];
-			in.read(tempNormalFileName, fileNameLength);
-			fileName.append(tempNormalFileName, fileNameLength);
-			if (fileName[0] == 'D' && fileName[1] == ':')
-				_material.normal = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/normals/LowPolyArmNormalMap.png");
-			else if (fileName != "NULL" && fileNameLength != 0)
-				_material.normal = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/normals/" + fileName);
-			else
-				_material.normal = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/normals/1x1ErrorNormal.png");
-
-			delete[] tempNormalFileName;
-
-			//Read the glow Texture
-			fileName = "";
-			in.read(reinterpret_cast<char*>(&fileNameLength), sizeof(int));
-			char *tempGlowFileName;
-			tempGlowFileName = new char[fileNameLength];
-			in.read(tempGlowFileName, fileNameLength);
-			fileName.append(tempGlowFileName, fileNameLength);
-			if (fileName != "NULL" && fileNameLength != 0)
-				_material.glow = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/glow/" + fileName);
-			else
-				_material.glow = IEngine::getInstance()->getState()->getTextureLoader()->getTexture("assets/textures/glow/errorGlow.png");
-			delete[] tempGlowFileName;
-
-			for (size_t d = 0; d < vertices.size(); d++)
-				vertices[d].color = diffuse;
-
-			vec3 = glm::vec3(0);
-			//Read the position, rotation and scale values
-			in.read(reinterpret_cast<char*>(&vec3), sizeof(vec3));
-			//info->position = vec3;
-			in.read(reinterpret_cast<char*>(&vec3), sizeof(vec3));
-			//info->rotation = vec3;
-			in.read(reinterpret_cast<char*>(&vec3), sizeof(vec3));
-			//info->scale = vec3;
-
-			bool hasAnimation = false;
-			//Read if the mesh has animation, in this case we should
-			//do a different type of rendering in the vertex shader
-			in.read(reinterpret_cast<char*>(&hasAnimation), sizeof(bool));
-
-			_indicesCount = indices.size();
-			_makeBuffers();
-
-			if (hasAnimation) {
-
-				_meshHasAnimation = true;
-				int nrOfAnimationFiles;
-				in.read(reinterpret_cast<char*>(&nrOfAnimationFiles), sizeof(int));
-				bool test = true;
-				std::string animationFilePath = "assets/objects/characters/";
-				std::string animationFileName;
-				int nrOfFileChars = 0;
-
-				//Read the weight info
-				in.read(reinterpret_cast<char*>(&nrOfFileChars), sizeof(int));
-				char *tempAnimationFileName;
-				tempAnimationFileName = new char[nrOfFileChars];
-				in.read(tempAnimationFileName, nrOfFileChars);
-				animationFileName.append(tempAnimationFileName, nrOfFileChars);
-				delete[] tempAnimationFileName;
-				animationFileName += ".wATTIC";
-				animationFilePath += animationFileName;
-
-				_loadWeight(animationFilePath.c_str(), vertices);
-
-				//Read all the skeleton info. In other words, all different animations
-				for (int animationFile = 0; animationFile < nrOfAnimationFiles; animationFile++) {
-					 
-					in.read(reinterpret_cast<char*>(&nrOfFileChars), sizeof(int));
-					animationFilePath = "assets/objects/characters/";
-					animationFileName = "";
-					tempAnimationFileName = new char[nrOfFileChars];
-					in.read(tempAnimationFileName, nrOfFileChars);
-					animationFileName.append(tempAnimationFileName, nrOfFileChars);
-					animationFileName += ".sATTIC";
-					animationFilePath += animationFileName;
-
-					delete[] tempAnimationFileName;
-
-					_loadSkeleton(animationFilePath.c_str(), vertices);
-
-
-				}
-				_uploadData(vertices, indices, true, modelMatrixBuffer, 0, 0);
-
-			}
-			else {
-				_meshHasAnimation = false;
-				_uploadData(vertices, indices, false, modelMatrixBuffer, 0, 0);
-			}
-
-		}
-	
-	}
-
-	void _loadWeight(const char* filePath, std::vector<Vertex>& vertices) {
-		std::ifstream in(filePath, std::ios::binary);
-
-		int nrOfCtrlPoints = 0;
-		in.read(reinterpret_cast<char*>(&nrOfCtrlPoints), sizeof(int));
-
-		//int polygonIndex[3];
-
-		glm::ivec3 polygonVertexIndex;
-		glm::ivec4 controllers;
-		glm::vec4 weightInfluences;
-
-		for (int k = 0; k < nrOfCtrlPoints; k++) {
-			for (int i = 0; i < 4; i++) {
-				in.read(reinterpret_cast<char*>(&controllers[i]), sizeof(int));
-
-				in.read(reinterpret_cast<char*>(&weightInfluences[i]), sizeof(float));
+	void _loadATTICModel(const std::string& file, GLuint modelMatrixBuffer) {
+		using namespace IO::BakedMesh;
+		// Use the .bATTIC if it was baked from the current .mATTIC, .wATTIC and .sATTIC files, otherwise bake it now
+		_mappedFile = std::make_unique<Ext::MappedFile>(bakedPath(file));
+		if (!_mappedFile->isOpen() || !parse(_mappedFile->data(), _mappedFile->size(), _view) || !isCurrent(_view)) {
+			_mappedFile.reset();
+			if (!bake(file, _bakedData) || !parse(_bakedData.data(), _bakedData.size(), _view)) {
+				IEngine::getInstance()->log(LogLevel::error, "Could not load model %s", file.c_str());
+				_view = IO::BakedMesh::View();
+				return;
 			}
-			vertices[k].controllers = controllers;
-			vertices[k].influences = weightInfluences;
+			IEngine::getInstance()->log(LogLevel::verbose, "%s is not baked, run meshbaker to make it load faster", file.c_str());
 		}
-		
-	}
-
-	void _loadSkeleton(const char* filePath, const std::vector<Vertex>& vertices) {
-		//First nrOfClusters
-		std::ifstream in(filePath, std::ios::binary);
-		int clusterNr = 0;
-		int indexNmr = 0;
-		int nrOfKeyframes = 0;
-
-		in.read(reinterpret_cast<char*>(&indexNmr), sizeof(int));
-		in.read(reinterpret_cast<char*>(&nrOfKeyframes), sizeof(int));
-		in.read(reinterpret_cast<char*>(&clusterNr), sizeof(int));
-
-		for (int i = 0; i < clusterNr; i++) {
-
-			//Get the name
-			std::string name = "";
-			int nrOfChars = 0;
-			in.read(reinterpret_cast<char*>(&nrOfChars), sizeof(int));
-			char *tempName;
-			tempName = new char[nrOfChars];
-			in.read(tempName, nrOfChars);
-			name.append(tempName, nrOfChars);
-
-			delete[] tempName;
-
-			skelInfo *info = new skelInfo;
-			info->nrOfKeys = nrOfKeyframes;
-			info->nrOfClusters = clusterNr;
-			info->jointName = name;
-
-			glm::vec4 globalBindVec0;
-			glm::vec4 globalBindVec1;
-			glm::vec4 globalBindVec2;
-			glm::vec4 globalBindVec3;
-
-			in.read(reinterpret_cast<char*>(&globalBindVec0), sizeof(globalBindVec0));
-			info->globalBindPose0 = globalBindVec0;
 
-			in.read(reinterpret_cast<char*>(&globalBindVec1), sizeof(globalBindVec1));
-			info->globalBindPose1 = globalBindVec1;
+		auto textureLoader = IEngine::getInstance()->getState()->getTextureLoader();
+		_material.diffuse = textureLoader->getTexture(_view.textures[Texture::diffuse]);
+		_material.normal = textureLoader->getTexture(_view.textures[Texture::normal]);
+		_material.glow = textureLoader->getTexture(_view.textures[Texture::glow]);
+		_material.specular = textureLoader->getTexture(_view.textures[Texture::specular]);
 
-			in.read(reinterpret_cast<char*>(&globalBindVec2), sizeof(globalBindVec2));
-			info->globalBindPose2 = globalBindVec2;
+		_meshHasAnimation = _view.header->hasAnimation;
+		_uploadData(_view.vertices, _view.header->vertexCount, _view.indices, _view.header->indexCount, _meshHasAnimation, modelMatrixBuffer, 0, 0);
 
-			in.read(reinterpret_cast<char*>(&globalBindVec3), sizeof(globalBindVec3));
-			info->globalBindPose3 = globalBindVec3;
-
-			glm::mat4 tempBindMat;
-			tempBindMat = glm::mat4(info->globalBindPose0, info->globalBindPose1,
-				info->globalBindPose2, info->globalBindPose3);
-			info->globalBindPosMat = tempBindMat;
-
-			for (int o = 0; o < nrOfKeyframes; o++) {
-
-				glm::vec4 glmVec0;
-				glm::vec4 glmVec1;
-				glm::vec4 glmVec2;
-				glm::vec4 glmVec3;
-				in.read(reinterpret_cast<char*>(&glmVec0), sizeof(glmVec0));
-				info->transRow0.push_back(glmVec0);
-
-				in.read(reinterpret_cast<char*>(&glmVec1), sizeof(glmVec1));
-				info->transRow1.push_back(glmVec1);
-
-				in.read(reinterpret_cast<char*>(&glmVec2), sizeof(glmVec2));
-				info->transRow2.push_back(glmVec2);
-
-				in.read(reinterpret_cast<char*>(&glmVec3), sizeof(glmVec3));
-				info->transRow3.push_back(glmVec3);
-
-				glm::mat4 tempMap = glm::mat4(glmVec0, glmVec1, glmVec2, glmVec3);
-				info->transformMat.push_back(tempMap);
-
-				in.read(reinterpret_cast<char*>(&glmVec0), sizeof(glmVec0));
-				info->finishedTransRow0.push_back(glmVec0);
-
-				in.read(reinterpret_cast<char*>(&glmVec1), sizeof(glmVec1));
-				info->finishedTransRow1.push_back(glmVec1);
-
-				in.read(reinterpret_cast<char*>(&glmVec2), sizeof(glmVec2));
-				info->finishedTransRow2.push_back(glmVec2);
-
-				in.read(reinterpret_cast<char*>(&glmVec3), sizeof(glmVec3));
-				info->finishedTransRow3.push_back(glmVec3);
-
-				tempMap = glm::mat4(glmVec0, glmVec1, glmVec2, glmVec3);
-				info->finishedTransformMat.push_back(tempMap);
-
-			}
-			_finishedMatrices[indexNmr].push_back(info);
-			skeleton[indexNmr].push_back(info);
+		if (!_meshHasAnimation) {
+			_view = IO::BakedMesh::View();
+			_mappedFile.reset();
+			std::vector<uint8_t>().swap(_bakedData);
 		}
 	}
-
 };
 
 std::unique_ptr<IMesh> GLMesh::create(const std::string& file, IRenderer* renderer) {
@@ -33,4 +33,12 @@ void AnimationSystem::tick(float delta) {
 }
 
 
+Hydra::World::SystemAccess AnimationSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::DrawObject;
+	access.writes = ComponentBits::Mesh;
+	return access;
+}
+
 void AnimationSystem::registerUI() {}
@@ -144,4 +144,12 @@ CameraSystem::FrustrumCheck CameraSystem::sphereInFrustum(const glm::vec3& p, fl
 }
 
 
+Hydra::World::SystemAccess CameraSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.writes = ComponentBits::Camera | ComponentBits::Transform;
+	access.mainThread = true; // SDL and ImGuizmo
+	return access;
+}
+
 void CameraSystem::registerUI() {}
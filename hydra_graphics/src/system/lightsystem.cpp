@@ -29,6 +29,14 @@ void LightSystem::tick(float delta) {
 	entities.clear();
 }
 
+Hydra::World::SystemAccess LightSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::Light;
+	access.writes = ComponentBits::Transform;
+	return access;
+}
+
 void LightSystem::registerUI() {
 	
 }
\ No newline at end of file
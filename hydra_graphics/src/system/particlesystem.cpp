@@ -54,5 +54,13 @@ void ParticleSystem::tick(float delta) {
 }
 
 
+Hydra::World::SystemAccess ParticleSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::Transform;
+	access.writes = ComponentBits::Particle;
+	return access;
+}
+
 void ParticleSystem::registerUI() {}
 
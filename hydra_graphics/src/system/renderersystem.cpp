@@ -20,10 +20,18 @@ void RendererSystem::tick(float delta) {
 	for (int_openmp_t i = 0; i < (int_openmp_t)entities.size(); i++) {
 		auto d = entities[i]->getComponent<Hydra::Component::DrawObjectComponent>();
 		auto t = entities[i]->getComponent<Hydra::Component::TransformComponent>();
-		d->drawObject->modelMatrix = t->getMatrix();
+		d->drawObject->modelMatrix = t->getWorldMatrix();
 	}
 
 	entities.clear();
 }
 
+Hydra::World::SystemAccess RendererSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::Transform; // TransformSystem has to tick first
+	access.writes = ComponentBits::DrawObject;
+	return access;
+}
+
 void RendererSystem::registerUI() {}
@@ -28,6 +28,14 @@ void Hydra::System::TextSystem::tick(float delta){
 	entities.clear();
 }
 
+Hydra::World::SystemAccess Hydra::System::TextSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::Text;
+	access.writes = ComponentBits::Transform;
+	return access;
+}
+
 void Hydra::System::TextSystem::registerUI(){
 
 }
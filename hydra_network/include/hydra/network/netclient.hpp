@@ -4,11 +4,14 @@
 #include <hydra/network/tcpclient.hpp>
 #include <hydra/world/world.hpp>
 #include <hydra/network/packets.hpp>
+#include <hydra/network/snapshot.hpp>
+#include <hydra/pathing/pvs.hpp>
+#include <hydra/system/projectilesystem.hpp>
 
 namespace Hydra::Network {
 	struct HYDRA_NETWORK_API NetClient final {
 	public:
-		typedef void(*updatePVS_f)(nlohmann::json&& json, void* userdata);
+		typedef void(*updatePVS_f)(const PVS& pvs, void* userdata);
 		typedef void(*onWin_f)(void* userdata);
 		typedef void(*onNewEntity_f)(Entity* entity, void* userdata);
 		typedef void(*updatePathMap_f)(bool* map, void* userdata);
@@ -25,8 +28,8 @@ namespace Hydra::Network {
 
 		static void sendEntity(Hydra::World::EntityID ent);
 		static bool initialize(char* ip, int port);
-		static void shoot(Hydra::Component::TransformComponent* tc, const glm::vec3& direction);
-		static void updateBullet(Hydra::World::EntityID newBulletID);
+		static void shoot(const Hydra::System::Projectile& bullet);
+		static void updateBullet(const Hydra::System::Projectile& bullet);
 		static void run();
 		static void reset();
 		static void enableEntity(Entity* ent);
@@ -37,10 +40,15 @@ namespace Hydra::Network {
 		static Hydra::World::EntityID _myID;
 		static std::map<ServerID, Hydra::World::EntityID> _IDs;
 		static std::map<ServerID, nlohmann::json> _bullets;
+		static SnapshotHistory _snapshots;
+		static uint32_t _newestSnapshot;
+		static uint32_t _appliedSnapshot;
 
 		static void _sendUpdatePacket();
 		static void _resolvePackets();
-		static void _updateWorld(Packet* updatePacket);
+		static void _readSnapshot(ServerUpdatePacket* updatePacket);
+		static void _updateWorld(const Snapshot& snapshot, const Snapshot& previous);
+		static void _applyEntitySnapshot(const EntitySnapshot& entity);
 		static void _addPlayer(Packet* playerPacket);
 		static void _resolveServerSpawnEntityPacket(ServerSpawnEntityPacket* entPacket);
 		static void _resolveServerDeleteEntityPacket(ServerDeleteEntityPacket* delPacket);
@@ -0,0 +1,65 @@
+/**
+ * Ring buffer that splits a TCP stream into packets without copying them.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <hydra/network/packets.hpp>
+
+namespace Hydra::Network {
+	// Largest packet the client accepts from the server
+	constexpr size_t MAX_PACKET_LENGTH = 1024 * 1024;
+
+	// Received bytes are written directly into the buffer, and next() returns pointers into it. A packet that wraps around
+	// the end of the buffer, or that doesn't start at a multiple of alignof(Packet), is copied into scratch memory that
+	// is reused after release(). The returned packets stay valid until release().
+	// The buffer is at least twice maxPacketLength, so after a release() there is always room to finish a packet.
+	class HYDRA_NETWORK_API PacketRingBuffer final {
+	public:
+		explicit PacketRingBuffer(size_t maxPacketLength);
+
+		// Returns where received bytes should be written, size is set to how many bytes fit there (0 when full)
+		uint8_t* writePointer(size_t& size);
+		void commitWrite(size_t size);
+
+		// Returns the next complete packet, or nullptr if more data is needed or the stream is broken
+		Packet* next();
+		// Frees the space of all the packets returned by next()
+		void release();
+		void clear();
+
+		// Set when a packet has an invalid length, the connection should be closed
+		inline bool isBroken() const { return _broken; }
+		inline size_t capacity() const { return _capacity; }
+
+	private:
+		size_t _maxPacketLength;
+		size_t _capacity;
+		std::unique_ptr<uint8_t[]> _data;
+		// Copies of the packets that can't be returned in place. Blocks are only added, so the copies don't move.
+		struct ScratchBlock {
+			std::unique_ptr<std::max_align_t[]> data;
+			size_t size;
+		};
+		std::vector<ScratchBlock> _scratch;
+		size_t _scratchBlock = 0;
+		size_t _scratchUsed = 0;
+		// Total number of bytes that have been released, returned by next() and written. Only _written - _released bytes
+		// are in the buffer, at index (position % _capacity).
+		uint64_t _released = 0;
+		uint64_t _parsed = 0;
+		uint64_t _written = 0;
+		bool _broken = false;
+
+		void _copyOut(uint64_t position, uint8_t* out, size_t size) const;
+		uint8_t* _allocateScratch(size_t size);
+	};
+}
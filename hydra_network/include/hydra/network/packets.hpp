@@ -25,6 +25,8 @@ namespace Hydra::Network {
 		ServerPathMap,
 		ClientRequestAIInfo,
 		ServerAIInfo,
+		ClientPing,
+		ServerPong,
 		//..
 		MAX_COUNT
 	};
@@ -44,7 +46,9 @@ namespace Hydra::Network {
 		"ServerShoot",
 		"ServerPathMap",
 		"ClientRequestAIInfo",
-		"ServerAIInfo"
+		"ServerAIInfo",
+		"ClientPing",
+		"ServerPong"
 	};
 
 	struct TransformInfo {
@@ -84,9 +88,10 @@ namespace Hydra::Network {
 
 	struct ServerPathMapPacket : public Packet
 	{
-		ServerPathMapPacket(size_t size) : Packet(PacketType::ServerPathMap, sizeof(ServerPathMapPacket) + size * sizeof(bool)) {}
-		size_t size() const { return (len - sizeof(ServerUpdateBulletPacket)) / sizeof(bool); }
-		bool data[0];
+		// PathMap::toBytes(), one bit per tile
+		ServerPathMapPacket(size_t size) : Packet(PacketType::ServerPathMap, sizeof(ServerPathMapPacket) + size) {}
+		size_t size() const { return len - sizeof(ServerPathMapPacket); }
+		uint8_t data[0];
 	};
 	///////////////////////////////////////
 	struct ClientRequestAIInfoPacket : public Packet
@@ -103,6 +108,15 @@ namespace Hydra::Network {
 		int data[0];
 	};
 	/////////////////////////////////////////
+	struct ClientPingPacket : public Packet {
+		ClientPingPacket() : Packet(PacketType::ClientPing, sizeof(ClientPingPacket)) {}
+		uint64_t time; // Sent back as is in ServerPongPacket
+	};
+	struct ServerPongPacket : public Packet {
+		ServerPongPacket() : Packet(PacketType::ServerPong, sizeof(ServerPongPacket)) {}
+		uint64_t time;
+		float tickTime; // How many milliseconds the last server tick took, not counting the sleep
+	};
 	struct ClientShootPacket : public Packet {
 		ClientShootPacket() : Packet(PacketType::ClientShoot, sizeof(ClientShootPacket)) {}
 		TransformInfo ti;
@@ -155,16 +169,12 @@ namespace Hydra::Network {
 	};
 
 	struct ServerUpdatePacket : public Packet {
-		ServerUpdatePacket(size_t nrOfEntUpdates) : Packet(PacketType::ServerUpdate, sizeof(ServerUpdatePacket) + nrOfEntUpdates * sizeof(EntUpdate)) {}
-		struct EntUpdate {
-			ServerID entityid;
-			TransformInfo ti;
-			int life = 0;
-			int animationIndex = 0;
-		};
+		ServerUpdatePacket(size_t size) : Packet(PacketType::ServerUpdate, sizeof(ServerUpdatePacket) + size) {}
+		uint32_t sequence;
+		uint32_t baseline; // The snapshot the data is a delta against, 0 for a full snapshot. See snapshot.hpp
 
-		size_t nrOfEntUpdates() const { return (len - sizeof(ServerUpdatePacket)) / sizeof(EntUpdate); }
-		EntUpdate data[0];
+		size_t size() const { return len - sizeof(ServerUpdatePacket); }
+		uint8_t data[0];
 	};
 
 	struct ServerPlayerPacket : public Packet {
@@ -179,6 +189,7 @@ namespace Hydra::Network {
 	struct ClientUpdatePacket : public Packet {
 		ClientUpdatePacket() : Packet(PacketType::ClientUpdate, sizeof(ClientUpdatePacket)) {}
 		TransformInfo ti;
+		uint32_t lastSnapshot; // Newest snapshot the client has received, used as the baseline for the next update
 	};
 
 	ClientUpdatePacket* createClientUpdatePacket(Entity* player);
@@ -0,0 +1,87 @@
+/**
+ * Quantized world snapshots and the delta codec used by ServerUpdatePacket.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <hydra/network/packets.hpp>
+
+namespace Hydra::Network {
+	// Positions and scales are stored as fixed point with this many steps per unit
+	constexpr float SNAPSHOT_POSITION_PRECISION = 256.0f;
+	// Number of snapshots kept on both sides, a client that falls further behind than this gets a full snapshot
+	constexpr uint32_t SNAPSHOT_HISTORY_SIZE = 32;
+
+	struct HYDRA_NETWORK_API EntitySnapshot final {
+		ServerID entityid = 0;
+		glm::ivec3 position = glm::ivec3(0);
+		uint32_t rotation; // Smallest three, see quantizeRotation
+		glm::ivec3 scale = glm::ivec3((int32_t)SNAPSHOT_POSITION_PRECISION);
+		int32_t life = 0;
+		int32_t animationIndex = 0;
+
+		EntitySnapshot();
+		EntitySnapshot(ServerID entityid, const TransformInfo& ti, int32_t life, int32_t animationIndex);
+
+		TransformInfo getTransform() const;
+
+		inline bool operator==(const EntitySnapshot& other) const {
+			return position == other.position && rotation == other.rotation && scale == other.scale && life == other.life && animationIndex == other.animationIndex;
+		}
+		inline bool operator!=(const EntitySnapshot& other) const { return !(*this == other); }
+	};
+
+	struct HYDRA_NETWORK_API Snapshot final {
+		uint32_t sequence = 0; // 0 is the empty snapshot, every delta against it is a full update
+		std::vector<EntitySnapshot> entities; // Sorted by entityid
+
+		const EntitySnapshot* find(ServerID entityid) const;
+	};
+
+	// Ring of the last SNAPSHOT_HISTORY_SIZE snapshots, indexed by sequence number
+	class HYDRA_NETWORK_API SnapshotHistory final {
+	public:
+		// Returns the empty snapshot for sequence 0, and nullptr if the sequence is too old or has not been added
+		const Snapshot* find(uint32_t sequence) const;
+		// The returned snapshot is cleared but keeps its storage from the snapshot it replaced
+		Snapshot& push(uint32_t sequence);
+		void clear();
+
+	private:
+		Snapshot _empty;
+		Snapshot _snapshots[SNAPSHOT_HISTORY_SIZE];
+	};
+
+	// The ServerUpdatePackets of one snapshot. Clients that are on the same baseline share a packet, and the buffers are
+	// kept between snapshots.
+	class HYDRA_NETWORK_API SnapshotPackets final {
+	public:
+		// Forgets the packets of the last snapshot
+		inline void clear() { _used = 0; }
+		// Returns the ServerUpdatePacket of 'sequence' as a delta against 'baseline', or as a full snapshot if the
+		// baseline is no longer in the history. The packet can move on the next call.
+		const std::vector<uint8_t>& get(const SnapshotHistory& history, uint32_t sequence, uint32_t baseline);
+
+	private:
+		std::vector<std::pair<uint32_t /* Baseline */, std::vector<uint8_t>>> _packets;
+		size_t _used = 0;
+	};
+
+	HYDRA_NETWORK_API uint32_t quantizeRotation(const glm::quat& q);
+	HYDRA_NETWORK_API glm::quat dequantizeRotation(uint32_t data);
+
+	// Appends the entities of 'current' that differ from 'baseline' to 'out'.
+	// Entities that are missing in 'current' are marked as removed.
+	HYDRA_NETWORK_API void writeSnapshotDelta(std::vector<uint8_t>& out, const Snapshot& baseline, const Snapshot& current);
+	// Rebuilds the snapshot that was written against 'baseline' into 'out'. Returns false if the data is malformed.
+	HYDRA_NETWORK_API bool readSnapshotDelta(const uint8_t* data, size_t size, const Snapshot& baseline, Snapshot& out);
+}
@@ -3,6 +3,7 @@
 
 #include <SDL2/SDL_net.h>
 #include <hydra/network/packets.hpp>
+#include <hydra/network/packetbuffer.hpp>
 
 namespace Hydra::Network {
 	class HYDRA_NETWORK_API TCPClient {
@@ -11,14 +12,15 @@ namespace Hydra::Network {
 		~TCPClient();
 		bool initialize(char* ip, int port);
 		int send(void* data, int length);
+		// The packets point into the receive buffer and are valid until the next call
 		std::vector<Packet*> receiveData();
 		bool isConnected();
 		void close();
 	private:
-		SDLNet_SocketSet _sset;
-		TCPsocket _tcp;
+		SDLNet_SocketSet _sset = nullptr;
+		TCPsocket _tcp = nullptr;
 		bool _connected;
-		std::vector<uint8_t> _data;
-		int _waitingForData;
+		PacketRingBuffer _buffer;
+		int _waitingForData = 0;
 	};
 }
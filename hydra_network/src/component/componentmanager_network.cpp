@@ -6,7 +6,7 @@ using namespace Hydra::World;
 
 namespace Hydra::Component::ComponentManager {
 	void registerComponents_network(std::map<std::string, createOrGetComponent_f>& creators) {
-		NetworkSyncComponent::componentHandler = new ComponentHandler<NetworkSyncComponent>();
+		NetworkSyncComponent::componentHandler = new ComponentHandler<NetworkSyncComponent>("NetworkSyncComponent");
 		creators["NetworkSyncComponent"] = &createOrGetComponentHelper<NetworkSyncComponent>;
 	}
 }
@@ -8,6 +8,7 @@
 #include <hydra/component/bulletcomponent.hpp>
 #include <hydra/component/playercomponent.hpp>
 #include <hydra/component/lifecomponent.hpp>
+#include <hydra/pathing/pathmap.hpp>
 #include <hydra/component/roomcomponent.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <hydra/engine.hpp>
@@ -28,6 +29,9 @@ TCPClient NetClient::_tcp;
 EntityID NetClient::_myID;
 std::map<ServerID, EntityID> NetClient::_IDs;
 std::map<ServerID, nlohmann::json> NetClient::_bullets;
+SnapshotHistory NetClient::_snapshots;
+uint32_t NetClient::_newestSnapshot = 0;
+uint32_t NetClient::_appliedSnapshot = 0;
 
 void NetClient::enableEntity(Entity* ent) {
 	if (!ent)
@@ -61,6 +65,7 @@ void NetClient::_sendUpdatePacket() {
 		cpup.ti.scale = tc->scale;
 		//cpup.ti.rot = tc->rotation;
 		cpup.ti.rot = glm::angleAxis(cc->cameraYaw - 1.6f /* Player model fix */, glm::vec3(0, -1, 0));;
+		cpup.lastSnapshot = _newestSnapshot;
 
 		_tcp.send(&cpup, cpup.len);
 	}
@@ -86,7 +91,6 @@ void NetClient::_resolvePackets() {
 	Hydra::Component::TransformComponent* tc;
 	std::vector<EntityID> children;
 	Entity* ent = nullptr;
-	Packet* serverUpdate = nullptr;
 	for (size_t i = 0; i < packets.size(); i++) {
 		auto& p = packets[i];
 		switch (p->type) {
@@ -111,7 +115,7 @@ void NetClient::_resolvePackets() {
 				go->updateWorldTransform();
 			break;
 		case PacketType::ServerUpdate:
-			serverUpdate = p;
+			_readSnapshot((ServerUpdatePacket*)p);
 			break;
 		case PacketType::ServerPlayer:
 			_addPlayer(p);
@@ -129,20 +133,14 @@ void NetClient::_resolvePackets() {
 		}
 		case PacketType::ServerShoot: {
 			auto ss = (ServerShootPacket*)p;
-			auto b = world::newEntity("EXTERNAL BULLET", world::root());
-			b->deserialize(_bullets[ss->serverPlayerID]);
-			auto bc = b->getComponent<Hydra::Component::BulletComponent>();
-			bc->direction = ss->direction;
-			auto tc = b->getComponent<Hydra::Component::TransformComponent>();
-			tc->position = ss->ti.pos;
-			tc->scale = ss->ti.scale;
-			tc->rotation = ss->ti.rot;
-			auto r = b->getComponent<Hydra::Component::RigidBodyComponent>();
-			if (r) {
-				r->setLinearVelocity(bc->direction*bc->velocity);
-				static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem())->enable(r.get());
-				r->setGravity(glm::vec3(0, 0, 0));
-			}
+			Hydra::System::Projectile bullet;
+			bullet.deserialize(_bullets[ss->serverPlayerID]);
+			bullet.position = ss->ti.pos;
+			bullet.size = ss->ti.scale.x;
+			bullet.rotation = ss->ti.rot;
+			bullet.direction = ss->direction;
+			if (auto projectiles = static_cast<Hydra::System::ProjectileSystem*>(IEngine::getInstance()->getState()->getProjectileSystem()))
+				projectiles->fire(bullet);
 			break;
 		}
 		case PacketType::ServerFreezePlayer: {
@@ -169,21 +167,30 @@ void NetClient::_resolvePackets() {
 			if (!updatePVS)
 				break;
 			auto sipp = (ServerInitializePVSPacket*)p;
-			nlohmann::json json = nlohmann::json::parse(sipp->data, sipp->data + sipp->size());
-			updatePVS(std::move(json), userdata);
+			PVS pvs;
+			if (!pvs.fromBytes((const uint8_t*)sipp->data, sipp->size())) {
+				printf("Error: Invalid PVS size %zu\n", sipp->size());
+				break;
+			}
+			updatePVS(pvs, userdata);
 			break;
 		}
 		case PacketType::ServerPathMap: {
 			if (!updatePathMap)
 				break;
 			auto spm = (ServerPathMapPacket*)p;
-			bool* map = new bool[WORLD_MAP_SIZE * WORLD_MAP_SIZE];
-			for (int i = 0; i < WORLD_MAP_SIZE * WORLD_MAP_SIZE; i++)
-			{
-				map[i] = spm->data[i];
+			PathMap pathMap;
+			if (!pathMap.fromBytes(spm->data, spm->size())) {
+				printf("Error: Invalid path map size %zu\n", spm->size());
+				break;
 			}
+			// The minimap and the AI inspector want one bool per tile, at y * WORLD_MAP_SIZE + x
+			bool* map = new bool[WORLD_MAP_SIZE * WORLD_MAP_SIZE];
+			for (int y = 0; y < WORLD_MAP_SIZE; y++)
+				for (int x = 0; x < WORLD_MAP_SIZE; x++)
+					map[y * WORLD_MAP_SIZE + x] = pathMap.get(x, y);
 
-			updatePathMap((bool*)map, userdata);
+			updatePathMap(map, userdata);
 			break;
 		}
 		case PacketType::ServerAIInfo: {
@@ -228,11 +235,12 @@ void NetClient::_resolvePackets() {
 		}
 	}
 
-	if (serverUpdate)
-		_updateWorld(serverUpdate);
-
-	for (size_t i = 0; i < packets.size(); i++)
-		delete[] (char*)packets[i];
+	// All snapshots are decoded so they can be used as baselines, but only the newest one is applied to the world
+	if (_newestSnapshot != _appliedSnapshot) {
+		const Snapshot* previous = _snapshots.find(_appliedSnapshot);
+		_updateWorld(*_snapshots.find(_newestSnapshot), previous ? *previous : *_snapshots.find(0));
+		_appliedSnapshot = _newestSnapshot;
+	}
 }
 
 //ADD ENTITES IN ANY OTHER PLACE THAN ROOT?
@@ -251,7 +259,7 @@ void NetClient::_resolveServerDeleteEntityPacket(ServerDeleteEntityPacket* delPa
 	std::vector<EntityID> children = world::root()->children;
 	for (size_t i = 0; i < children.size(); i++)
 		if (children[i] == _IDs[delPacket->id]) {
-			world::getEntity(children[i])->dead = true;
+			world::getEntity(children[i])->kill();
 
 			_bullets.erase(delPacket->id);
 			_IDs.erase(delPacket->id);
@@ -259,60 +267,86 @@ void NetClient::_resolveServerDeleteEntityPacket(ServerDeleteEntityPacket* delPa
 		}
 }
 
-void NetClient::_updateWorld(Packet * updatePacket) {
-	std::vector<EntityID> children = world::root()->children;
-	ServerUpdatePacket* sup = (ServerUpdatePacket*)updatePacket;
-	Hydra::Component::TransformComponent* tc;
-	for (size_t k = 0; k < sup->nrOfEntUpdates(); k++) {
-		if (_IDs[sup->data[k].entityid] == _myID) {
-			ServerUpdatePacket::EntUpdate& entupdate = (ServerUpdatePacket::EntUpdate&)sup->data[k];
-			LifeComponent* life = world::getEntity(_myID)->getComponent<LifeComponent>().get();
-			if (life)
-				life->health = entupdate.life;
-			continue;
-		}
-		else if (_IDs[sup->data[k].entityid] == 0) {
-			printf("Error updating entity: %zu\n", _IDs[sup->data[k].entityid]);
+void NetClient::_readSnapshot(ServerUpdatePacket* sup) {
+	if (sup->sequence <= _newestSnapshot)
+		return;
+	const Snapshot* baseline = _snapshots.find(sup->baseline);
+	// The server never sends a baseline older than the history, so this only happens if packets got lost
+	if (!baseline || (sup->baseline && sup->sequence - sup->baseline >= SNAPSHOT_HISTORY_SIZE)) {
+		printf("Error: Missing baseline %u for snapshot %u\n", sup->baseline, sup->sequence);
+		return;
+	}
 
-			auto ent = world::newEntity("ERROR: UNKOWN ENTITY", world::root());
-			_IDs[sup->data[k].entityid] = ent->id;
-			auto mesh = ent->addComponent<MeshComponent>();
-			mesh->loadMesh("assets/objects/characters/AlienModel2.mATTIC");
-			auto transform = ent->addComponent<TransformComponent>();
-			transform->position = { ((ServerUpdatePacket::EntUpdate&)sup->data[k]).ti.pos.x, ((ServerUpdatePacket::EntUpdate&)sup->data[k]).ti.pos.y, ((ServerUpdatePacket::EntUpdate&)sup->data[k]).ti.pos.z };
+	Snapshot& snapshot = _snapshots.push(sup->sequence);
+	if (!readSnapshotDelta(sup->data, sup->size(), *baseline, snapshot)) {
+		printf("Error: Malformed snapshot %u\n", sup->sequence);
+		snapshot.sequence = 0;
+		snapshot.entities.clear();
+		return;
+	}
+	_newestSnapshot = sup->sequence;
+}
 
+void NetClient::_updateWorld(const Snapshot& snapshot, const Snapshot& previous) {
+	// Both lists are sorted on entityid, so only the entities that changed since the last applied snapshot are touched
+	size_t p = 0;
+	for (const EntitySnapshot& entity : snapshot.entities) {
+		while (p < previous.entities.size() && previous.entities[p].entityid < entity.entityid)
+			p++;
+		if (p < previous.entities.size() && previous.entities[p].entityid == entity.entityid && previous.entities[p] == entity)
 			continue;
-		}
-		for (size_t i = 0; i < children.size(); i++) {
-			if (children[i] == _IDs[((ServerUpdatePacket::EntUpdate&)sup->data[k]).entityid]) {
-				auto ent = world::getEntity(children[i]);
-				ServerUpdatePacket::EntUpdate& entupdate = (ServerUpdatePacket::EntUpdate&)sup->data[k];
-				tc = ent->getComponent<Hydra::Component::TransformComponent>().get();
-				if (tc) {
-					tc->position = { entupdate.ti.pos.x,entupdate.ti.pos.y,entupdate.ti.pos.z };
-					tc->setRotation(entupdate.ti.rot);
-					tc->setScale(entupdate.ti.scale);
-				}
+		_applyEntitySnapshot(entity);
+	}
+}
 
-				LifeComponent* life = world::getEntity(children[i])->getComponent<LifeComponent>().get();
-				if (life)
-					life->health = entupdate.life;
+void NetClient::_applyEntitySnapshot(const EntitySnapshot& entupdate) {
+	auto it = _IDs.find(entupdate.entityid);
+	if (it != _IDs.end() && it->second == _myID) {
+		LifeComponent* life = world::getEntity(_myID)->getComponent<LifeComponent>().get();
+		if (life)
+			life->health = entupdate.life;
+		return;
+	}
 
-				if (auto rb = ent->getComponent<Hydra::Component::RigidBodyComponent>(); rb) {
-					rb->refreshTransform();
-					rb->setActivationState(Hydra::Component::RigidBodyComponent::ActivationState::disableSimulation);
-				}
+	const TransformInfo ti = entupdate.getTransform();
+	if (it == _IDs.end() || it->second == 0) {
+		printf("Error updating entity: %zu\n", entupdate.entityid);
 
-				if (auto go = ent->getComponent<Hydra::Component::GhostObjectComponent>(); go)
-					go->updateWorldTransform();
+		auto ent = world::newEntity("ERROR: UNKOWN ENTITY", world::root());
+		_IDs[entupdate.entityid] = ent->id;
+		auto mesh = ent->addComponent<MeshComponent>();
+		mesh->loadMesh("assets/objects/characters/AlienModel2.mATTIC");
+		auto transform = ent->addComponent<TransformComponent>();
+		transform->position = ti.pos;
+		return;
+	}
 
-				auto mesh = world::getEntity(children[i])->getComponent<MeshComponent>();
-				if (mesh)
-					mesh->animationIndex = entupdate.animationIndex;
-				break;
-			}
-		}
+	auto ent = world::getEntity(it->second);
+	if (!ent)
+		return;
+
+	Hydra::Component::TransformComponent* tc = ent->getComponent<Hydra::Component::TransformComponent>().get();
+	if (tc) {
+		tc->position = ti.pos;
+		tc->setRotation(ti.rot);
+		tc->setScale(ti.scale);
+	}
+
+	LifeComponent* life = ent->getComponent<LifeComponent>().get();
+	if (life)
+		life->health = entupdate.life;
+
+	if (auto rb = ent->getComponent<Hydra::Component::RigidBodyComponent>(); rb) {
+		rb->refreshTransform();
+		rb->setActivationState(Hydra::Component::RigidBodyComponent::ActivationState::disableSimulation);
 	}
+
+	if (auto go = ent->getComponent<Hydra::Component::GhostObjectComponent>(); go)
+		go->updateWorldTransform();
+
+	auto mesh = ent->getComponent<MeshComponent>();
+	if (mesh)
+		mesh->animationIndex = entupdate.animationIndex;
 }
 
 void NetClient::_addPlayer(Packet * playerPacket) {
@@ -353,23 +387,22 @@ bool NetClient::initialize(char* ip, int port) {
 	return false;
 }
 
-void NetClient::shoot(Hydra::Component::TransformComponent * tc, const glm::vec3& direction) {
+void NetClient::shoot(const Hydra::System::Projectile& bullet) {
 	if (NetClient::_tcp.isConnected()) {
 		ClientShootPacket csp{};
 
-		csp.direction = direction;
-		csp.ti.pos = tc->position;
-		csp.ti.scale = tc->scale;
-		csp.ti.rot = tc->rotation;
+		csp.direction = bullet.direction;
+		csp.ti.pos = bullet.position;
+		csp.ti.scale = glm::vec3(bullet.size);
+		csp.ti.rot = bullet.rotation;
 
 		NetClient::_tcp.send(&csp, csp.len);
 	}
 }
 
-void NetClient::updateBullet(EntityID newBulletID) {
+void NetClient::updateBullet(const Hydra::System::Projectile& bullet) {
 	nlohmann::json json;
-	Entity* entptr = world::getEntity(newBulletID).get();
-	entptr->serialize(json);
+	bullet.serialize(json);
 	std::vector<uint8_t> vec = json.to_msgpack(json);
 	ClientUpdateBulletPacket* packet = (ClientUpdateBulletPacket*)new char[sizeof(ClientUpdateBulletPacket) + vec.size()];
 	*packet = ClientUpdateBulletPacket(vec.size());
@@ -421,6 +454,9 @@ void NetClient::reset() {
 		return;
 	_tcp.close();
 	_IDs.clear();
+	_snapshots.clear();
+	_newestSnapshot = 0;
+	_appliedSnapshot = 0;
 	updatePVS = nullptr;
 	onWin = nullptr;
 	onNewEntity = nullptr;
@@ -0,0 +1,88 @@
+#include <hydra/network/packetbuffer.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Hydra::Network;
+
+PacketRingBuffer::PacketRingBuffer(size_t maxPacketLength) : _maxPacketLength(std::max(maxPacketLength, sizeof(Packet))) {
+	_capacity = 1;
+	while (_capacity < _maxPacketLength * 2)
+		_capacity <<= 1;
+	_data.reset(new uint8_t[_capacity]);
+}
+
+uint8_t* PacketRingBuffer::writePointer(size_t& size) {
+	const size_t offset = _written & (_capacity - 1);
+	size = std::min<size_t>(_capacity - (_written - _released), _capacity - offset);
+	return _data.get() + offset;
+}
+
+void PacketRingBuffer::commitWrite(size_t size) {
+	_written += size;
+}
+
+Packet* PacketRingBuffer::next() {
+	const uint64_t available = _written - _parsed;
+	if (_broken || available < sizeof(Packet))
+		return nullptr;
+
+	size_t len;
+	_copyOut(_parsed + offsetof(Packet, len), (uint8_t*)&len, sizeof(len));
+	if (len < sizeof(Packet) || len > _maxPacketLength) {
+		_broken = true;
+		return nullptr;
+	}
+	if (available < len)
+		return nullptr;
+
+	// _data comes from new, so it is aligned for every type
+	const size_t offset = _parsed & (_capacity - 1);
+	Packet* packet;
+	if (offset + len <= _capacity && offset % alignof(Packet) == 0)
+		packet = (Packet*)(_data.get() + offset);
+	else {
+		uint8_t* copy = _allocateScratch(len);
+		_copyOut(_parsed, copy, len);
+		packet = (Packet*)copy;
+	}
+	_parsed += len;
+	return packet;
+}
+
+void PacketRingBuffer::release() {
+	_released = _parsed;
+	_scratchBlock = 0;
+	_scratchUsed = 0;
+}
+
+void PacketRingBuffer::clear() {
+	_released = _parsed = _written = 0;
+	_scratchBlock = 0;
+	_scratchUsed = 0;
+	_broken = false;
+}
+
+void PacketRingBuffer::_copyOut(uint64_t position, uint8_t* out, size_t size) const {
+	const size_t offset = position & (_capacity - 1);
+	const size_t first = std::min(size, _capacity - offset);
+	memcpy(out, _data.get() + offset, first);
+	memcpy(out + first, _data.get(), size - first);
+}
+
+uint8_t* PacketRingBuffer::_allocateScratch(size_t size) {
+	constexpr size_t align = alignof(std::max_align_t);
+	constexpr size_t minBlockSize = 64 * 1024;
+	size = (size + align - 1) / align * align;
+	while (_scratchBlock < _scratch.size() && _scratchUsed + size > _scratch[_scratchBlock].size) {
+		_scratchBlock++;
+		_scratchUsed = 0;
+	}
+	if (_scratchBlock == _scratch.size()) {
+		const size_t blockSize = std::max(size, minBlockSize);
+		_scratch.push_back(ScratchBlock{std::unique_ptr<std::max_align_t[]>(new std::max_align_t[blockSize / align]), blockSize});
+	}
+	uint8_t* out = (uint8_t*)_scratch[_scratchBlock].data.get() + _scratchUsed;
+	_scratchUsed += size;
+	return out;
+}
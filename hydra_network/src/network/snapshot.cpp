@@ -0,0 +1,292 @@
+#include <hydra/network/snapshot.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+using namespace Hydra::Network;
+
+namespace {
+	enum SnapshotField : uint8_t {
+		removed = 1 << 0,
+		position = 1 << 1,
+		rotation = 1 << 2,
+		scale = 1 << 3,
+		life = 1 << 4,
+		animation = 1 << 5
+	};
+
+	int32_t quantize(float value) {
+		if (!std::isfinite(value))
+			return 0;
+		return (int32_t)std::lround(glm::clamp(value * SNAPSHOT_POSITION_PRECISION, (float)INT32_MIN, (float)INT32_MAX));
+	}
+
+	glm::ivec3 quantize(const glm::vec3& value) {
+		return glm::ivec3(quantize(value.x), quantize(value.y), quantize(value.z));
+	}
+
+	glm::vec3 dequantize(const glm::ivec3& value) {
+		return glm::vec3(value) / SNAPSHOT_POSITION_PRECISION;
+	}
+
+	void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+		while (value >= 0x80) {
+			out.push_back((uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back((uint8_t)value);
+	}
+
+	void writeDelta(std::vector<uint8_t>& out, int32_t from, int32_t to) {
+		int64_t delta = (int64_t)to - from;
+		writeVarint(out, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+	}
+
+	struct Reader {
+		const uint8_t* data;
+		const uint8_t* end;
+		bool ok = true;
+
+		Reader(const uint8_t* data, size_t size) : data(data), end(data + size) {}
+
+		uint8_t readByte() {
+			if (data == end) {
+				ok = false;
+				return 0;
+			}
+			return *data++;
+		}
+
+		uint64_t readVarint() {
+			uint64_t value = 0;
+			for (int shift = 0; shift < 64; shift += 7) {
+				uint8_t b = readByte();
+				value |= (uint64_t)(b & 0x7F) << shift;
+				if (!(b & 0x80))
+					return value;
+			}
+			ok = false;
+			return 0;
+		}
+
+		int32_t readDelta(int32_t from) {
+			uint64_t zigzag = readVarint();
+			int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+			return (int32_t)(from + delta);
+		}
+	};
+
+	void writeEntity(std::vector<uint8_t>& out, ServerID& lastID, const EntitySnapshot& from, const EntitySnapshot& to, bool isNew) {
+		uint8_t mask = 0;
+		if (from.position != to.position)
+			mask |= SnapshotField::position;
+		if (from.rotation != to.rotation)
+			mask |= SnapshotField::rotation;
+		if (from.scale != to.scale)
+			mask |= SnapshotField::scale;
+		if (from.life != to.life)
+			mask |= SnapshotField::life;
+		if (from.animationIndex != to.animationIndex)
+			mask |= SnapshotField::animation;
+		if (!mask && !isNew)
+			return;
+
+		out.push_back(mask);
+		writeVarint(out, to.entityid - lastID);
+		lastID = to.entityid;
+
+		if (mask & SnapshotField::position)
+			for (int i = 0; i < 3; i++)
+				writeDelta(out, from.position[i], to.position[i]);
+		if (mask & SnapshotField::rotation)
+			for (int i = 0; i < 4; i++)
+				out.push_back((uint8_t)(to.rotation >> (i * 8)));
+		if (mask & SnapshotField::scale)
+			for (int i = 0; i < 3; i++)
+				writeDelta(out, from.scale[i], to.scale[i]);
+		if (mask & SnapshotField::life)
+			writeDelta(out, from.life, to.life);
+		if (mask & SnapshotField::animation)
+			writeDelta(out, from.animationIndex, to.animationIndex);
+	}
+}
+
+EntitySnapshot::EntitySnapshot() : rotation(quantizeRotation(glm::quat(1, 0, 0, 0))) {}
+
+EntitySnapshot::EntitySnapshot(ServerID entityid, const TransformInfo& ti, int32_t life, int32_t animationIndex)
+	: entityid(entityid), position(quantize(ti.pos)), rotation(quantizeRotation(ti.rot)), scale(quantize(ti.scale)), life(life), animationIndex(animationIndex) {}
+
+TransformInfo EntitySnapshot::getTransform() const {
+	TransformInfo ti;
+	ti.pos = dequantize(position);
+	ti.scale = dequantize(scale);
+	ti.rot = dequantizeRotation(rotation);
+	return ti;
+}
+
+const EntitySnapshot* Snapshot::find(ServerID entityid) const {
+	auto it = std::lower_bound(entities.begin(), entities.end(), entityid, [](const EntitySnapshot& e, ServerID id) { return e.entityid < id; });
+	if (it == entities.end() || it->entityid != entityid)
+		return nullptr;
+	return &*it;
+}
+
+const Snapshot* SnapshotHistory::find(uint32_t sequence) const {
+	if (!sequence)
+		return &_empty;
+	const Snapshot& snapshot = _snapshots[sequence % SNAPSHOT_HISTORY_SIZE];
+	return snapshot.sequence == sequence ? &snapshot : nullptr;
+}
+
+Snapshot& SnapshotHistory::push(uint32_t sequence) {
+	Snapshot& snapshot = _snapshots[sequence % SNAPSHOT_HISTORY_SIZE];
+	snapshot.sequence = sequence;
+	snapshot.entities.clear();
+	return snapshot;
+}
+
+void SnapshotHistory::clear() {
+	for (Snapshot& snapshot : _snapshots) {
+		snapshot.sequence = 0;
+		snapshot.entities.clear();
+	}
+}
+
+const std::vector<uint8_t>& SnapshotPackets::get(const SnapshotHistory& history, uint32_t sequence, uint32_t baseline) {
+	if (sequence - baseline >= SNAPSHOT_HISTORY_SIZE || !history.find(baseline))
+		baseline = 0;
+
+	for (size_t i = 0; i < _used; i++)
+		if (_packets[i].first == baseline)
+			return _packets[i].second;
+
+	if (_used == _packets.size())
+		_packets.emplace_back();
+	auto& packet = _packets[_used++];
+	packet.first = baseline;
+	auto& buffer = packet.second;
+	buffer.resize(sizeof(ServerUpdatePacket));
+	writeSnapshotDelta(buffer, *history.find(baseline), *history.find(sequence));
+
+	ServerUpdatePacket* header = (ServerUpdatePacket*)buffer.data();
+	*header = ServerUpdatePacket(buffer.size() - sizeof(ServerUpdatePacket));
+	header->sequence = sequence;
+	header->baseline = baseline;
+	return buffer;
+}
+
+// Smallest three: the largest component is left out and rebuilt from the other three, which are stored as 10 bits each.
+// The top two bits is the index of the left out component.
+uint32_t Hydra::Network::quantizeRotation(const glm::quat& q) {
+	float length = glm::length(q);
+	if (!std::isfinite(length) || length < 0.0001f)
+		return quantizeRotation(glm::quat(1, 0, 0, 0));
+	const float c[4] = {q.x / length, q.y / length, q.z / length, q.w / length};
+
+	uint32_t largest = 0;
+	for (uint32_t i = 1; i < 4; i++)
+		if (std::fabs(c[i]) > std::fabs(c[largest]))
+			largest = i;
+	// q and -q is the same rotation, so the left out component is always positive
+	const float sign = c[largest] < 0 ? -1.0f : 1.0f;
+
+	uint32_t result = largest << 30;
+	int shift = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+		float v = glm::clamp(c[i] * sign * glm::root_two<float>(), -1.0f, 1.0f);
+		result |= (uint32_t)std::lround((v * 0.5f + 0.5f) * 1023.0f) << shift;
+		shift += 10;
+	}
+	return result;
+}
+
+glm::quat Hydra::Network::dequantizeRotation(uint32_t data) {
+	const uint32_t largest = data >> 30;
+	float c[4];
+	float sum = 0;
+	int shift = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		if (i == largest)
+			continue;
+		float v = (((data >> shift) & 0x3FF) / 1023.0f * 2.0f - 1.0f) / glm::root_two<float>();
+		c[i] = v;
+		sum += v * v;
+		shift += 10;
+	}
+	c[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+	return glm::normalize(glm::quat(c[3], c[0], c[1], c[2]));
+}
+
+void Hydra::Network::writeSnapshotDelta(std::vector<uint8_t>& out, const Snapshot& baseline, const Snapshot& current) {
+	static const EntitySnapshot empty;
+	ServerID lastID = 0;
+	size_t b = 0;
+	size_t c = 0;
+	while (b < baseline.entities.size() || c < current.entities.size()) {
+		if (c == current.entities.size() || (b < baseline.entities.size() && baseline.entities[b].entityid < current.entities[c].entityid)) {
+			out.push_back(SnapshotField::removed);
+			writeVarint(out, baseline.entities[b].entityid - lastID);
+			lastID = baseline.entities[b].entityid;
+			b++;
+		} else if (b == baseline.entities.size() || current.entities[c].entityid < baseline.entities[b].entityid) {
+			writeEntity(out, lastID, empty, current.entities[c], true);
+			c++;
+		} else {
+			writeEntity(out, lastID, baseline.entities[b], current.entities[c], false);
+			b++;
+			c++;
+		}
+	}
+}
+
+bool Hydra::Network::readSnapshotDelta(const uint8_t* data, size_t size, const Snapshot& baseline, Snapshot& out) {
+	static const EntitySnapshot empty;
+	Reader reader(data, size);
+	out.entities.clear();
+	out.entities.reserve(baseline.entities.size());
+
+	ServerID id = 0;
+	size_t b = 0;
+	while (reader.ok && reader.data != reader.end) {
+		const uint8_t mask = reader.readByte();
+		const uint64_t idDelta = reader.readVarint();
+		if (!reader.ok || (idDelta == 0 && id != 0))
+			return false;
+		id += idDelta;
+
+		for (; b < baseline.entities.size() && baseline.entities[b].entityid < id; b++)
+			out.entities.push_back(baseline.entities[b]);
+
+		const bool inBaseline = b < baseline.entities.size() && baseline.entities[b].entityid == id;
+		EntitySnapshot entity = inBaseline ? baseline.entities[b] : empty;
+		if (inBaseline)
+			b++;
+		if (mask & SnapshotField::removed)
+			continue;
+
+		entity.entityid = id;
+		if (mask & SnapshotField::position)
+			for (int i = 0; i < 3; i++)
+				entity.position[i] = reader.readDelta(entity.position[i]);
+		if (mask & SnapshotField::rotation) {
+			entity.rotation = 0;
+			for (int i = 0; i < 4; i++)
+				entity.rotation |= (uint32_t)reader.readByte() << (i * 8);
+		}
+		if (mask & SnapshotField::scale)
+			for (int i = 0; i < 3; i++)
+				entity.scale[i] = reader.readDelta(entity.scale[i]);
+		if (mask & SnapshotField::life)
+			entity.life = reader.readDelta(entity.life);
+		if (mask & SnapshotField::animation)
+			entity.animationIndex = reader.readDelta(entity.animationIndex);
+		out.entities.push_back(entity);
+	}
+
+	for (; b < baseline.entities.size(); b++)
+		out.entities.push_back(baseline.entities[b]);
+	return reader.ok;
+}
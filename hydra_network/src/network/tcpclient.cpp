@@ -5,7 +5,7 @@
 using namespace Hydra::Network;
 typedef signed long ssize_t;
 
-TCPClient::TCPClient() {
+TCPClient::TCPClient() : _buffer(MAX_PACKET_LENGTH) {
     this->_connected = false;
 }
 TCPClient::~TCPClient() {
@@ -24,6 +24,8 @@ bool TCPClient::initialize(char* ip, int port) {
 		return false;
 	}
 	this->_connected = true;
+	this->_waitingForData = 0;
+	this->_buffer.clear();
 	this->_sset = SDLNet_AllocSocketSet(1);
 	SDLNet_TCP_AddSocket(this->_sset, this->_tcp);
 	return true;
@@ -47,29 +49,28 @@ std::vector<Packet*> TCPClient::receiveData() {
 		return packets;
 	}
 
-	static uint8_t tmpbuf[0x1000];
-	while (SDLNet_CheckSockets(this->_sset, 0) == 1) {
-		int64_t lenTmp = SDLNet_TCP_Recv(this->_tcp, tmpbuf, sizeof(tmpbuf));
+	// The packets from the last call are not used anymore
+	_buffer.release();
+
+	size_t size;
+	uint8_t* data;
+	while ((data = _buffer.writePointer(size), size) && SDLNet_CheckSockets(this->_sset, 0) == 1) {
+		int64_t lenTmp = SDLNet_TCP_Recv(this->_tcp, data, size);
 		if (lenTmp <= 0) {
 			close();
 			return packets;
 		}
-		_data.insert(_data.end(), &tmpbuf[0], &tmpbuf[lenTmp]);
+		_buffer.commitWrite(lenTmp);
 		_waitingForData = 0;
 	}
 
-	while (_data.size() >= sizeof(Packet)) {
-		Packet* p = (Packet*)_data.data();
-		if (_data.size() < p->len) {
-			fprintf(stderr, "PACKET NEEDED MORE DATA THAN AVAILABLE!");
-			break;
-		}
-
+	while (Packet* p = _buffer.next()) {
 		//printf("Reading packet:\n\ttype: %s\n\tlen: %zu\n\tclient: %zu\n", Hydra::Network::PacketTypeName[p->type], p->len, p->client);
-		Packet* newPacket = (Packet*)(new char[p->len]);
-		memcpy(newPacket, p, p->len);
-		packets.push_back(newPacket);
-		_data.erase(_data.begin(), _data.begin() + p->len);
+		packets.push_back(p);
+	}
+	if (_buffer.isBroken()) {
+		fprintf(stderr, "Received a packet with an invalid length!\n");
+		close();
 	}
 
 	return packets;
@@ -80,11 +81,12 @@ bool TCPClient::isConnected() {
 }
 
 void TCPClient::close() {
+	if (!_tcp)
+		return;
 	printf("Disconnecting from the server!\n");
 	_connected = false;
 	SDLNet_FreeSocketSet(_sset);
 	_sset = nullptr;
 	SDLNet_TCP_Close(_tcp);
 	_tcp = nullptr;
-	_data.resize(0);
 }
@@ -13,6 +13,7 @@
 #include <hydra/component/playercomponent.hpp>
 #include <hydra/world/world.hpp>
 #include <hydra/component/weaponcomponent.hpp>
+#include <hydra/pathing/pathmap.hpp>
 
 using namespace Hydra::World;
 namespace Hydra::Component {
@@ -26,7 +27,7 @@ namespace Hydra::Component {
 	SpawnerType spawnerID = SpawnerType::AlienSpawner;
 	std::vector<int> spawnGroup = std::vector<int>();
 	float spawnTimer = 0.0f;
-	bool** map = nullptr;
+	const PathMap* map = nullptr;
 	int spawnCounter = 0;
 	glm::vec3 playerPos;
 
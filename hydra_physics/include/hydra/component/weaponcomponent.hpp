@@ -12,12 +12,13 @@
 #include <hydra/world/world.hpp>
 #include <hydra/component/bulletcomponent.hpp>
 #include <hydra/system/bulletphysicssystem.hpp>
+#include <hydra/system/projectilesystem.hpp>
 
 using namespace Hydra::World;
 
 namespace Hydra::Component {
 	struct HYDRA_PHYSICS_API WeaponComponent final : public IComponent<WeaponComponent, ComponentBits::Weapon> {
-		typedef void (*onShoot_f)(WeaponComponent& weapon, Entity* bullet, void* userdata);
+		typedef void (*onShoot_f)(WeaponComponent& weapon, const Hydra::System::Projectile& bullet, void* userdata);
 		float fireRateTimer = 0.0f;
 		float fireRateRPM = 600.0f;
 		float bulletSize = 0.5f;
@@ -45,6 +46,7 @@ namespace Hydra::Component {
 
 		~WeaponComponent() final;
 
+		// Fires the bullets into the ProjectileSystem of the engine state, can be called from any thread
 		bool shoot(glm::vec3 position, glm::vec3 direction, glm::quat bulletOrientation, float velocity, Hydra::System::BulletPhysicsSystem::CollisionTypes collisionType);
 		bool reload(float delta);
 		void resetReload();
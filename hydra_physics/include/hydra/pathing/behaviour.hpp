@@ -1,5 +1,7 @@
 #pragma once
 #include <hydra/pathing/pathfinding.hpp>
+#include <hydra/pathing/flowfield.hpp>
+#include <hydra/pathing/pathqueue.hpp>
 #include <hydra/world/world.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -8,6 +10,7 @@
 #include <hydra/ext/api.hpp>
 #include <memory>
 #include <random>
+#include <hydra/system/bulletphysicssystem.hpp>
 
 namespace Hydra::Physics::Behaviour {
 	class HYDRA_PHYSICS_API Behaviour
@@ -54,6 +57,11 @@ namespace Hydra::Physics::Behaviour {
 
 		bool playerUnreachable = false;
 		PathFinding* pathFinding = nullptr;
+		//Shared with every enemy that has the same target player
+		std::shared_ptr<FlowField> flowField;
+		//Where the flow field doesn't reach, an A* path is asked for from PathQueue
+		std::vector<glm::vec3> queuedPath;
+		PathQueue::Ticket pathTicket = PathQueue::INVALID_TICKET;
 		bool doDiddeliDoneDatPathfinding = false;
 
 		float range = 1.0f;
@@ -61,10 +69,21 @@ namespace Hydra::Physics::Behaviour {
 		float originalRange = 1.0f;
 		glm::quat rotation = glm::quat();
 
+		//AISystem calls think for every enemy at the same time, then resolveRays and act for one enemy at a time.
+		//think may only change its own enemy, it queues the rays it wants and reads their results on the next tick.
+		//A behaviour that isn't split only has run, which act calls.
+		virtual void think(float /*dt*/) {}
+		virtual void act(float dt) { run(dt); applyPendingDamage(); }
 		virtual void run(float dt) = 0;
+		//Tests the rays that think queued
+		void resolveRays(const Hydra::System::BulletPhysicsSystem& physics);
+		//The same in two steps, so that the rays of many enemies can be tested in one batch. collectRays appends the
+		//queued rays to out, then resolveRays takes their hits in the same order and returns how many it used.
+		void collectRays(std::vector<Hydra::System::BulletPhysicsSystem::Ray>& out) const;
+		size_t resolveRays(const Hydra::System::BulletPhysicsSystem::RayHit* hits);
 		void setEnemyEntity(std::shared_ptr<Hydra::World::Entity> enemy);
 		void setTargetPlayer(std::shared_ptr<Hydra::World::Entity> player);
-		virtual void setPathMap(bool** map);
+		virtual void setPathMap(const PathMap* map);
 	protected:
 		struct ComponentSet
 		{
@@ -80,8 +99,31 @@ namespace Hydra::Physics::Behaviour {
 		ComponentSet thisEnemy = ComponentSet();
 		ComponentSet targetPlayer = ComponentSet();
 
+		struct RayQuery
+		{
+			glm::vec3 from;
+			glm::vec3 to;
+			bool queued = false;
+			//Set by resolveRays, done is false if the ray wasn't queued before it
+			bool done = false;
+			bool hit = false;
+			int hitType = 0;
+		};
+		enum { SIGHT_RAY, FLOOR_RAY, RAY_COUNT };
+		RayQuery rays[RAY_COUNT];
+		//Damage to the target player, applied in act
+		int pendingDamage = 0;
+
 		glm::vec2 flatVector(glm::vec3 vec);
 		void move(glm::vec3 target);
+		//The next point of queuedPath, asks for a new path when it is used up. False while there is no path.
+		bool nextQueuedPoint(glm::vec3& nextPos);
+		void queueRay(int ray, const glm::vec3& from, const glm::vec3& to);
+		//The line of sight check of executeTransforms, with the sight ray of the last tick
+		void updateRange();
+		//The movement and rotation of executeTransforms, and the pending damage
+		void applyMovement();
+		void applyPendingDamage();
 		virtual bool refreshRequiredComponents();
 		virtual unsigned int idleState(float dt);
 		virtual unsigned int searchingState(float dt);
@@ -97,7 +139,9 @@ namespace Hydra::Physics::Behaviour {
 		AlienBehaviour(std::shared_ptr<Hydra::World::Entity> enemy);
 		AlienBehaviour();
 		~AlienBehaviour();
-		void run(float dt);
+		void think(float dt) final;
+		void act(float dt) final;
+		void run(float dt) final;
 
 		unsigned int attackingState(float dt) final;
 	};
@@ -108,7 +152,9 @@ namespace Hydra::Physics::Behaviour {
 		RobotBehaviour(std::shared_ptr<Hydra::World::Entity> enemy);
 		RobotBehaviour();
 		~RobotBehaviour();
-		void run(float dt);
+		void think(float dt) final;
+		void act(float dt) final;
+		void run(float dt) final;
 		unsigned int idleState(float dt) final;
 		unsigned int attackingState(float dt) final;
 	private:
@@ -154,6 +200,8 @@ namespace Hydra::Physics::Behaviour {
 
 		void run(float dt);
 		void move(glm::vec3 target);
+		//The next point of queuedPath, asks for a new path when it is used up. False while there is no path.
+		bool nextQueuedPoint(glm::vec3& nextPos);
 
 		unsigned int idleState(float dt) final;
 		unsigned int smashState(float dt);
@@ -0,0 +1,91 @@
+/**
+* Flow fields, shared by every enemy that chases the same target
+*
+* License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+* Authors:
+*  - Dan Printzell
+*/
+
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <atomic>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include <hydra/world/world.hpp>
+#include <hydra/component/roomcomponent.hpp>
+#include <hydra/pathing/pathmap.hpp>
+
+//The distance from every tile of the pathing map to the target, and the direction to walk from each tile.
+//It is only recomputed when the target moves to another tile, and then only out to maxDistance.
+class HYDRA_PHYSICS_API FlowField final
+{
+public:
+	//In tiles, about twice as far as enemies start chasing from. Enemies further away walk straight at the target.
+	static constexpr float DEFAULT_MAX_DISTANCE = 96.0f;
+
+	FlowField(float maxDistance = DEFAULT_MAX_DISTANCE);
+
+	//The field for a target, created the first time it is asked for
+	static std::shared_ptr<FlowField> get(Hydra::World::EntityID target);
+	//Call when the level changes, the fields that are still held stay valid
+	static void clearAll();
+
+	//Returns true if the field was recomputed. Don't call while PathQueue is computing the field.
+	bool update(const glm::vec3& targetPos, const PathMap* map);
+	//Where to walk next from worldPos, the corner of the next tile like PathFinding::pathToEnd. False if the target
+	//can't be reached from there.
+	bool next(const glm::vec3& worldPos, glm::vec3& nextPos) const;
+	//In tiles, INFINITY if the target can't be reached
+	float distance(const glm::vec3& worldPos) const;
+	//Follows the field from worldPos, the same points as PathFinding::pathToEnd with the target first
+	void trace(const glm::vec3& worldPos, std::vector<glm::vec3>& path, size_t maxSteps = 1000) const;
+
+	inline size_t getUpdateCount() const { return _updates; }
+	inline size_t getTilesVisited() const { return _visited; }
+	//PathQueue is computing a new field, the old one is used until it is done
+	inline bool isPending() const { return _pending; }
+
+private:
+	friend class PathQueue;
+
+	//The field that is read and the one that is computed. PathQueue computes into the back layer on a worker thread
+	//while the enemies keep walking on the front one, and swaps them on the main thread.
+	struct Layer
+	{
+		const PathMap* map = nullptr;
+		glm::ivec2 target = glm::ivec2(-1);
+		bool hasTarget = false;
+
+		//A tile is only part of the field if its generation matches, so nothing has to be cleared between updates
+		std::vector<float> cost = std::vector<float>(WORLD_MAP_SIZE * WORLD_MAP_SIZE, INFINITY);
+		std::vector<uint32_t> generation = std::vector<uint32_t>(WORLD_MAP_SIZE * WORLD_MAP_SIZE, 0);
+		std::vector<int8_t> direction = std::vector<int8_t>(WORLD_MAP_SIZE * WORLD_MAP_SIZE, -1);
+		uint32_t currentGeneration = 0;
+		size_t visited = 0;
+
+		inline bool inField(int32_t idx) const { return generation[idx] == currentGeneration; }
+	};
+
+	float _maxDistance;
+	Layer _layers[2];
+	size_t _front = 0;
+	//Set by the first enemy that asks for an update, enemies think on many threads at once
+	std::atomic<bool> _pending{false};
+	std::vector<std::pair<float, int32_t>> _heap;
+
+	size_t _updates = 0;
+	size_t _visited = 0;
+
+	inline const Layer& _frontLayer() const { return _layers[_front]; }
+	inline Layer& _backLayer() { return _layers[_front ^ 1]; }
+
+	static bool _isOpen(const PathMap* map, const glm::ivec2& tile);
+	//The tile to compute the field from, false if it is the one the field already has
+	bool _needsUpdate(const glm::vec3& targetPos, const PathMap* map, glm::ivec2& target) const;
+	bool _nextTile(glm::ivec2 tile, glm::ivec2& next) const;
+	//Only touches the back layer and the heap
+	void _compute(const PathMap* map, const glm::ivec2& target);
+	void _swap();
+};
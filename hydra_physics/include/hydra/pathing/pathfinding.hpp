@@ -15,6 +15,7 @@
 #include <math.h>
 #include <algorithm>
 #include <hydra/component/roomcomponent.hpp>
+#include <hydra/pathing/pathmap.hpp>
 
 class HYDRA_PHYSICS_API PathFinding
 {
@@ -96,12 +97,26 @@ public:
 	bool prePathfinding(MapVec origin, MapVec target);
 	static void setRoomGrid(std::shared_ptr<Hydra::Component::RoomComponent> roomGrid[ROOM_GRID_SIZE][ROOM_GRID_SIZE]);
 
+	//ROOM CACHE
+	//The route between every pair of rooms and the tile path between every pair of doors in a room, built from roomGrid
+	//once the level is generated. findPath only searches the first two and the last two rooms when it searches the same
+	//map.
+	static void buildRoomCache(const PathMap* map);
+	//Call after changing the doors of a room, room is the position in roomGrid. The doors only change while
+	//TileGeneration builds the level, before the cache is built, so nothing calls it yet.
+	static void onDoorChanged(const glm::ivec2& room);
+	static void clearRoomCache();
+
 	//PATHING
 	std::vector<glm::vec3> pathToEnd = std::vector<glm::vec3>();
-	std::vector<Node*> visitedList = std::vector<Node*>();
-	std::vector<Node*> openList = std::vector<Node*>();
-	bool** map = nullptr;
+	//Tiles of the last search, only used by the AI inspector
+	std::vector<MapVec> visitedList = std::vector<MapVec>();
+	std::vector<MapVec> openList = std::vector<MapVec>();
+	const PathMap* map = nullptr;
 	bool foundGoal = false;
+	//How many tiles one search of the whole level may visit before it gives up. The searches inside the rooms of a
+	//cached route are only limited by the size of the rooms.
+	size_t maxVisited = 1000;
 
 	bool findPath(glm::vec3 currentPos, glm::vec3 targetPos);
 	bool inLineOfSight(const glm::vec3& enemyPos, const glm::vec3& targetPos) const;
@@ -126,13 +141,21 @@ private:
 	//PREPATHING
 	Node* originNode = nullptr;
 	Node* targetNode = nullptr;
+	Node _roomNodes[ROOM_GRID_SIZE * ROOM_GRID_SIZE];
+	Node _roomTargetNode;
 	void _discoverPrePathNode(int x, int z, Node* lastNode, size_t oppositeDir);
 
 	//PATHING
-	Node* _startNode = nullptr;
-	Node* _endNode = nullptr;
-
 	bool isOutOfBounds(const glm::ivec2& vec) const;
 	bool _inLineOfSight(const MapVec enemyPos, const MapVec playerPos) const;
-	void _discoverNode(int x, int z, Node* lastNode);
+	//A* inside the rooms that are set in roomPathMap, path gets the tiles from end to start
+	bool _searchTiles(const glm::ivec2& start, const glm::ivec2& end, size_t visitLimit, std::vector<glm::ivec2>& path);
+	//A* inside the rooms, path gets the tiles from start to end added
+	bool _searchRooms(const glm::ivec2& start, const glm::ivec2& end, const glm::ivec2* rooms, size_t roomCount, std::vector<glm::ivec2>& path);
+	bool _findCachedPath(const glm::ivec2& start, const glm::ivec2& end);
+
+	//ROOM CACHE
+	static void _buildDoors(const glm::ivec2& room);
+	static void _buildRoutes();
+	static void _buildSegments(const glm::ivec2& room);
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+/**
+* The walkable tiles of the level, one bit per tile
+*
+* License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+* Authors:
+*  - Dan Printzell
+*/
+
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <hydra/component/roomcomponent.hpp>
+
+//Tiles are [x][z] like in PathFinding. Every x is a row of bits along z packed into 64 bit words, and a transposed copy
+//has a row along x for every z, so a straight run of tiles along either axis is only a few word tests.
+class HYDRA_PHYSICS_API PathMap final
+{
+public:
+	static constexpr size_t WORDS_PER_ROW = (WORLD_MAP_SIZE + 63) / 64;
+	static constexpr size_t ROW_BYTES = (WORLD_MAP_SIZE + 7) / 8;
+	static constexpr size_t BYTE_SIZE = WORLD_MAP_SIZE * ROW_BYTES;
+
+	//Every tile is a wall
+	PathMap();
+
+	static inline bool inBounds(const glm::ivec2& tile) { return tile.x >= 0 && tile.y >= 0 && tile.x < WORLD_MAP_SIZE && tile.y < WORLD_MAP_SIZE; }
+	//The bounds are not checked
+	inline bool get(int x, int z) const { return (_rows[x * WORDS_PER_ROW + z / 64] >> (z % 64)) & 1; }
+	//Outside of the map is a wall
+	inline bool isOpen(const glm::ivec2& tile) const { return inBounds(tile) && get(tile.x, tile.y); }
+	inline void set(int x, int z, bool open)
+	{
+		_setBit(_rows[x * WORDS_PER_ROW + z / 64], z % 64, open);
+		_setBit(_columns[z * WORDS_PER_ROW + x / 64], x % 64, open);
+	}
+	void clear();
+	size_t countOpen() const;
+
+	//True if every tile from first to last (inclusive, in any order) along z in row x is open. The bounds are not checked.
+	bool isRowOpen(int x, int first, int last) const;
+	//The same along x, for column z
+	bool isColumnOpen(int z, int first, int last) const;
+	//True if every tile on the Bresenham line between the tiles is open, both ends included
+	bool lineOfSight(const glm::ivec2& from, const glm::ivec2& to) const;
+
+	//BYTE_SIZE bytes, bit (z % 8) of byte (x * ROW_BYTES + z / 8) is set if the tile is open
+	std::vector<uint8_t> toBytes() const;
+	bool fromBytes(const uint8_t* data, size_t size);
+
+private:
+	std::vector<uint64_t> _rows;
+	std::vector<uint64_t> _columns;
+
+	static inline void _setBit(uint64_t& word, int bit, bool value)
+	{
+		word = (word & ~(uint64_t(1) << bit)) | (uint64_t(value) << bit);
+	}
+	//first <= last
+	static inline bool _isRunOpen(const uint64_t* row, int first, int last)
+	{
+		const int firstWord = first / 64;
+		const int lastWord = last / 64;
+		const uint64_t firstMask = ~uint64_t(0) << (first % 64);
+		const uint64_t lastMask = ~uint64_t(0) >> (63 - last % 64);
+		if (firstWord == lastWord)
+			return (row[firstWord] & firstMask & lastMask) == (firstMask & lastMask);
+		if ((row[firstWord] & firstMask) != firstMask || (row[lastWord] & lastMask) != lastMask)
+			return false;
+		for (int i = firstWord + 1; i < lastWord; i++)
+			if (row[i] != ~uint64_t(0))
+				return false;
+		return true;
+	}
+};
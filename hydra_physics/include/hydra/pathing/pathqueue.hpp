@@ -0,0 +1,98 @@
+/**
+* Pathfinding on worker threads
+*
+* License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+* Authors:
+*  - Dan Printzell
+*/
+
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <condition_variable>
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <hydra/pathing/flowfield.hpp>
+
+//Searches that are too slow to run inside AISystem::tick. The behaviours queue them and pick up the result on a later
+//tick, so a tick only pays for the queueing no matter how many enemies want a new path at the same time.
+//Every worker has its own PathFinding, the map and the room cache must not change while a search is running (see clear).
+class HYDRA_PHYSICS_API PathQueue final
+{
+public:
+	typedef uint64_t Ticket;
+	static constexpr Ticket INVALID_TICKET = 0;
+	//Flow fields are always computed before the path requests
+	enum class Priority { LOW, NORMAL, HIGH, FIELD };
+
+	//threads is the number of worker threads, SIZE_MAX picks it from the CPU count
+	PathQueue(size_t threads = SIZE_MAX);
+	~PathQueue();
+	PathQueue(const PathQueue&) = delete;
+	PathQueue& operator=(const PathQueue&) = delete;
+
+	//The queue that the behaviours use
+	static PathQueue& instance();
+
+	//PathFinding::findPath from start to end, that gives up after visiting maxVisited tiles
+	Ticket request(const glm::vec3& start, const glm::vec3& end, const PathMap* map, Priority priority = Priority::NORMAL, size_t maxVisited = 1000);
+	//True once the search is done, then path gets PathFinding::pathToEnd and the ticket can't be polled again.
+	//found is false if there is no path or the search ran out of tiles.
+	bool poll(Ticket ticket, std::vector<glm::vec3>& path, bool& found);
+	//Drops the request, or its result if it is already done
+	void cancel(Ticket ticket);
+
+	//Computes the field again on a worker if the target has moved to another tile, the old field is used until then.
+	//Returns false if the field is up to date or already being computed.
+	bool updateField(const std::shared_ptr<FlowField>& field, const glm::vec3& targetPos, const PathMap* map);
+	//Swaps in the fields that are done. Call on the main thread once per tick, before anything reads them.
+	void update();
+
+	//Drops every request and waits for the running ones, call before the map or the room grid is changed or freed
+	void clear();
+
+	inline size_t getThreadCount() const { return _workers.size(); }
+	size_t getQueuedCount();
+
+private:
+	struct Job final
+	{
+		Priority priority;
+		uint64_t order;
+		Ticket ticket;
+		glm::vec3 start;
+		glm::vec3 end;
+		const PathMap* map;
+		size_t maxVisited;
+		std::shared_ptr<FlowField> field;
+		glm::ivec2 target;
+	};
+	struct Result final
+	{
+		bool done = false;
+		bool found = false;
+		std::vector<glm::vec3> path;
+	};
+
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::condition_variable _idle;
+	//A heap with the highest priority and then the oldest job at the front
+	std::vector<Job> _jobs;
+	//Every ticket that is queued, running or done, a cancelled one is removed so its result is thrown away
+	std::unordered_map<Ticket, Result> _results;
+	std::vector<std::shared_ptr<FlowField>> _doneFields;
+	std::vector<std::shared_ptr<FlowField>> _swapping;
+	Ticket _nextTicket = INVALID_TICKET + 1;
+	uint64_t _order = 0;
+	size_t _running = 0;
+	bool _quit = false;
+
+	void _push(Job&& job);
+	void _worker();
+};
@@ -0,0 +1,39 @@
+/**
+* Room to room potentially visible set
+*
+* License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+* Authors:
+*  - Dan Printzell
+*/
+
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <bitset>
+#include <memory>
+#include <vector>
+#include <hydra/component/roomcomponent.hpp>
+#include <hydra/pathing/pathmap.hpp>
+
+//Rooms are indexed with gridPosition.y * ROOM_GRID_SIZE + gridPosition.x
+class HYDRA_PHYSICS_API PVS final
+{
+public:
+	static constexpr size_t ROOM_COUNT = ROOM_GRID_SIZE * ROOM_GRID_SIZE;
+	static constexpr size_t BYTE_SIZE = (ROOM_COUNT * ROOM_COUNT + 7) / 8;
+
+	//The room borders are walls, except where pathfindingMap is walkable on them (the doors).
+	//Two rooms see each other if a line between a door tile of each room doesn't pass through a wall.
+	static PVS compute(std::shared_ptr<Hydra::Component::RoomComponent> roomGrid[ROOM_GRID_SIZE][ROOM_GRID_SIZE], const PathMap* pathfindingMap);
+
+	static inline size_t roomIndex(const glm::ivec2& gridPosition) { return gridPosition.y * ROOM_GRID_SIZE + gridPosition.x; }
+	inline bool isVisible(size_t fromRoom, size_t toRoom) const { return _visible[fromRoom * ROOM_COUNT + toRoom]; }
+	void setVisible(size_t roomA, size_t roomB, bool visible = true);
+
+	//BYTE_SIZE bytes, bit (fromRoom * ROOM_COUNT + toRoom) is set if the rooms see each other
+	std::vector<uint8_t> toBytes() const;
+	bool fromBytes(const uint8_t* data, size_t size);
+
+private:
+	std::bitset<ROOM_COUNT * ROOM_COUNT> _visible;
+};
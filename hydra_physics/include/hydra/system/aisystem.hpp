@@ -1,6 +1,12 @@
 #pragma once
 
+#include <vector>
 #include <hydra/world/world.hpp>
+#include <hydra/system/bulletphysicssystem.hpp>
+
+namespace Hydra::Physics::Behaviour {
+	class Behaviour;
+}
 
 namespace Hydra::System {
 	class HYDRA_PHYSICS_API AISystem final : public Hydra::World::ISystem {
@@ -11,5 +17,15 @@ namespace Hydra::System {
 		void tick(float delta) final;
 		inline const std::string type() const final { return "AISystem"; }
 		void registerUI() final;
+
+	private:
+		// Enemies per chunk of the think phase
+		static constexpr size_t THINK_GRAIN_SIZE = 16;
+
+		Hydra::World::Query<Hydra::Component::AIComponent, Hydra::Component::TransformComponent, Hydra::Component::LifeComponent> _enemies;
+		std::vector<Hydra::Physics::Behaviour::Behaviour*> _behaviours;
+		// Keep their memory between the ticks
+		std::vector<BulletPhysicsSystem::Ray> _rays;
+		std::vector<BulletPhysicsSystem::RayHit> _rayHits;
 	};
 }
@@ -51,9 +51,35 @@ namespace Hydra::System {
 			bossHandCollidesWith = COLL_WALL | COLL_MISC_OBJECT | COLL_PLAYER | COLL_PLAYER_PROJECTILE | COLL_FLOOR, COLL_ENEMY*/
 		};
 
+		// The closest thing a ray hit, see rayTest
+		struct RayHit final {
+			Hydra::World::EntityID entity;
+			glm::vec3 point;
+			glm::vec3 normal;
+			float fraction; // How far along the ray, 0 is at from and 1 at to
+			int collisionType; // The CollisionTypes of what was hit
+		};
+
+		// One ray of a batch, group and mask are the filter of Bullet like in rayTest.
+		// The defaults hit everything, like the single threaded rayTestFromTo used to.
+		struct Ray final {
+			glm::vec3 from;
+			glm::vec3 to;
+			int group = 1; // btBroadphaseProxy::DefaultFilter
+			int mask = -1; // btBroadphaseProxy::AllFilter
+		};
+
 		BulletPhysicsSystem();
 		~BulletPhysicsSystem() final;
 
+		// 0 (the default) steps the world on the thread that ticks the system. Anything else steps it with
+		// btDiscreteDynamicsWorldMt on that many threads, counting the one that ticks, SIZE_MAX picks it from the CPU count.
+		// The bodies that are in the world are moved over to the new one. Don't call it while the system is ticking.
+		void setThreadCount(size_t threads);
+		inline size_t getThreadCount() const { return _threads; }
+		// Milliseconds that stepSimulation took in the last tick
+		inline float getStepTime() const { return _stepTime; }
+
 		void enable(RigidBodyComponent* component);
 
 		void disable(RigidBodyComponent* component);
@@ -61,7 +87,25 @@ namespace Hydra::System {
 		void enable(GhostObjectComponent* component);
 		void disable(GhostObjectComponent* component);
 
-		void* rayTestFromTo(const glm::vec3& from, const glm::vec3& to);
+		// The mask of what a body in the collision group can collide with, the same as enable() gives the bodies
+		static int collidesWith(int group);
+
+		// Only hits what a body in the collision group can collide with, see CollisionCondition. Doesn't allocate.
+		bool rayTest(const glm::vec3& from, const glm::vec3& to, int group, RayHit& hit) const;
+		// With the filter of Bullet, group is what the ray is and mask is what it can hit
+		bool rayTest(const glm::vec3& from, const glm::vec3& to, int group, int mask, RayHit& hit) const;
+		// Tests count rays into hits[0..count). A ray that misses gets World::invalidID as its entity and a fraction of 1,
+		// a hit always has a fraction below 1. Returns how many hit. Doesn't allocate. parallel splits the rays over the WorkerPool, the world must not be
+		// stepped or changed while the rays are tested either way.
+		size_t rayTest(const Ray* rays, size_t count, RayHit* hits, bool parallel = false) const;
+		// Every ray tested since the counters were reset, from all threads
+		size_t getRayCount() const;
+		size_t getRayHitCount() const;
+		void resetRayCounters();
+
+		// The damage of a bullet that hit target at point, with the headshot bonus, the floating text and the blood.
+		// Does nothing if target doesn't have a LifeComponent.
+		void applyBulletHit(Hydra::World::Entity* target, float damage, const glm::vec3& point, const glm::vec3& normal);
 
 		void tick(float delta) final;
 
@@ -70,10 +114,23 @@ namespace Hydra::System {
 
 
 	private:
+		// Rays per chunk of a parallel rayTest
+		static constexpr size_t RAY_GRAIN_SIZE = 64;
+
 		void _spawnParticleEmitterAt(const glm::vec3& pos, const glm::vec3& normal, const Hydra::Component::ParticleComponent::ParticleTexture& effect);
 		void _spawnText(const glm::vec3& pos, const std::string& text, const glm::vec3& color = { 1,1,1 }, const glm::vec3& scale = {1,1,1});
 		void _addPickUp(PickUpComponent* puc, PerkComponent* pec);
 		struct Data;
+		// The user pointer of every collision object in the world, see bulletphysicssystem.cpp
+		struct Body;
+		struct ContactEvent;
 		Data* _data;
+		size_t _threads = 0;
+		float _stepTime = 0;
+
+		void _createWorld();
+		void _collectContacts();
+		void _handleContacts();
+		void _applyBulletHit(Body& target, float damage, const glm::vec3& point, const glm::vec3& normal);
 	};
 }
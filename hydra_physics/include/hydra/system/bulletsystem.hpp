@@ -9,8 +9,13 @@ namespace Hydra::System {
 		~BulletSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		inline const std::string type() const final { return "BulletSystem"; }
 		void registerUI() final;
+
+	private:
+		Hydra::World::Query<Hydra::Component::WeaponComponent> _weapons;
+		Hydra::World::Query<Hydra::Component::BulletComponent> _bullets;
 	};
 }
@@ -8,12 +8,15 @@ namespace Hydra::System {
 		~LifeSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		inline const std::string type() const final { return "LifeSystem"; }
 		void registerUI() final;
 
+		// Filled in when the commands are applied, so it is only complete after JobGraph::run
 		inline const std::vector<Hydra::World::EntityID>& isKilled() { return _isKilled; }
 	private:
 		std::vector<Hydra::World::EntityID> _isKilled;
+		Hydra::World::Query<Hydra::Component::LifeComponent> _lives;
 	};
 }
\ No newline at end of file
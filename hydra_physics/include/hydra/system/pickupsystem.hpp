@@ -9,6 +9,7 @@ namespace Hydra::System {
 		~PickUpSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 
 		inline const std::string type() const final { return "PlayerSystem"; }
 		void registerUI() final;
@@ -0,0 +1,101 @@
+/**
+ * Moves the bullets that the weapons fire, without an entity or a rigid body for every bullet.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#pragma once
+#include <hydra/ext/api.hpp>
+
+#include <mutex>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <json.hpp>
+#include <hydra/world/world.hpp>
+#include <hydra/system/bulletphysicssystem.hpp>
+
+namespace Hydra::System {
+	// One bullet as it leaves the weapon
+	struct HYDRA_PHYSICS_API Projectile final {
+		glm::vec3 position = glm::vec3(0);
+		glm::vec3 direction = glm::vec3(0, 0, 1);
+		glm::quat rotation = glm::quat();
+		float velocity = 0.0f;
+		float damage = 6.0f;
+		float size = 0.5f;
+		float lifetime = 10.0f; // Seconds
+		int collisionType = BulletPhysicsSystem::COLL_PLAYER_PROJECTILE;
+		int meshType = 0; // Index into ProjectileSystem::meshes
+		glm::vec3 colour = glm::vec3(0);
+		bool glow = true;
+		float glowIntensity = 1.0f;
+
+		// Everything except where it is and where it is going, that is sent in the shoot packets
+		void serialize(nlohmann::json& json) const;
+		void deserialize(const nlohmann::json& json);
+	};
+
+	// The bullets are kept in one array per field. Every tick each bullet casts a ray from where it is to where it will
+	// be, against the same groups its rigid body used to collide with, so fast bullets can't go through thin walls.
+	// The rays of all bullets are tested as one batch on the WorkerPool.
+	// What it hits gets the damage like a BulletComponent would give in BulletPhysicsSystem, and the bullet is removed.
+	class HYDRA_PHYSICS_API ProjectileSystem final : public Hydra::World::ISystem {
+	public:
+		static constexpr int MESH_COUNT = 6;
+		static const char* const meshes[MESH_COUNT];
+
+		ProjectileSystem(BulletPhysicsSystem& physics);
+		~ProjectileSystem() final;
+
+		// Can be called from any thread, the bullet is added on the next tick
+		void fire(const Projectile& projectile);
+		// Drops every bullet, also the ones that have not been added yet
+		void clear();
+
+		void tick(float delta) final;
+
+		inline const std::string type() const final { return "ProjectileSystem"; }
+		void registerUI() final;
+
+		// The bullets that are flying, for the renderer. Only read them when the system is not ticking.
+		inline size_t size() const { return _positions.size(); }
+		inline const std::vector<glm::vec3>& getPositions() const { return _positions; }
+		inline const std::vector<glm::quat>& getRotations() const { return _rotations; }
+		inline const std::vector<float>& getSizes() const { return _sizes; }
+		inline const std::vector<uint8_t>& getMeshTypes() const { return _meshTypes; }
+		inline const std::vector<glm::vec4>& getColours() const { return _colours; } // w is the glow intensity, 0 if it doesn't glow
+
+		inline size_t getHitCount() const { return _hits; }
+
+	private:
+		std::mutex _firedMutex;
+		std::vector<Projectile> _fired;
+
+		BulletPhysicsSystem& _physics;
+		std::vector<Projectile> _adding;
+
+		// Hot, read every tick
+		std::vector<glm::vec3> _positions;
+		std::vector<glm::vec3> _velocities;
+		std::vector<float> _lifetimes;
+		std::vector<int> _collisionTypes;
+		// Cold, only read when it hits something or is drawn
+		std::vector<glm::quat> _rotations;
+		std::vector<float> _sizes;
+		std::vector<float> _damages;
+		std::vector<uint8_t> _meshTypes;
+		std::vector<glm::vec4> _colours;
+
+		// The batch of the last tick, kept so it doesn't allocate every tick
+		std::vector<BulletPhysicsSystem::Ray> _rays;
+		std::vector<BulletPhysicsSystem::RayHit> _rayHits;
+
+		size_t _hits = 0;
+
+		void _add(const Projectile& projectile);
+		// Moves the last bullet into i
+		void _remove(size_t i);
+	};
+}
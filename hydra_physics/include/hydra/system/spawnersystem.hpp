@@ -6,6 +6,7 @@
 namespace Hydra::System {
 	class HYDRA_PHYSICS_API SpawnerSystem final : public Hydra::World::ISystem{
 	public:
+		// Filled in when the commands are applied, so it is only complete after JobGraph::run
 		std::vector<Hydra::World::Entity*> didJustSpawn;	
 
 		Hydra::Component::WeaponComponent::onShoot_f onShoot;
@@ -15,6 +16,7 @@ namespace Hydra::System {
 		~SpawnerSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 		inline const std::string type() const final { return "SpawnerSystem"; }
 		void registerUI() final;
 	};
@@ -18,33 +18,33 @@ using namespace Hydra::World;
 
 namespace Hydra::Component::ComponentManager {
 	void registerComponents_physics(std::map<std::string, createOrGetComponent_f>& creators) {
-		PlayerComponent::componentHandler = new ComponentHandler<PlayerComponent>();
+		PlayerComponent::componentHandler = new ComponentHandler<PlayerComponent>("PlayerComponent");
 		creators["PlayerComponent"] = &createOrGetComponentHelper<PlayerComponent>;
-		AIComponent::componentHandler = new ComponentHandler<AIComponent>();
+		AIComponent::componentHandler = new ComponentHandler<AIComponent>("AIComponent");
 		creators["AIComponent"] = &createOrGetComponentHelper<AIComponent>;
-		RigidBodyComponent::componentHandler = new ComponentHandler<RigidBodyComponent>();
+		RigidBodyComponent::componentHandler = new ComponentHandler<RigidBodyComponent>("RigidBodyComponent");
 		creators["RigidBodyComponent"] = &createOrGetComponentHelper<RigidBodyComponent>;
-		WeaponComponent::componentHandler = new ComponentHandler<WeaponComponent>();
+		WeaponComponent::componentHandler = new ComponentHandler<WeaponComponent>("WeaponComponent");
 		creators["WeaponComponent"] = &createOrGetComponentHelper<WeaponComponent>;
-		BulletComponent::componentHandler = new ComponentHandler<BulletComponent>();
+		BulletComponent::componentHandler = new ComponentHandler<BulletComponent>("BulletComponent");
 		creators["BulletComponent"] = &createOrGetComponentHelper<BulletComponent>;
-		GrenadeComponent::componentHandler = new ComponentHandler<GrenadeComponent>();
+		GrenadeComponent::componentHandler = new ComponentHandler<GrenadeComponent>("GrenadeComponent");
 		creators["GrenadeComponent"] = &createOrGetComponentHelper<GrenadeComponent>;
-		MineComponent::componentHandler = new ComponentHandler<MineComponent>();
+		MineComponent::componentHandler = new ComponentHandler<MineComponent>("MineComponent");
 		creators["MineComponent"] = &createOrGetComponentHelper<MineComponent>;
-		LifeComponent::componentHandler = new ComponentHandler<LifeComponent>();
+		LifeComponent::componentHandler = new ComponentHandler<LifeComponent>("LifeComponent");
 		creators["LifeComponent"] = &createOrGetComponentHelper<LifeComponent>;
-		MovementComponent::componentHandler = new ComponentHandler<MovementComponent>();
+		MovementComponent::componentHandler = new ComponentHandler<MovementComponent>("MovementComponent");
 		creators["MovementComponent"] = &createOrGetComponentHelper<MovementComponent>;
-		SpawnerComponent::componentHandler = new ComponentHandler<SpawnerComponent>();
+		SpawnerComponent::componentHandler = new ComponentHandler<SpawnerComponent>("SpawnerComponent");
 		creators["SpawnerComponent"] = &createOrGetComponentHelper<SpawnerComponent>;
-		PerkComponent::componentHandler = new ComponentHandler<PerkComponent>();
+		PerkComponent::componentHandler = new ComponentHandler<PerkComponent>("PerkComponent");
 		creators["PerkComponent"] = &createOrGetComponentHelper<PerkComponent>;
-		PickUpComponent::componentHandler = new ComponentHandler<PickUpComponent>();
+		PickUpComponent::componentHandler = new ComponentHandler<PickUpComponent>("PickUpComponent");
 		creators["PickUpComponent"] = &createOrGetComponentHelper<PickUpComponent>;
-		GhostObjectComponent::componentHandler = new ComponentHandler<GhostObjectComponent>();
+		GhostObjectComponent::componentHandler = new ComponentHandler<GhostObjectComponent>("GhostObjectComponent");
 		creators["GhostObjectComponent"] = &createOrGetComponentHelper<GhostObjectComponent>;
-		SpawnPointComponent::componentHandler = new ComponentHandler<SpawnPointComponent>();
+		SpawnPointComponent::componentHandler = new ComponentHandler<SpawnPointComponent>("SpawnPointComponent");
 		creators["SpawnPointComponent"] = &createOrGetComponentHelper<SpawnPointComponent>;
 	}
 }
@@ -8,10 +8,7 @@
 *  - Dan Printzell
 */
 #include <hydra/component/weaponcomponent.hpp>
-#include <hydra/component/rigidbodycomponent.hpp>
-#include <hydra/component/cameracomponent.hpp>
-#include <hydra/component/meshcomponent.hpp>
-#include <btBulletDynamicsCommon.h>
+#include <hydra/world/commandbuffer.hpp>
 #include <hydra/engine.hpp>
 
 #include <imgui/imgui.h>
@@ -64,7 +61,13 @@ void WeaponComponent::resetReload() {
 	this->reloadTime = 0;
 }
 
-//TODO: (Re)move? to system?
+// Index into ProjectileSystem::meshes
+static int bulletMesh(int meshType, bool spread) {
+	// Single bullets fall back to the duck, spread shots to the rock
+	const int fallback = spread ? 5 : 4;
+	return (meshType < 0 || meshType > fallback) ? fallback : meshType;
+}
+
 bool WeaponComponent::shoot(glm::vec3 position, glm::vec3 direction, glm::quat bulletOrientation, float velocity, Hydra::System::BulletPhysicsSystem::CollisionTypes collisionType) {
 	if (fireRateTimer > 0)
 		return false;
@@ -76,103 +79,53 @@ bool WeaponComponent::shoot(glm::vec3 position, glm::vec3 direction, glm::quat b
 		currmagammo -= this->ammoPerShot;
 	}
 
-	if (bulletSpread == 0.0f) {
-		auto bullet = world::newEntity("Bullet", world::rootID);
-		if(meshType == 0)
-			bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Bullet.mATTIC");
-		else if (meshType == 1)
-			bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Star.mATTIC");
-		else if (meshType == 2)
-			bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Trident.mATTIC");
-		else if (meshType == 3)
-			bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Banana.mATTIC");
-		else
-			bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Duck.mATTIC");
-
-		auto b = bullet->addComponent<Hydra::Component::BulletComponent>();
-		b->direction = direction;
-		b->velocity = velocity;
-		b->damage = damage;
-		b->colour[0] = color[0];
-		b->colour[1] = color[1];
-		b->colour[2] = color[2];
-		b->glow = glow;
-		b->glowIntensity = glowIntensity;
-		auto t = bullet->addComponent<Hydra::Component::TransformComponent>();
-		t->position = position;
-		t->scale = glm::vec3(bulletSize);
-		t->setRotation(bulletOrientation);
-
-		auto bulletPhysWorld = static_cast<Hydra::System::BulletPhysicsSystem*>(IEngine::getInstance()->getState()->getPhysicsSystem());
-
-		auto rbc = bullet->addComponent<Hydra::Component::RigidBodyComponent>();
-
-		rbc->createBox(glm::vec3(1.0f) * bulletSize, glm::vec3(0), collisionType, 0.0095f);
-		auto rigidBody = static_cast<btRigidBody*>(rbc->getRigidBody());
-		bulletPhysWorld->enable(rbc.get());
-		rigidBody->setActivationState(DISABLE_DEACTIVATION);
-		rigidBody->setLinearVelocity(btVector3(b->direction.x, b->direction.y, b->direction.z) * velocity);
-		rigidBody->setGravity(btVector3(0, 0, 0));
-		rbc->setAngularForce(glm::vec3(0));
-
-		//Network shoot
-		if (onShoot)
-			onShoot(*this, bullet.get(), userdata);
-		//end Network shoot
-	} else {
-		for (int i = 0; i < bulletsPerShot; i++) {
-			auto bullet = world::newEntity("Bullet", world::rootID);
-			if (meshType == 0)
-				bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Bullet.mATTIC");
-			else if (meshType == 1)
-				bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Star.mATTIC");
-			else if (meshType == 2)
-				bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Trident.mATTIC");
-			else if (meshType == 3)
-				bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Banana.mATTIC");
-			else if (meshType == 4)
-				bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Duck.mATTIC");
-			else if (meshType == 5)
-				bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Rock.mATTIC");
-			else
-				bullet->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/Rock.mATTIC");
-
-			float phi = ((float)rand() / (float)(RAND_MAX)) * (2.0f*3.14f);
-			float distance = ((float)rand() / (float)(RAND_MAX)) * bulletSpread;
-			float theta = ((float)rand() / (float)(RAND_MAX)) * 3.14f;
-
-			glm::vec3 bulletDirection = direction;
+	auto projectiles = static_cast<Hydra::System::ProjectileSystem*>(Hydra::IEngine::getInstance()->getState()->getProjectileSystem());
+	// The enemies shoot from the AI worker threads, rand() would be shared between them
+	static thread_local std::mt19937 rng(std::random_device{}());
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	const bool spread = bulletSpread != 0.0f;
+	const int bullets = spread ? bulletsPerShot : 1;
+	for (int i = 0; i < bullets; i++) {
+		glm::vec3 bulletDirection = direction;
+		if (spread) {
+			float phi = unit(rng) * (2.0f*3.14f);
+			float distance = unit(rng) * bulletSpread;
+			float theta = unit(rng) * 3.14f;
+
 			bulletDirection.x += distance * sin(theta) * cos(phi);
 			bulletDirection.y += distance * sin(theta) * sin(phi);
 			bulletDirection.z += distance * cos(theta);
 			bulletDirection = glm::normalize(bulletDirection);
+		}
 
-			auto b = bullet->addComponent<Hydra::Component::BulletComponent>();
-			b->direction = bulletDirection;
-			b->velocity = velocity;
-			b->damage = damage;
-
-			auto t = bullet->addComponent<Hydra::Component::TransformComponent>();
-			t->position = position;
-			t->scale = glm::vec3(bulletSize);
-			t->setRotation(bulletOrientation);
-
-			auto bulletPhysWorld = static_cast<Hydra::System::BulletPhysicsSystem*>(IEngine::getInstance()->getState()->getPhysicsSystem());
-
-			auto rbc = bullet->addComponent<Hydra::Component::RigidBodyComponent>();
-			rbc->createBox(glm::vec3(1.0f) * bulletSize, glm::vec3(0), collisionType, 0.0095f);
-			auto rigidBody = static_cast<btRigidBody*>(rbc->getRigidBody());
-			bulletPhysWorld->enable(rbc.get());
-			rigidBody->setActivationState(DISABLE_DEACTIVATION);
-			rigidBody->setLinearVelocity(btVector3(b->direction.x, b->direction.y, b->direction.z) * velocity);
-			rbc->setAngularForce(glm::vec3(0));
-			rigidBody->setGravity(btVector3(0,0,0));
-
-			//Network shoot
-			if (onShoot)
-				onShoot(*this, bullet.get(), userdata);
-			//end Network shoot
+		Hydra::System::Projectile bullet;
+		bullet.position = position;
+		bullet.direction = bulletDirection;
+		bullet.rotation = bulletOrientation;
+		bullet.velocity = velocity;
+		bullet.damage = damage;
+		bullet.size = bulletSize;
+		bullet.collisionType = collisionType;
+		bullet.meshType = bulletMesh(meshType, spread);
+		if (!spread) {
+			bullet.colour = glm::vec3(color[0], color[1], color[2]);
+			bullet.glow = glow;
+			bullet.glowIntensity = glowIntensity;
 		}
+		if (projectiles)
+			projectiles->fire(bullet);
+
+		//Network shoot, when the commands are applied so that the packets are sent from the main thread
+		if (onShoot) {
+			const EntityID owner = entityID;
+			world::commands().defer([owner, bullet]() {
+				if (auto ownerEntity = world::getEntity(owner))
+					if (auto weapon = ownerEntity->getComponent<WeaponComponent>(); weapon && weapon->onShoot)
+						weapon->onShoot(*weapon, bullet, weapon->userdata);
+			});
+		}
+		//end Network shoot
 	}
 	fireRateTimer = 1.0f/(fireRateRPM / 60.0f);
 	return true;
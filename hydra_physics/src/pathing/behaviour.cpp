@@ -29,6 +29,7 @@ Behaviour::Behaviour()
 
 Behaviour::~Behaviour()
 {
+	PathQueue::instance().cancel(pathTicket);
 	delete pathFinding;
 }
 
@@ -41,6 +42,7 @@ void Behaviour::setEnemyEntity(std::shared_ptr<Hydra::World::Entity> enemy)
 void Behaviour::setTargetPlayer(std::shared_ptr<Hydra::World::Entity> player)
 {
 	targetPlayer.entity = player.get();
+	flowField = FlowField::get(player->id);
 	targetPlayer.life = player->getComponent<Hydra::Component::LifeComponent>().get();
 	targetPlayer.transform = player->getComponent<Hydra::Component::TransformComponent>().get();
 }
@@ -59,6 +61,26 @@ void Behaviour::move(glm::vec3 target)
 
 	rotation = glm::angleAxis(atan2(direction.x, direction.y), glm::vec3(0, 1, 0));
 }
+bool Behaviour::nextQueuedPoint(glm::vec3& nextPos)
+{
+	PathQueue& queue = PathQueue::instance();
+	if (pathTicket != PathQueue::INVALID_TICKET)
+	{
+		bool found;
+		if (queue.poll(pathTicket, queuedPath, found))
+			pathTicket = PathQueue::INVALID_TICKET;
+	}
+	else if (queuedPath.empty())
+		pathTicket = queue.request(thisEnemy.transform->position, targetPlayer.transform->position, pathFinding->map);
+
+	//Like pathToEnd, the target is first
+	while (!queuedPath.empty() && glm::length(flatVector(queuedPath.back()) - flatVector(thisEnemy.transform->position)) < 1.0f)
+		queuedPath.pop_back();
+	if (queuedPath.empty())
+		return false;
+	nextPos = queuedPath.back();
+	return true;
+}
 //Sets all components without setting new entities, use after adding new components to either entity
 bool Behaviour::refreshRequiredComponents()
 {
@@ -105,7 +127,9 @@ unsigned int Behaviour::searchingState(float dt)
 		return ATTACKING;
 	}
 
-	pathFinding->findPath(thisEnemy.transform->position, targetPlayer.transform->position);
+	//The old path leads to where the player was
+	queuedPath.clear();
+	PathQueue::instance().updateField(flowField, targetPlayer.transform->position, pathFinding->map);
 	doDiddeliDoneDatPathfinding = true;
 	newPathTimer = 0.0f;
 	return MOVING;
@@ -123,49 +147,23 @@ unsigned int Behaviour::movingState(float dt)
 		return ATTACKING;
 	}
 
+	//The field only changes when the player walks onto another tile, then the first enemy to notice queues an update
+	//and everyone walks on the old field until it is done
+	glm::vec3 nextPos;
+	PathQueue::instance().updateField(flowField, targetPlayer.transform->position, pathFinding->map);
 	//If enemy can see the player, move toward them
 	if (pathFinding->inLineOfSight(thisEnemy.transform->position, targetPlayer.transform->position))
 	{
 		move(targetPlayer.transform->position);
 	}
-	//If there is nowhere to go, search (prob not needed, should always have a goal here)
-	if (!pathFinding->pathToEnd.empty())
+	//If there is nowhere to go, search
+	else if (flowField && flowField->next(thisEnemy.transform->position, nextPos))
 	{
-		//std::cout << pathFinding->pathToEnd.back().x << " " << pathFinding->pathToEnd.back().z << std::endl;
-		//Made these as the code got very hard to read otherwise
-		float distEnemyToNextPos = glm::distance((thisEnemy.transform->position), (pathFinding->pathToEnd.back()));
-		float distEnemyToGoal = glm::distance((thisEnemy.transform->position), (pathFinding->pathToEnd.front()));
-		float distPlayerToGoal = glm::distance((targetPlayer.transform->position), (pathFinding->pathToEnd.front()));
-
-		//Check that the goal is closer to the player than we are, otherwise the path is invalid
-		if (distPlayerToGoal < distEnemyToPlayer)
-		{
-			//If the next pos is reached move on
-			if (distEnemyToNextPos <= 1.0f)
-			{
-				pathFinding->pathToEnd.pop_back();
-				//If there is nowhere to go, search
-
-				if (pathFinding->pathToEnd.empty())
-				{
-					move(targetPlayer.transform->position);
-					return SEARCHING;
-				}
-				else
-				{
-					move(pathFinding->pathToEnd.back());
-				}
-			}
-			else
-			{
-				move(pathFinding->pathToEnd.back());
-			}
-		}
-		else
-		{
-			move(targetPlayer.transform->position);
-			return SEARCHING;
-		}
+		move(nextPos);
+	}
+	else if (nextQueuedPoint(nextPos))
+	{
+		move(nextPos);
 	}
 	else
 	{
@@ -198,7 +196,7 @@ unsigned int Behaviour::attackingState(float dt)
 		std::uniform_int_distribution<> randDmg(thisEnemy.ai->damage - 1, thisEnemy.ai->damage + 2);
 		if (attackTimer > 2.5)
 		{
-			targetPlayer.life->applyDamage(randDmg(rng));
+			pendingDamage += randDmg(rng);
 			attackTimer = 0;
 		}
 
@@ -209,15 +207,30 @@ unsigned int Behaviour::attackingState(float dt)
 }
 
 void Behaviour::executeTransforms()
+{
+	updateRange();
+	if (rays[SIGHT_RAY].queued)
+	{
+		//Nothing else tests the ray when run is called outside of AISystem
+		if (auto physics = static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem()))
+			resolveRays(*physics);
+	}
+	applyMovement();
+}
+
+void Behaviour::updateRange()
 {
 	//Line of sight check
 	//If AI dont have vision to shoot at player, move closer
 	if (glm::length(thisEnemy.transform->position - targetPlayer.transform->position) < 40.0f)
 	{
-		auto callback = static_cast<btCollisionWorld::ClosestRayResultCallback*>(static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem())->rayTestFromTo(glm::vec3(thisEnemy.transform->position.x, thisEnemy.transform->position.y + 1.8, thisEnemy.transform->position.z), targetPlayer.transform->position));
+		queueRay(SIGHT_RAY, glm::vec3(thisEnemy.transform->position.x, thisEnemy.transform->position.y + 1.8, thisEnemy.transform->position.z), targetPlayer.transform->position);
+		const RayQuery& sight = rays[SIGHT_RAY];
+		if (!sight.done)
+			return;
 		if (targetPlayer.transform->position.y < 5.0f)
 		{
-			if (callback->hasHit() && callback->m_collisionObject->getUserIndex2() == Hydra::System::BulletPhysicsSystem::COLL_WALL)
+			if (sight.hit && sight.hitType == Hydra::System::BulletPhysicsSystem::COLL_WALL)
 			{
 				if (range > 3)
 				{
@@ -227,20 +240,22 @@ void Behaviour::executeTransforms()
 			}
 		}
 
-		if (callback->hasHit() && callback->m_collisionObject->getUserIndex2() == Hydra::System::BulletPhysicsSystem::COLL_PLAYER)
+		if (sight.hit && sight.hitType == Hydra::System::BulletPhysicsSystem::COLL_PLAYER)
 		{
 			if (regainRange > 1.5)
 			{
 				range = originalRange;
 			}
 		}
-		delete callback;
 	}
 	else
 	{
 		range = originalRange;
 	}
+}
 
+void Behaviour::applyMovement()
+{
 	auto rigidBody = static_cast<btRigidBody*>(thisEnemy.rigidBody->getRigidBody());
 	glm::vec3 movementForce = thisEnemy.movement->velocity;
 	//if (movementForce.x = 0 && movementForce.y == 0 && movementForce.z == 0)
@@ -257,6 +272,58 @@ void Behaviour::executeTransforms()
 	thisEnemy.transform->setRotation(rotation);
 }
 
+void Behaviour::applyPendingDamage()
+{
+	if (pendingDamage && targetPlayer.life)
+		targetPlayer.life->applyDamage(pendingDamage);
+	pendingDamage = 0;
+}
+
+void Behaviour::queueRay(int ray, const glm::vec3& from, const glm::vec3& to)
+{
+	rays[ray].from = from;
+	rays[ray].to = to;
+	rays[ray].queued = true;
+}
+
+void Behaviour::resolveRays(const Hydra::System::BulletPhysicsSystem& physics)
+{
+	Hydra::System::BulletPhysicsSystem::Ray queued[RAY_COUNT];
+	Hydra::System::BulletPhysicsSystem::RayHit hits[RAY_COUNT];
+	size_t count = 0;
+	for (const RayQuery& ray : rays)
+		if (ray.queued)
+			queued[count++] = Hydra::System::BulletPhysicsSystem::Ray{ray.from, ray.to};
+	physics.rayTest(queued, count, hits);
+	resolveRays(hits);
+}
+
+void Behaviour::collectRays(std::vector<Hydra::System::BulletPhysicsSystem::Ray>& out) const
+{
+	for (const RayQuery& ray : rays)
+		if (ray.queued)
+			out.push_back(Hydra::System::BulletPhysicsSystem::Ray{ray.from, ray.to});
+}
+
+size_t Behaviour::resolveRays(const Hydra::System::BulletPhysicsSystem::RayHit* hits)
+{
+	size_t used = 0;
+	for (RayQuery& ray : rays)
+	{
+		ray.done = ray.queued;
+		ray.hit = false;
+		ray.hitType = 0;
+		if (ray.queued)
+		{
+			const Hydra::System::BulletPhysicsSystem::RayHit& hit = hits[used++];
+			ray.hit = hit.fraction < 1.0f;
+			ray.hitType = hit.collisionType;
+		}
+		ray.queued = false;
+	}
+	return used;
+}
+
 void Behaviour::resetAnimationOnStart(int animationIndex) {
 	//When starting a new animation, use this to reset the keyframe to 0
 	//This prevents animations to start in the middle of the animation
@@ -267,7 +334,7 @@ void Behaviour::resetAnimationOnStart(int animationIndex) {
 	thisEnemy.entity->getComponent<Hydra::Component::MeshComponent>()->animationIndex = animationIndex;
 }
 
-void Behaviour::setPathMap(bool** map)
+void Behaviour::setPathMap(const PathMap* map)
 {
 	pathFinding->map = map;
 }
@@ -287,6 +354,22 @@ AlienBehaviour::~AlienBehaviour()
 }
 
 void AlienBehaviour::run(float dt)
+{
+	think(dt);
+	if (auto physics = static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem()))
+		resolveRays(*physics);
+	act(dt);
+}
+
+void AlienBehaviour::act(float dt)
+{
+	if (!hasRequiredComponents)
+		return;
+	applyPendingDamage();
+	applyMovement();
+}
+
+void AlienBehaviour::think(float dt)
 {
 	//If all components haven't been found, try to find them and abort if one or more do not exist
 	if (!hasRequiredComponents)
@@ -303,17 +386,17 @@ void AlienBehaviour::run(float dt)
 	if (glm::length(thisEnemy.transform->position - targetPlayer.transform->position) < 35)
 	{
 		if (pathFinding->inWall(targetPlayer.transform->position)){
-		auto callback = static_cast<btCollisionWorld::ClosestRayResultCallback*>(static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem())->rayTestFromTo(targetPlayer.transform->position, targetPlayer.transform->position + glm::vec3(0,-2.0,0)));
+		queueRay(FLOOR_RAY, targetPlayer.transform->position, targetPlayer.transform->position + glm::vec3(0,-2.0,0));
+		const RayQuery& floor = rays[FLOOR_RAY];
 
-		if (callback->hasHit() && callback->m_collisionObject->getUserIndex2() == Hydra::System::BulletPhysicsSystem::COLL_WALL){
+		if (floor.done && floor.hit && floor.hitType == Hydra::System::BulletPhysicsSystem::COLL_WALL){
 			playerUnreachable = true;
 			originalRange = 10;
 		}
-		else if (callback->hasHit() && callback->m_collisionObject->getUserIndex2() != Hydra::System::BulletPhysicsSystem::COLL_WALL){
+		else if (floor.done && floor.hit && floor.hitType != Hydra::System::BulletPhysicsSystem::COLL_WALL){
 			playerUnreachable = false;
 			originalRange = savedRange;
 		}
-		delete callback;
 		}
 		else{
 			playerUnreachable = false;
@@ -345,7 +428,7 @@ void AlienBehaviour::run(float dt)
 		state = attackingState(dt);
 		break;
 	}
-	executeTransforms();
+	updateRange();
 }
 
 unsigned int AlienBehaviour::attackingState(float dt)
@@ -378,7 +461,7 @@ unsigned int AlienBehaviour::attackingState(float dt)
 			}
 			else
 			{
-				targetPlayer.life->applyDamage(randDmg(rng));
+				pendingDamage += randDmg(rng);
 				attackTimer = 0;
 			}
 		}
@@ -402,6 +485,22 @@ RobotBehaviour::~RobotBehaviour()
 }
 
 void RobotBehaviour::run(float dt)
+{
+	think(dt);
+	if (auto physics = static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem()))
+		resolveRays(*physics);
+	act(dt);
+}
+
+void RobotBehaviour::act(float dt)
+{
+	if (!hasRequiredComponents)
+		return;
+	applyPendingDamage();
+	applyMovement();
+}
+
+void RobotBehaviour::think(float dt)
 {
 	//If all components haven't been found, try to find them and abort if one or more do not exist
 	//thisEnemy.entity->getComponent<Hydra::Component::MeshComponent>()->animationIndex = 0;
@@ -441,7 +540,7 @@ void RobotBehaviour::run(float dt)
 		state = attackingState(dt);
 		break;
 	}
-	executeTransforms();
+	updateRange();
 }
 
 unsigned int RobotBehaviour::idleState(float dt)
@@ -0,0 +1,229 @@
+/**
+* Flow fields, shared by every enemy that chases the same target
+*
+* License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+* Authors:
+*  - Dan Printzell
+*/
+
+#include <hydra/pathing/flowfield.hpp>
+#include <hydra/pathing/pathfinding.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <glm/gtc/constants.hpp>
+
+namespace {
+	//Every direction is next to its opposite, so i ^ 1 turns around
+	const glm::ivec2 directions[8] = {
+		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, //East, West, North, South
+		{ -1, 1 }, { 1, -1 }, { 1, 1 }, { -1, -1 } //North West, South East, North East, South West
+	};
+
+	struct Registry
+	{
+		std::mutex mutex;
+		std::unordered_map<Hydra::World::EntityID, std::shared_ptr<FlowField>> fields;
+	};
+
+	Registry& registry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	//The heap is ordered so that the lowest cost is at the front
+	bool heapOrder(const std::pair<float, int32_t>& a, const std::pair<float, int32_t>& b)
+	{
+		return a.first > b.first;
+	}
+}
+
+FlowField::FlowField(float maxDistance) : _maxDistance(maxDistance) {}
+
+std::shared_ptr<FlowField> FlowField::get(Hydra::World::EntityID target)
+{
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	auto& field = r.fields[target];
+	if (!field)
+		field = std::make_shared<FlowField>();
+	return field;
+}
+
+void FlowField::clearAll()
+{
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	r.fields.clear();
+}
+
+bool FlowField::update(const glm::vec3& targetPos, const PathMap* map)
+{
+	glm::ivec2 target;
+	if (!_needsUpdate(targetPos, map, target))
+		return false;
+	_compute(map, target);
+	_swap();
+	return true;
+}
+
+bool FlowField::_needsUpdate(const glm::vec3& targetPos, const PathMap* map, glm::ivec2& target) const
+{
+	if (!map)
+		return false;
+
+	target = PathFinding::worldToMapCoords(targetPos).baseVec;
+	//Like PathFinding::findViableTile, the player may stand on the edge of a wall
+	if (!_isOpen(map, target))
+	{
+		for (int i = 1; i < 3 && !_isOpen(map, target); i++)
+			for (const glm::ivec2& dir : directions)
+				if (_isOpen(map, target + dir * i))
+				{
+					target += dir * i;
+					break;
+				}
+	}
+
+	const Layer& front = _frontLayer();
+	return !front.hasTarget || map != front.map || target != front.target;
+}
+
+bool FlowField::next(const glm::vec3& worldPos, glm::vec3& nextPos) const
+{
+	glm::ivec2 tile;
+	if (!_nextTile(PathFinding::worldToMapCoords(worldPos).baseVec, tile))
+		return false;
+	nextPos = PathFinding::mapToWorldCoords(PathFinding::MapVec(tile.x, tile.y));
+	return true;
+}
+
+bool FlowField::_nextTile(glm::ivec2 tile, glm::ivec2& best) const
+{
+	const Layer& front = _frontLayer();
+	if (!front.hasTarget)
+		return false;
+	if (tile == front.target)
+	{
+		best = tile;
+		return true;
+	}
+
+	if (tile.x >= 0 && tile.y >= 0 && tile.x < WORLD_MAP_SIZE && tile.y < WORLD_MAP_SIZE && front.inField(tile.x * WORLD_MAP_SIZE + tile.y))
+		best = tile + directions[front.direction[tile.x * WORLD_MAP_SIZE + tile.y]];
+	else
+	{
+		best = glm::ivec2(-1);
+		//Pushed into a wall, walk to the closest neighbour that is part of the field
+		float bestCost = INFINITY;
+		for (const glm::ivec2& dir : directions)
+		{
+			const glm::ivec2 pos = tile + dir;
+			if (pos.x < 0 || pos.y < 0 || pos.x >= WORLD_MAP_SIZE || pos.y >= WORLD_MAP_SIZE)
+				continue;
+			const int32_t idx = pos.x * WORLD_MAP_SIZE + pos.y;
+			if (front.inField(idx) && front.cost[idx] < bestCost)
+			{
+				bestCost = front.cost[idx];
+				best = pos;
+			}
+		}
+		if (best.x < 0)
+			return false;
+	}
+	return true;
+}
+
+float FlowField::distance(const glm::vec3& worldPos) const
+{
+	const Layer& front = _frontLayer();
+	const glm::ivec2 tile = PathFinding::worldToMapCoords(worldPos).baseVec;
+	if (!front.hasTarget || tile.x < 0 || tile.y < 0 || tile.x >= WORLD_MAP_SIZE || tile.y >= WORLD_MAP_SIZE)
+		return INFINITY;
+	const int32_t idx = tile.x * WORLD_MAP_SIZE + tile.y;
+	return front.inField(idx) ? front.cost[idx] : INFINITY;
+}
+
+void FlowField::trace(const glm::vec3& worldPos, std::vector<glm::vec3>& path, size_t maxSteps) const
+{
+	path.clear();
+	glm::ivec2 tile = PathFinding::worldToMapCoords(worldPos).baseVec;
+	for (size_t i = 0; i < maxSteps && _nextTile(tile, tile); i++)
+	{
+		path.push_back(PathFinding::mapToWorldCoords(PathFinding::MapVec(tile.x, tile.y)));
+		if (tile == _frontLayer().target)
+			break;
+	}
+	std::reverse(path.begin(), path.end());
+}
+
+bool FlowField::_isOpen(const PathMap* map, const glm::ivec2& tile)
+{
+	return map && map->isOpen(tile);
+}
+
+void FlowField::_swap()
+{
+	_front ^= 1;
+	_updates++;
+	_visited = _frontLayer().visited;
+}
+
+//Dijkstra outwards from the target, with the same step costs as PathFinding::findPath
+void FlowField::_compute(const PathMap* map, const glm::ivec2& target)
+{
+	Layer& layer = _backLayer();
+	layer.map = map;
+	layer.target = target;
+	layer.hasTarget = true;
+	layer.visited = 0;
+	if (++layer.currentGeneration == 0)
+	{
+		std::fill(layer.generation.begin(), layer.generation.end(), 0);
+		layer.currentGeneration = 1;
+	}
+	if (!_isOpen(map, target))
+		return;
+
+	const int32_t targetIdx = target.x * WORLD_MAP_SIZE + target.y;
+	layer.generation[targetIdx] = layer.currentGeneration;
+	layer.cost[targetIdx] = 0;
+	layer.direction[targetIdx] = -1;
+	_heap.clear();
+	_heap.emplace_back(0.0f, targetIdx);
+
+	while (!_heap.empty())
+	{
+		std::pop_heap(_heap.begin(), _heap.end(), heapOrder);
+		const float cost = _heap.back().first;
+		const int32_t current = _heap.back().second;
+		_heap.pop_back();
+		//Already reached with a lower cost
+		if (cost > layer.cost[current])
+			continue;
+		layer.visited++;
+
+		const glm::ivec2 currentPos(current / WORLD_MAP_SIZE, current % WORLD_MAP_SIZE);
+		for (int8_t i = 0; i < 8; i++)
+		{
+			const glm::ivec2 pos = currentPos + directions[i];
+			if (!_isOpen(map, pos))
+				continue;
+			const float G = cost + (directions[i].x && directions[i].y ? glm::root_two<float>() : 1.0f);
+			if (G > _maxDistance)
+				continue;
+			const int32_t idx = pos.x * WORLD_MAP_SIZE + pos.y;
+			if (layer.inField(idx) && layer.cost[idx] <= G)
+				continue;
+			layer.generation[idx] = layer.currentGeneration;
+			layer.cost[idx] = G;
+			//Walking from pos towards current is the opposite direction
+			layer.direction[idx] = i ^ 1;
+			_heap.emplace_back(G, idx);
+			std::push_heap(_heap.begin(), _heap.end(), heapOrder);
+		}
+	}
+}
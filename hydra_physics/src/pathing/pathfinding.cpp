@@ -9,25 +9,148 @@
 */
 
 #include <hydra/pathing/pathfinding.hpp>
-std::shared_ptr<Hydra::Component::RoomComponent> PathFinding::roomGrid[ROOM_GRID_SIZE][ROOM_GRID_SIZE];
-PathFinding::PathFinding() {
-	openList = std::vector<Node*>();
-	visitedList = std::vector<Node*>();
-	foundGoal = true;
-}
+#include <glm/gtc/constants.hpp>
+
+namespace {
+	//The state of one map tile during a search. A tile is only valid if its generation matches the current search,
+	//so nothing has to be cleared between searches.
+	struct SearchNode
+	{
+		float G;
+		float H;
+		int32_t lastNode;
+		uint32_t generation;
+		uint32_t heapIndex;
+		bool closed;
+	};
+
+	//Every tile of the world map is preallocated, and the open list is a binary heap of tile indices
+	struct SearchPool
+	{
+		std::vector<SearchNode> nodes = std::vector<SearchNode>(WORLD_MAP_SIZE * WORLD_MAP_SIZE, SearchNode{0, 0, -1, 0, 0, false});
+		std::vector<int32_t> heap;
+		uint32_t generation = 0;
+		//For building the paths without allocating
+		std::vector<glm::ivec2> path;
+		std::vector<glm::ivec2> local;
+
+		SearchPool() { heap.reserve(WORLD_MAP_SIZE * WORLD_MAP_SIZE); }
+
+		void begin()
+		{
+			heap.clear();
+			if (++generation == 0)
+			{
+				for (auto& node : nodes)
+					node.generation = 0;
+				generation = 1;
+			}
+		}
+
+		bool less(int32_t a, int32_t b) const { return nodes[a].G + nodes[a].H < nodes[b].G + nodes[b].H; }
+
+		void siftUp(uint32_t i)
+		{
+			int32_t node = heap[i];
+			while (i > 0)
+			{
+				uint32_t parent = (i - 1) / 2;
+				if (!less(node, heap[parent]))
+					break;
+				heap[i] = heap[parent];
+				nodes[heap[i]].heapIndex = i;
+				i = parent;
+			}
+			heap[i] = node;
+			nodes[node].heapIndex = i;
+		}
+
+		void siftDown(uint32_t i)
+		{
+			int32_t node = heap[i];
+			const uint32_t size = heap.size();
+			while (true)
+			{
+				uint32_t child = i * 2 + 1;
+				if (child >= size)
+					break;
+				if (child + 1 < size && less(heap[child + 1], heap[child]))
+					child++;
+				if (!less(heap[child], node))
+					break;
+				heap[i] = heap[child];
+				nodes[heap[i]].heapIndex = i;
+				i = child;
+			}
+			heap[i] = node;
+			nodes[node].heapIndex = i;
+		}
+
+		void push(int32_t node)
+		{
+			heap.push_back(node);
+			siftUp(heap.size() - 1);
+		}
+
+		int32_t pop()
+		{
+			int32_t top = heap.front();
+			heap.front() = heap.back();
+			heap.pop_back();
+			if (!heap.empty())
+				siftDown(0);
+			return top;
+		}
+	};
+
+	//One pool per thread, it is too big to have one per PathFinding
+	SearchPool& searchPool()
+	{
+		static thread_local SearchPool pool;
+		return pool;
+	}
 
-PathFinding::~PathFinding() {
-	for (auto&& node : openList)
+	//See PathFinding::buildRoomCache. Rooms are indexed with x * ROOM_GRID_SIZE + z like _roomNodes, and the directions
+	//are the same as RoomComponent::door.
+	struct RoomCache
+	{
+		static constexpr size_t ROOM_COUNT = ROOM_GRID_SIZE * ROOM_GRID_SIZE;
+		static constexpr glm::ivec2 offsets[4] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } }; //North, East, South, West
+
+		static size_t index(const glm::ivec2& room) { return room.x * ROOM_GRID_SIZE + room.y; }
+		static glm::ivec2 position(size_t index) { return glm::ivec2(index / ROOM_GRID_SIZE, index % ROOM_GRID_SIZE); }
+		static bool inGrid(const glm::ivec2& room) { return room.x >= 0 && room.y >= 0 && room.x < ROOM_GRID_SIZE && room.y < ROOM_GRID_SIZE; }
+
+		const PathMap* map = nullptr;
+		//The first direction to go from a room to reach another room, -1 if it can't be reached
+		int8_t next[ROOM_COUNT][ROOM_COUNT];
+		//The tile inside the room by each door, x is -1 if the rooms are not connected there
+		glm::ivec2 doors[ROOM_COUNT][4];
+		//The tiles from one door to another inside a room, empty if there is no path
+		std::vector<glm::ivec2> segments[ROOM_COUNT][4][4];
+	};
+	constexpr glm::ivec2 RoomCache::offsets[4];
+
+	RoomCache& roomCache()
 	{
-		delete node;
+		static RoomCache cache;
+		return cache;
 	}
-	for (auto&& node : visitedList)
+
+	//Same distance as Node::hDistanceTo
+	float heuristic(const glm::ivec2& from, const glm::ivec2& to)
 	{
-		delete node;
+		return abs(from.x - to.x + abs(from.y - to.y));
 	}
-	delete _endNode;
 }
 
+std::shared_ptr<Hydra::Component::RoomComponent> PathFinding::roomGrid[ROOM_GRID_SIZE][ROOM_GRID_SIZE];
+PathFinding::PathFinding() {
+	foundGoal = true;
+}
+
+PathFinding::~PathFinding() {}
+
 bool PathFinding::prePathfinding(MapVec origin, MapVec target)
 {
 	for (int i = 0; i < ROOM_GRID_SIZE; i++)
@@ -51,8 +174,8 @@ bool PathFinding::prePathfinding(MapVec origin, MapVec target)
 		return false;
 	}
 
-	originNode = new Node(origin.x(), origin.z(), nullptr);
-	targetNode = new Node(target.x(), target.z(), nullptr);
+	originNode = &(_roomNodes[origin.x() * ROOM_GRID_SIZE + origin.z()] = Node(origin.x(), origin.z(), nullptr));
+	targetNode = &(_roomTargetNode = Node(target.x(), target.z(), nullptr));
 
 	originNode->H = originNode->hDistanceTo(targetNode);
 	roomOpenList.push_back(originNode);
@@ -141,7 +264,7 @@ void PathFinding::_discoverPrePathNode(int x, int z, Node* lastNode, size_t oppo
 	//This node hasn't been found before, add it to the open list
 	if (thisNode == nullptr)
 	{
-		thisNode = new Node(x, z, lastNode);
+		thisNode = &(_roomNodes[x * ROOM_GRID_SIZE + z] = Node(x, z, lastNode));
 		thisNode->G = INFINITY;
 		thisNode->H = INFINITY;
 		roomOpenList.push_back(thisNode);
@@ -186,6 +309,14 @@ bool PathFinding::findPath(glm::vec3 currentPos, glm::vec3 targetPos)
 	mapCurrentPos = worldToMapCoords(currentPos);
 	mapTargetPos = worldToMapCoords(targetPos);
 	
+	//The cached routes are only for the map they were built from. If the start or the end room is split in two by its
+	//own walls the cached path may not exist, then the whole level is searched instead.
+	if (roomCache().map == map && _findCachedPath(mapCurrentPos.baseVec, mapTargetPos.baseVec))
+		return true;
+	openList.clear();
+	visitedList.clear();
+	pathToEnd.clear();
+
 	if (!prePathfinding(mapCurrentPos, mapTargetPos))
 	{
 		std::cout << "WARNING NO PREPATHING PATH FOUND, IS AI OUTSIDE OF MAP?" << std::endl;
@@ -194,58 +325,290 @@ bool PathFinding::findPath(glm::vec3 currentPos, glm::vec3 targetPos)
 	if (isOutOfBounds(mapCurrentPos.baseVec) || isOutOfBounds(mapTargetPos.baseVec))
 		return false;
 
-	_startNode = new Node(mapCurrentPos.x(), mapCurrentPos.z(), nullptr);
-	_endNode = new Node(mapTargetPos.x(), mapTargetPos.z(), nullptr);
+	std::vector<glm::ivec2>& path = searchPool().path;
+	path.clear();
+	_searchTiles(mapCurrentPos.baseVec, mapTargetPos.baseVec, maxVisited, path);
+	for (const glm::ivec2& tile : path)
+		pathToEnd.push_back(mapToWorldCoords(MapVec(tile.x, tile.y)));
+	return foundGoal;
+}
 
-	_startNode->H = _startNode->hDistanceTo(_endNode);
-	openList.push_back(_startNode);
+bool PathFinding::_searchTiles(const glm::ivec2& start, const glm::ivec2& end, size_t visitLimit, std::vector<glm::ivec2>& path)
+{
+	static const glm::ivec2 directions[8] = {
+		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, //East, West, North, South
+		{ -1, 1 }, { 1, 1 }, { -1, -1 }, { 1, -1 } //North West, North East, South West, South East
+	};
 
-	foundGoal = false;
+	SearchPool& pool = searchPool();
+	pool.begin();
+	const int32_t startIdx = start.x * WORLD_MAP_SIZE + start.y;
+	pool.nodes[startIdx] = SearchNode{0.0f, heuristic(start, end), -1, pool.generation, 0, false};
+	pool.push(startIdx);
 
+	foundGoal = false;
+	const size_t visitedLimit = visitedList.size() + visitLimit;
 
-	while (!openList.empty() && !foundGoal && visitedList.size() < 1000)
+	while (!pool.heap.empty() && !foundGoal && visitedList.size() < visitedLimit)
 	{
-		Node* currentNode = openList.back();
-		visitedList.push_back(openList.back());
-		openList.pop_back();
+		const int32_t current = pool.pop();
+		const glm::ivec2 currentPos(current / WORLD_MAP_SIZE, current % WORLD_MAP_SIZE);
+		pool.nodes[current].closed = true;
+		visitedList.push_back(MapVec(currentPos.x, currentPos.y));
 
 		//End reached
-		if (currentNode->pos == _endNode->pos)
+		if (currentPos == end)
 		{
-			_endNode->lastNode = currentNode->lastNode;
+			for (int32_t node = current; node != -1; node = pool.nodes[node].lastNode)
+				path.push_back(glm::ivec2(node / WORLD_MAP_SIZE, node % WORLD_MAP_SIZE));
+			foundGoal = true;
+			break;
+		}
 
-			Node* getPath = _endNode;
+		//Navigate map
+		const float currentG = pool.nodes[current].G;
+		for (const glm::ivec2& dir : directions)
+		{
+			const glm::ivec2 pos = currentPos + dir;
+			if (isOutOfBounds(pos))
+				continue;
 
-			while (getPath != nullptr)
+			const int32_t idx = pos.x * WORLD_MAP_SIZE + pos.y;
+			SearchNode& node = pool.nodes[idx];
+			const float G = currentG + (dir.x && dir.y ? glm::root_two<float>() : 1.0f);
+			//This node hasn't been found before, add it to the open list
+			if (node.generation != pool.generation)
 			{
-				pathToEnd.push_back(mapToWorldCoords(getPath->pos));
-				getPath = getPath->lastNode;
+				node = SearchNode{G, heuristic(pos, end), current, pool.generation, 0, false};
+				pool.push(idx);
+			}
+			//If this is a better path than previously, replace the old path values
+			else if (!node.closed && G < node.G)
+			{
+				node.G = G;
+				node.lastNode = current;
+				pool.siftUp(node.heapIndex);
 			}
-			foundGoal = true;
-			return true;
 		}
-		//Navigate map
-		else
+	}
+
+	for (int32_t node : pool.heap)
+		openList.push_back(MapVec(node / WORLD_MAP_SIZE, node % WORLD_MAP_SIZE));
+	return foundGoal;
+}
+
+bool PathFinding::_searchRooms(const glm::ivec2& start, const glm::ivec2& end, const glm::ivec2* rooms, size_t roomCount, std::vector<glm::ivec2>& path)
+{
+	for (int i = 0; i < ROOM_GRID_SIZE; i++)
+		for (int j = 0; j < ROOM_GRID_SIZE; j++)
+			roomPathMap[i][j] = false;
+	for (size_t i = 0; i < roomCount; i++)
+		roomPathMap[rooms[i].x][rooms[i].y] = true;
+
+	std::vector<glm::ivec2>& local = searchPool().local;
+	local.clear();
+	if (!_searchTiles(start, end, roomCount * ROOM_MAP_SIZE * ROOM_MAP_SIZE, local))
+		return false;
+	path.insert(path.end(), local.rbegin(), local.rend());
+	return true;
+}
+
+bool PathFinding::_findCachedPath(const glm::ivec2& start, const glm::ivec2& end)
+{
+	const RoomCache& cache = roomCache();
+	const auto inside = [this](const glm::ivec2& tile) {
+		return map->isOpen(tile);
+	};
+	if (!map || !inside(start) || !inside(end))
+		return false;
+
+	//The rooms from the start to the goal, and the direction each one is left through
+	glm::ivec2 rooms[RoomCache::ROOM_COUNT];
+	int exits[RoomCache::ROOM_COUNT];
+	size_t roomCount = 0;
+	glm::ivec2 room = start / ROOM_MAP_SIZE;
+	const glm::ivec2 goalRoom = end / ROOM_MAP_SIZE;
+	const size_t goalIdx = RoomCache::index(goalRoom);
+	while (true)
+	{
+		if (roomCount == RoomCache::ROOM_COUNT)
+			return false;
+		rooms[roomCount] = room;
+		if (room == goalRoom)
 		{
-			//East
-			_discoverNode(currentNode->pos.x() + 1, currentNode->pos.z(), currentNode);
-			//West
-			_discoverNode(currentNode->pos.x() - 1, currentNode->pos.z(), currentNode);
-			//North
-			_discoverNode(currentNode->pos.x(), currentNode->pos.z() + 1, currentNode);
-			//South
-			_discoverNode(currentNode->pos.x(), currentNode->pos.z() - 1, currentNode);
-			//North West
-			_discoverNode(currentNode->pos.x() - 1, currentNode->pos.z() + 1, currentNode);
-			//North East
-			_discoverNode(currentNode->pos.x() + 1, currentNode->pos.z() + 1, currentNode);
-			//South West
-			_discoverNode(currentNode->pos.x() - 1, currentNode->pos.z() - 1, currentNode);
-			//South East
-			_discoverNode(currentNode->pos.x() + 1, currentNode->pos.z() - 1, currentNode);
+			exits[roomCount++] = -1;
+			break;
+		}
+		const int dir = cache.next[RoomCache::index(room)][goalIdx];
+		if (dir < 0)
+			return false;
+		exits[roomCount++] = dir;
+		room += RoomCache::offsets[dir];
+	}
+
+	std::vector<glm::ivec2>& path = searchPool().path;
+	path.clear();
+	//The first two rooms are searched as one up to the door out of the second, so the path doesn't have to go through
+	//the door tile that the cache picked between them. The same for the last two rooms, and the rooms in between get
+	//the cached tiles from where they are entered to where they are left.
+	if (roomCount <= 3)
+	{
+		if (!_searchRooms(start, end, rooms, roomCount, path))
+			return false;
+	}
+	else
+	{
+		if (!_searchRooms(start, cache.doors[RoomCache::index(rooms[1])][exits[1]], rooms, 2, path))
+			return false;
+		for (size_t i = 2; i + 2 < roomCount; i++)
+		{
+			const auto& segment = cache.segments[RoomCache::index(rooms[i])][(exits[i - 1] + 2) % 4][exits[i]];
+			if (segment.empty())
+				return false;
+			path.insert(path.end(), segment.begin(), segment.end());
+		}
+		const size_t last = roomCount - 2;
+		if (!_searchRooms(cache.doors[RoomCache::index(rooms[last])][(exits[last - 1] + 2) % 4], end, rooms + last, 2, path))
+			return false;
+	}
+
+	for (auto it = path.rbegin(); it != path.rend(); ++it)
+		pathToEnd.push_back(mapToWorldCoords(MapVec(it->x, it->y)));
+	foundGoal = true;
+	return true;
+}
+
+void PathFinding::buildRoomCache(const PathMap* map)
+{
+	RoomCache& cache = roomCache();
+	cache.map = map;
+	for (int x = 0; x < ROOM_GRID_SIZE; x++)
+		for (int z = 0; z < ROOM_GRID_SIZE; z++)
+			_buildDoors(glm::ivec2(x, z));
+	_buildRoutes();
+	for (int x = 0; x < ROOM_GRID_SIZE; x++)
+		for (int z = 0; z < ROOM_GRID_SIZE; z++)
+			_buildSegments(glm::ivec2(x, z));
+}
+
+void PathFinding::onDoorChanged(const glm::ivec2& room)
+{
+	RoomCache& cache = roomCache();
+	if (!cache.map)
+		return;
+	_buildDoors(room);
+	_buildRoutes();
+	_buildSegments(room);
+	for (const glm::ivec2& offset : RoomCache::offsets)
+	{
+		const glm::ivec2 neighbour = room + offset;
+		if (RoomCache::inGrid(neighbour))
+			_buildSegments(neighbour);
+	}
+}
+
+void PathFinding::clearRoomCache()
+{
+	roomCache().map = nullptr;
+}
+
+//Finds the door tiles on the shared edge of the room and its neighbours, the pair that is closest to the middle
+void PathFinding::_buildDoors(const glm::ivec2& room)
+{
+	RoomCache& cache = roomCache();
+	const PathMap* map = cache.map;
+	for (int dir = 0; dir < 4; dir++)
+	{
+		const glm::ivec2 neighbour = room + RoomCache::offsets[dir];
+		const int opposite = (dir + 2) % 4;
+		const glm::ivec2 none(-1);
+		cache.doors[RoomCache::index(room)][dir] = none;
+		if (!RoomCache::inGrid(neighbour))
+			continue;
+		cache.doors[RoomCache::index(neighbour)][opposite] = none;
+
+		auto a = roomGrid[room.x][room.y];
+		auto b = roomGrid[neighbour.x][neighbour.y];
+		if (!a || !b || !a->door[dir] || !b->door[opposite])
+			continue;
+
+		//The tile in this room that is on the edge, and the direction along the edge
+		const glm::ivec2 offset = RoomCache::offsets[dir];
+		const glm::ivec2 along(offset.y != 0, offset.x != 0);
+		glm::ivec2 edge = room * ROOM_MAP_SIZE + along * (ROOM_MAP_SIZE / 2);
+		if (offset.x > 0)
+			edge.x += ROOM_MAP_SIZE - 1;
+		if (offset.y > 0)
+			edge.y += ROOM_MAP_SIZE - 1;
+
+		for (int i = 0; i <= ROOM_MAP_SIZE; i++)
+		{
+			//0, 1, -1, 2, -2...
+			const int step = (i + 1) / 2 * (i % 2 ? 1 : -1);
+			const glm::ivec2 tile = edge + along * step;
+			const glm::ivec2 other = tile + offset;
+			if ((tile - room * ROOM_MAP_SIZE) * along != glm::clamp((tile - room * ROOM_MAP_SIZE) * along, 0, ROOM_MAP_SIZE - 1))
+				continue;
+			if (map->get(tile.x, tile.y) && map->get(other.x, other.y))
+			{
+				cache.doors[RoomCache::index(room)][dir] = tile;
+				cache.doors[RoomCache::index(neighbour)][opposite] = other;
+				break;
+			}
+		}
+	}
+}
+
+//A breadth first search from every room over the doors, each room gets the direction of the first step toward it
+void PathFinding::_buildRoutes()
+{
+	RoomCache& cache = roomCache();
+	std::vector<glm::ivec2> queue;
+	for (size_t goal = 0; goal < RoomCache::ROOM_COUNT; goal++)
+	{
+		for (size_t room = 0; room < RoomCache::ROOM_COUNT; room++)
+			cache.next[room][goal] = -1;
+
+		queue.clear();
+		queue.push_back(RoomCache::position(goal));
+		for (size_t i = 0; i < queue.size(); i++)
+		{
+			const glm::ivec2 room = queue[i];
+			for (int dir = 0; dir < 4; dir++)
+			{
+				const glm::ivec2 neighbour = room + RoomCache::offsets[dir];
+				if (cache.doors[RoomCache::index(room)][dir].x < 0)
+					continue;
+				const size_t neighbourIdx = RoomCache::index(neighbour);
+				if (neighbourIdx == goal || cache.next[neighbourIdx][goal] >= 0)
+					continue;
+				cache.next[neighbourIdx][goal] = (dir + 2) % 4;
+				queue.push_back(neighbour);
+			}
+		}
+	}
+}
+
+void PathFinding::_buildSegments(const glm::ivec2& room)
+{
+	RoomCache& cache = roomCache();
+	const size_t roomIdx = RoomCache::index(room);
+	PathFinding search;
+	search.map = cache.map;
+	for (int from = 0; from < 4; from++)
+	{
+		for (int to = 0; to < 4; to++)
+		{
+			auto& segment = cache.segments[roomIdx][from][to];
+			segment.clear();
+			if (from == to || cache.doors[roomIdx][from].x < 0 || cache.doors[roomIdx][to].x < 0)
+				continue;
+			if (to < from)
+				segment.assign(cache.segments[roomIdx][to][from].rbegin(), cache.segments[roomIdx][to][from].rend());
+			else if (!search._searchRooms(cache.doors[roomIdx][from], cache.doors[roomIdx][to], &room, 1, segment))
+				segment.clear();
 		}
 	}
-	return false;
 }
 
 PathFinding::MapVec PathFinding::worldToMapCoords(const glm::vec3& worldPos)
@@ -269,7 +632,7 @@ bool PathFinding::isOutOfBounds(const glm::ivec2& vec) const
 		std::cout << "ERROR: NO PATHFINDING MAP\n";
 		return true;
 	}
-	if (map[vec.x][vec.y] == false)
+	if (!map->get(vec.x, vec.y))
 	{
 		return true;
 	}
@@ -295,7 +658,7 @@ bool PathFinding::inWall(const glm::vec3 mapPos) const
 	{
 		return false;
 	}
-	if (map[p.x()][p.z()] == 0)
+	if (!map->get(p.x(), p.z()))
 	{
 		return true;
 	}
@@ -311,21 +674,21 @@ glm::vec3 PathFinding::findViableTile(glm::vec3 mapPos) const
 
 	glm::vec3 newPos = mapPos;
 	for (int i = 0; i < 3; i++) {
-		if ((vec.x + i < WORLD_MAP_SIZE && vec.y < WORLD_MAP_SIZE && vec.x + i >= 0 && vec.y >= 0) && map[vec.x + i][vec.y] == 1)
+		if ((vec.x + i < WORLD_MAP_SIZE && vec.y < WORLD_MAP_SIZE && vec.x + i >= 0 && vec.y >= 0) && map->get(vec.x + i, vec.y))
 			newPos = glm::vec3(mapPos.x + i, mapPos.y, mapPos.z);
-		else if ((vec.x < WORLD_MAP_SIZE && vec.y + i < WORLD_MAP_SIZE && vec.x >= 0 && vec.y + i >= 0) && map[vec.x][vec.y + i] == 1)
+		else if ((vec.x < WORLD_MAP_SIZE && vec.y + i < WORLD_MAP_SIZE && vec.x >= 0 && vec.y + i >= 0) && map->get(vec.x, vec.y + i))
 			newPos = glm::vec3(mapPos.x, mapPos.y, mapPos.z + i);
-		else if ((vec.x - i < WORLD_MAP_SIZE && vec.y < WORLD_MAP_SIZE && vec.x - i >= 0 && vec.y >= 0) && map[vec.x - i][vec.y] == 1)
+		else if ((vec.x - i < WORLD_MAP_SIZE && vec.y < WORLD_MAP_SIZE && vec.x - i >= 0 && vec.y >= 0) && map->get(vec.x - i, vec.y))
 			newPos = glm::vec3(mapPos.x - i, mapPos.y, mapPos.z);
-		else if ((vec.x < WORLD_MAP_SIZE && vec.y - i < WORLD_MAP_SIZE && vec.x >= 0 && vec.y - i >= 0) && map[vec.x][vec.y - i] == 1)
+		else if ((vec.x < WORLD_MAP_SIZE && vec.y - i < WORLD_MAP_SIZE && vec.x >= 0 && vec.y - i >= 0) && map->get(vec.x, vec.y - i))
 			newPos = glm::vec3(mapPos.x + 1, mapPos.y, mapPos.z - i);
-		else if ((vec.x + i < WORLD_MAP_SIZE && vec.y + i < WORLD_MAP_SIZE && vec.x + i >= 0 && vec.y + i >= 0) && map[vec.x + i][vec.y + i] == 1)
+		else if ((vec.x + i < WORLD_MAP_SIZE && vec.y + i < WORLD_MAP_SIZE && vec.x + i >= 0 && vec.y + i >= 0) && map->get(vec.x + i, vec.y + i))
 			newPos = glm::vec3(mapPos.x + i, mapPos.y, mapPos.z + i);
-		else if ((vec.x - i < WORLD_MAP_SIZE && vec.y + i < WORLD_MAP_SIZE && vec.x - i >= 0 && vec.y + i >= 0) && map[vec.x - i][vec.y + i] == 1)
+		else if ((vec.x - i < WORLD_MAP_SIZE && vec.y + i < WORLD_MAP_SIZE && vec.x - i >= 0 && vec.y + i >= 0) && map->get(vec.x - i, vec.y + i))
 			newPos = glm::vec3(mapPos.x - i, mapPos.y, mapPos.z + i);
-		else if ((vec.x - i < WORLD_MAP_SIZE && vec.y - i < WORLD_MAP_SIZE && vec.x - i >= 0 && vec.y - i >= 0) && map[vec.x - i][vec.y - i] == 1)
+		else if ((vec.x - i < WORLD_MAP_SIZE && vec.y - i < WORLD_MAP_SIZE && vec.x - i >= 0 && vec.y - i >= 0) && map->get(vec.x - i, vec.y - i))
 			newPos = glm::vec3(mapPos.x - i, mapPos.y, mapPos.z - i);
-		else if ((vec.x + i < WORLD_MAP_SIZE && vec.y - i < WORLD_MAP_SIZE && vec.x + i >= 0 && vec.y - i >= 0) && map[vec.x + i][vec.y - i] == 1)
+		else if ((vec.x + i < WORLD_MAP_SIZE && vec.y - i < WORLD_MAP_SIZE && vec.x + i >= 0 && vec.y - i >= 0) && map->get(vec.x + i, vec.y - i))
 			newPos = glm::vec3(mapPos.x + i, mapPos.y, mapPos.z - i);
 	}
 
@@ -345,65 +708,6 @@ void PathFinding::setRoomGrid(std::shared_ptr<Hydra::Component::RoomComponent> n
 
 bool PathFinding::_inLineOfSight(const MapVec enemyPos, const MapVec playerPos) const
 {
-	glm::vec2 dir = playerPos.baseVec - enemyPos.baseVec;
-	float distance = dir.length();
-	dir = glm::normalize(dir);
-	glm::vec2 currentPos = enemyPos;
-	for (int i = 0; i < distance; i++)
-	{
-		if (isOutOfBounds(currentPos))
-		{
-			return false;
-		}
-		currentPos += dir;
-	}
-	return true;
-}
-
-void PathFinding::_discoverNode(int x, int z, Node* lastNode)
-{
-	MapVec currentPos = MapVec(x, z);
-	if (isOutOfBounds(currentPos.baseVec))
-	{
-		return;
-	}
-
-	//If the node has already been visited, don't worry about it
-	for (size_t i = 0; i < visitedList.size(); i++)
-	{
-		if (currentPos == visitedList[i]->pos)
-		{
-			return;
-		}
-	}
-	Node* thisNode = nullptr;
-
-	//If this node exists in the open list, don't add it again
-	for (size_t i = 0; i < openList.size() && thisNode == nullptr; i++)
-	{
-		if (currentPos == openList[i]->pos)
-		{
-			thisNode = openList[i];
-		}
-	}
-	//This node hasn't been found before, add it to the open list
-	if (thisNode == nullptr)
-	{
-		thisNode = new Node(x, z, lastNode);
-		thisNode->G = INFINITY;
-		thisNode->H = INFINITY;
-		openList.push_back(thisNode);
-	}
-
-	//Check if this node has had a better path to it before
-	float thisPathF = lastNode->G + lastNode->gDistanceTo(thisNode) + thisNode->hDistanceTo(_endNode);
-	//If this is a better path than previously, replace the old path values
-	if (thisNode->getF() > thisPathF)
-	{
-		thisNode->G = lastNode->G + lastNode->gDistanceTo(thisNode);
-		thisNode->H = thisNode->hDistanceTo(_endNode);
-		thisNode->lastNode = lastNode;
-	}
-
-	std::sort(openList.begin(), openList.end(), comparisonFunctor);
+	//Only the walls block the view, not the rooms that the last search went through
+	return map && map->lineOfSight(enemyPos.baseVec, playerPos.baseVec);
 }
\ No newline at end of file
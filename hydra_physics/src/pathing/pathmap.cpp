@@ -0,0 +1,134 @@
+/**
+* The walkable tiles of the level, one bit per tile
+*
+* License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+* Authors:
+*  - Dan Printzell
+*/
+
+#include <hydra/pathing/pathmap.hpp>
+
+#include <algorithm>
+#include <bitset>
+
+PathMap::PathMap() : _rows(WORLD_MAP_SIZE * WORDS_PER_ROW, 0), _columns(WORLD_MAP_SIZE * WORDS_PER_ROW, 0) {}
+
+void PathMap::clear()
+{
+	std::fill(_rows.begin(), _rows.end(), 0);
+	std::fill(_columns.begin(), _columns.end(), 0);
+}
+
+size_t PathMap::countOpen() const
+{
+	size_t count = 0;
+	for (uint64_t word : _rows)
+		count += std::bitset<64>(word).count();
+	return count;
+}
+
+bool PathMap::isRowOpen(int x, int first, int last) const
+{
+	if (first > last)
+		std::swap(first, last);
+	return _isRunOpen(&_rows[x * WORDS_PER_ROW], first, last);
+}
+
+bool PathMap::isColumnOpen(int z, int first, int last) const
+{
+	if (first > last)
+		std::swap(first, last);
+	return _isRunOpen(&_columns[z * WORDS_PER_ROW], first, last);
+}
+
+//The axis that changes the most is the major one and it takes one step per tile. The minor coordinate at step i is
+//round(i * minor / major), so all the tiles with the same minor coordinate are one run along the major axis. Every run
+//is tested with a few words of the rows (z is major) or the columns (x is major), instead of one tile at a time.
+bool PathMap::lineOfSight(const glm::ivec2& from, const glm::ivec2& to) const
+{
+	//Both ends are in bounds, so the whole line is
+	if (!isOpen(from) || !isOpen(to))
+		return false;
+
+	const glm::ivec2 delta = to - from;
+	const bool alongZ = std::abs(delta.y) >= std::abs(delta.x);
+	const int majorFrom = alongZ ? from.y : from.x;
+	const int minorFrom = alongZ ? from.x : from.y;
+	const int majorStep = (alongZ ? delta.y : delta.x) < 0 ? -1 : 1;
+	const int minorStep = (alongZ ? delta.x : delta.y) < 0 ? -1 : 1;
+	const int64_t major = std::abs(alongZ ? delta.y : delta.x);
+	const int64_t minor = std::abs(alongZ ? delta.x : delta.y);
+	const std::vector<uint64_t>& lanes = alongZ ? _rows : _columns;
+
+	if (!minor)
+		return alongZ ? isRowOpen(from.x, from.y, to.y) : isColumnOpen(from.y, from.x, to.x);
+
+	const uint64_t* lane = &lanes[minorFrom * WORDS_PER_ROW];
+	const ptrdiff_t laneStep = minorStep * (ptrdiff_t)WORDS_PER_ROW;
+	//Close to the diagonal the runs are only one or two tiles, then it is faster to test one tile at a time.
+	//The lane changes when (2i * minor + major) passes a multiple of 2major.
+	if (major < 4 * minor)
+	{
+		int64_t error = major;
+		int pos = majorFrom;
+		for (int64_t i = 0; i <= major; i++)
+		{
+			if (!((lane[pos / 64] >> (pos % 64)) & 1))
+				return false;
+			pos += majorStep;
+			error += 2 * minor;
+			//Without a branch, it is taken at random for most slopes
+			const bool carry = error >= 2 * major;
+			error -= carry * 2 * major;
+			lane += carry * laneStep;
+		}
+		return true;
+	}
+
+	//round(i * minor / major) == k up to i = ceil((2k + 1) * major / 2minor) - 1, and the next run starts after it.
+	//The quotient and the remainder are stepped instead of divided for every run.
+	const int64_t denominator = 2 * minor;
+	const int64_t stepQuotient = 2 * major / denominator;
+	const int64_t stepRemainder = 2 * major % denominator;
+	int64_t quotient = major / denominator;
+	int64_t remainder = major % denominator;
+	int64_t first = 0;
+	for (int64_t k = 0; k <= minor; k++)
+	{
+		const int64_t last = std::min(quotient + (remainder != 0) - 1, major);
+		const int a = majorFrom + majorStep * (int)first;
+		const int b = majorFrom + majorStep * (int)last;
+		if (!_isRunOpen(lane, std::min(a, b), std::max(a, b)))
+			return false;
+
+		first = last + 1;
+		lane += laneStep;
+		quotient += stepQuotient;
+		remainder += stepRemainder;
+		const bool carry = remainder >= denominator;
+		remainder -= carry * denominator;
+		quotient += carry;
+	}
+	return true;
+}
+
+std::vector<uint8_t> PathMap::toBytes() const
+{
+	std::vector<uint8_t> bytes(BYTE_SIZE, 0);
+	for (size_t x = 0; x < WORLD_MAP_SIZE; x++)
+		for (size_t i = 0; i < ROW_BYTES; i++)
+			bytes[x * ROW_BYTES + i] = (uint8_t)(_rows[x * WORDS_PER_ROW + i / 8] >> (i % 8 * 8));
+	return bytes;
+}
+
+bool PathMap::fromBytes(const uint8_t* data, size_t size)
+{
+	if (size != BYTE_SIZE)
+		return false;
+	clear();
+	for (int x = 0; x < WORLD_MAP_SIZE; x++)
+		for (int z = 0; z < WORLD_MAP_SIZE; z++)
+			if ((data[x * ROW_BYTES + z / 8] >> (z % 8)) & 1)
+				set(x, z, true);
+	return true;
+}
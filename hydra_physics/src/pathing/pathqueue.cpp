@@ -0,0 +1,195 @@
+/**
+* Pathfinding on worker threads
+*
+* License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+* Authors:
+*  - Dan Printzell
+*/
+
+#include <hydra/pathing/pathqueue.hpp>
+#include <hydra/pathing/pathfinding.hpp>
+
+#include <algorithm>
+
+namespace {
+	struct JobOrder
+	{
+		template <typename T>
+		bool operator()(const T& a, const T& b) const
+		{
+			if (a.priority != b.priority)
+				return a.priority < b.priority;
+			return a.order > b.order;
+		}
+	};
+}
+
+PathQueue::PathQueue(size_t threads)
+{
+	//The workers share the CPU with the job graph, so they only get a part of it
+	if (threads == SIZE_MAX)
+		threads = std::max(std::thread::hardware_concurrency() / 4, 1u);
+	for (size_t i = 0; i < threads; i++)
+		_workers.emplace_back(&PathQueue::_worker, this);
+}
+
+PathQueue::~PathQueue()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_cv.notify_all();
+	for (auto& worker : _workers)
+		worker.join();
+}
+
+PathQueue& PathQueue::instance()
+{
+	static PathQueue queue;
+	return queue;
+}
+
+PathQueue::Ticket PathQueue::request(const glm::vec3& start, const glm::vec3& end, const PathMap* map, Priority priority, size_t maxVisited)
+{
+	if (!map)
+		return INVALID_TICKET;
+	std::lock_guard<std::mutex> lock(_mutex);
+	const Ticket ticket = _nextTicket++;
+	_results[ticket];
+	_push(Job{priority, 0, ticket, start, end, map, maxVisited, nullptr, glm::ivec2(0)});
+	return ticket;
+}
+
+bool PathQueue::poll(Ticket ticket, std::vector<glm::vec3>& path, bool& found)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _results.find(ticket);
+	if (it == _results.end())
+	{
+		//Cancelled, or dropped by clear
+		path.clear();
+		found = false;
+		return true;
+	}
+	if (!it->second.done)
+		return false;
+	path.swap(it->second.path);
+	found = it->second.found;
+	_results.erase(it);
+	return true;
+}
+
+void PathQueue::cancel(Ticket ticket)
+{
+	if (ticket == INVALID_TICKET)
+		return;
+	std::lock_guard<std::mutex> lock(_mutex);
+	//The job is skipped when a worker gets to it
+	_results.erase(ticket);
+}
+
+bool PathQueue::updateField(const std::shared_ptr<FlowField>& field, const glm::vec3& targetPos, const PathMap* map)
+{
+	glm::ivec2 target;
+	if (!field || field->_pending || !field->_needsUpdate(targetPos, map, target))
+		return false;
+	if (field->_pending.exchange(true))
+		return false;
+	std::lock_guard<std::mutex> lock(_mutex);
+	_push(Job{Priority::FIELD, 0, INVALID_TICKET, glm::vec3(0), glm::vec3(0), map, 0, field, target});
+	return true;
+}
+
+void PathQueue::update()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_swapping.swap(_doneFields);
+	}
+	for (auto& field : _swapping)
+	{
+		field->_swap();
+		field->_pending = false;
+	}
+	_swapping.clear();
+}
+
+void PathQueue::clear()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (Job& job : _jobs)
+		if (job.field)
+			_doneFields.push_back(job.field);
+	_jobs.clear();
+	_results.clear();
+	_idle.wait(lock, [this] { return !_running; });
+
+	//The fields were computed from the old map, so they are not swapped in
+	for (auto& field : _doneFields)
+		field->_pending = false;
+	_doneFields.clear();
+}
+
+size_t PathQueue::getQueuedCount()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _jobs.size() + _running;
+}
+
+void PathQueue::_push(Job&& job)
+{
+	job.order = _order++;
+	_jobs.push_back(std::move(job));
+	std::push_heap(_jobs.begin(), _jobs.end(), JobOrder());
+	_cv.notify_one();
+}
+
+void PathQueue::_worker()
+{
+	//Owned by this thread, so the searches don't share any scratch memory
+	PathFinding pathFinding;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_quit)
+	{
+		if (_jobs.empty())
+		{
+			_cv.wait(lock);
+			continue;
+		}
+		std::pop_heap(_jobs.begin(), _jobs.end(), JobOrder());
+		Job job = std::move(_jobs.back());
+		_jobs.pop_back();
+		if (!job.field && !_results.count(job.ticket))
+			continue;
+		_running++;
+		lock.unlock();
+
+		bool found = false;
+		if (job.field)
+			job.field->_compute(job.map, job.target);
+		else
+		{
+			pathFinding.map = job.map;
+			pathFinding.maxVisited = job.maxVisited;
+			found = pathFinding.findPath(job.start, job.end);
+		}
+
+		lock.lock();
+		_running--;
+		if (job.field)
+			_doneFields.push_back(std::move(job.field));
+		else
+		{
+			auto it = _results.find(job.ticket);
+			if (it != _results.end())
+			{
+				it->second.done = true;
+				it->second.found = found;
+				it->second.path.swap(pathFinding.pathToEnd);
+			}
+		}
+		if (!_running)
+			_idle.notify_all();
+	}
+}
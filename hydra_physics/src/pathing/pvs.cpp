@@ -0,0 +1,124 @@
+/**
+* Room to room potentially visible set
+*
+* License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+* Authors:
+*  - Dan Printzell
+*/
+
+#include <hydra/pathing/pvs.hpp>
+#include <hydra/ext/openmp.hpp>
+
+namespace {
+	//Walks all the tiles between the centers of 'from' and 'to'. Uses integers so that lines that pass exactly through
+	//a corner always step diagonally instead of depending on float rounding.
+	bool lineIsClear(const std::vector<uint8_t>& open, const glm::ivec2& from, const glm::ivec2& to)
+	{
+		const glm::ivec2 delta = to - from;
+		const glm::ivec2 step(delta.x > 0 ? 1 : -1, delta.y > 0 ? 1 : -1);
+		const int64_t nx = std::abs(delta.x);
+		const int64_t ny = std::abs(delta.y);
+
+		glm::ivec2 pos = from;
+		int64_t ix = 0;
+		int64_t iy = 0;
+		while (ix < nx || iy < ny)
+		{
+			const int64_t tx = (2 * ix + 1) * ny;
+			const int64_t ty = (2 * iy + 1) * nx;
+			const bool stepX = ix < nx && (iy >= ny || tx <= ty);
+			const bool stepY = iy < ny && (ix >= nx || ty <= tx);
+			if (stepX)
+			{
+				pos.x += step.x;
+				ix++;
+			}
+			if (stepY)
+			{
+				pos.y += step.y;
+				iy++;
+			}
+			if (!open[pos.x * WORLD_MAP_SIZE + pos.y])
+				return false;
+		}
+		return true;
+	}
+}
+
+PVS PVS::compute(std::shared_ptr<Hydra::Component::RoomComponent> roomGrid[ROOM_GRID_SIZE][ROOM_GRID_SIZE], const PathMap* pathfindingMap)
+{
+	std::vector<uint8_t> open(WORLD_MAP_SIZE * WORLD_MAP_SIZE, 0);
+	std::vector<glm::ivec2> doors[ROOM_COUNT];
+
+	for (int gx = 0; gx < ROOM_GRID_SIZE; gx++)
+	{
+		for (int gy = 0; gy < ROOM_GRID_SIZE; gy++)
+		{
+			if (!roomGrid[gx][gy])
+				continue;
+			auto& roomDoors = doors[roomIndex({ gx, gy })];
+			for (int lx = 0; lx < ROOM_MAP_SIZE; lx++)
+			{
+				for (int ly = 0; ly < ROOM_MAP_SIZE; ly++)
+				{
+					const int x = gx * ROOM_MAP_SIZE + lx;
+					const int y = gy * ROOM_MAP_SIZE + ly;
+					const bool border = lx == 0 || ly == 0 || lx == ROOM_MAP_SIZE - 1 || ly == ROOM_MAP_SIZE - 1;
+					if (!border)
+						open[x * WORLD_MAP_SIZE + y] = 1;
+					else if (pathfindingMap->get(x, y) && x > 0 && y > 0 && x < WORLD_MAP_SIZE - 1 && y < WORLD_MAP_SIZE - 1)
+					{
+						open[x * WORLD_MAP_SIZE + y] = 1;
+						roomDoors.push_back({ x, y });
+					}
+				}
+			}
+		}
+	}
+
+	//Every line from one room to another has to go through a door of both rooms, so only those tiles need to be tested
+	std::vector<uint8_t> visible(ROOM_COUNT * ROOM_COUNT, 0);
+	#pragma omp parallel for schedule(dynamic)
+	for (int_openmp_t a = 0; a < (int_openmp_t)ROOM_COUNT; a++)
+	{
+		for (size_t b = a + 1; b < ROOM_COUNT; b++)
+		{
+			bool found = false;
+			for (size_t i = 0; i < doors[a].size() && !found; i++)
+				for (size_t j = 0; j < doors[b].size() && !found; j++)
+					found = lineIsClear(open, doors[a][i], doors[b][j]);
+			visible[a * ROOM_COUNT + b] = found;
+		}
+	}
+
+	PVS pvs;
+	for (size_t a = 0; a < ROOM_COUNT; a++)
+		for (size_t b = a + 1; b < ROOM_COUNT; b++)
+			if (visible[a * ROOM_COUNT + b])
+				pvs.setVisible(a, b);
+	return pvs;
+}
+
+void PVS::setVisible(size_t roomA, size_t roomB, bool visible)
+{
+	_visible[roomA * ROOM_COUNT + roomB] = visible;
+	_visible[roomB * ROOM_COUNT + roomA] = visible;
+}
+
+std::vector<uint8_t> PVS::toBytes() const
+{
+	std::vector<uint8_t> bytes(BYTE_SIZE, 0);
+	for (size_t i = 0; i < _visible.size(); i++)
+		if (_visible[i])
+			bytes[i / 8] |= 1 << (i % 8);
+	return bytes;
+}
+
+bool PVS::fromBytes(const uint8_t* data, size_t size)
+{
+	if (size != BYTE_SIZE)
+		return false;
+	for (size_t i = 0; i < _visible.size(); i++)
+		_visible[i] = (data[i / 8] >> (i % 8)) & 1;
+	return true;
+}
@@ -45,7 +45,7 @@ void AbilitySystem::tick(float delta) {
 			}
 			_spawnParticleEmitterAt(t->position, glm::vec3(0,1,0));
 			allEnemies.clear();
-			entities[i]->dead = true;
+			entities[i]->kill();
 		}
 	}
 
@@ -70,7 +70,7 @@ void AbilitySystem::tick(float delta) {
 		}
 		if (m->isExploding || m->detonateTimer <= 0)
 		{
-			entities[i]->dead = true;
+			entities[i]->kill();
 			_spawnParticleEmitterAt(t->position, glm::vec3(0, 1, 0));
 		}
 		allEnemies.clear();
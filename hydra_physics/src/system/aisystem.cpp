@@ -1,6 +1,9 @@
 #include <hydra/system/aisystem.hpp>
 
-#include <hydra/ext/openmp.hpp>
+#include <hydra/engine.hpp>
+#include <hydra/world/workerpool.hpp>
+#include <hydra/pathing/pathqueue.hpp>
+#include <hydra/system/bulletphysicssystem.hpp>
 
 #include <hydra/component/aicomponent.hpp>
 #include <hydra/component/transformcomponent.hpp>
@@ -16,18 +19,36 @@ AISystem::AISystem() {}
 AISystem::~AISystem() {}
 
 void AISystem::tick(float delta) {
-	using world = Hydra::World::World;
-
-	//Process AiComponent
-	world::getEntitiesWithComponents<Component::AIComponent, Component::TransformComponent, Component::LifeComponent>(entities);
-	// TODO: AIComponent can't use OpenGL commands
-	// #pragma omp parallel for
-	for (int_openmp_t i = 0; i < (int_openmp_t)entities.size(); i++) {
-		auto enemy = entities[i]->getComponent<Component::AIComponent>();
-		enemy->behaviour->run(delta);
+	// The flow fields that the path queue finished since the last tick
+	PathQueue::instance().update();
+
+	// Enemies spawned by a behaviour are appended to _enemies, they will run next tick
+	auto& enemies = _enemies.getEntities();
+	_behaviours.clear();
+	for (auto& enemy : enemies)
+		_behaviours.push_back(enemy->getComponent<Component::AIComponent>()->behaviour.get());
+
+	// Think: every enemy at the same time, each one only writes to itself while the rest of the world stays as it was
+	Hydra::World::WorkerPool::instance().parallelFor(0, _behaviours.size(), THINK_GRAIN_SIZE, [this, delta](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			_behaviours[i]->think(delta);
+	});
+
+	// Resolve: the rays they all queued in one batch, the world isn't stepped while AISystem ticks
+	if (auto physics = static_cast<BulletPhysicsSystem*>(IEngine::getInstance()->getState()->getPhysicsSystem())) {
+		_rays.clear();
+		for (auto behaviour : _behaviours)
+			behaviour->collectRays(_rays);
+		_rayHits.resize(_rays.size());
+		physics->rayTest(_rays.data(), _rays.size(), _rayHits.data(), true);
+		const BulletPhysicsSystem::RayHit* hits = _rayHits.data();
+		for (auto behaviour : _behaviours)
+			hits += behaviour->resolveRays(hits);
 	}
 
-	entities.clear();
+	// Act: what changes the rigid bodies and the players, and the behaviours that aren't split
+	for (auto behaviour : _behaviours)
+		behaviour->act(delta);
 }
 
 void AISystem::registerUI() {}
@@ -9,7 +9,12 @@
  */
 #include <hydra/system/bulletphysicssystem.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <hydra/component/rigidbodycomponent.hpp>
 #include <hydra/component/ghostobjectcomponent.hpp>
@@ -24,8 +29,13 @@
 #include <hydra/component/aicomponent.hpp>
 #include <hydra/component/meshcomponent.hpp>
 #include <hydra/component/spawnercomponent.hpp>
+#include <hydra/world/workerpool.hpp>
 #include <btBulletDynamicsCommon.h>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <LinearMath/btThreads.h>
+#include <imgui/imgui.h>
 
 inline static btQuaternion cast(const glm::quat& r) { return btQuaternion{r.x, r.y, r.z, r.w}; }
 inline static btVector3 cast(const glm::vec3& v) { return btVector3{v.x, v.y, v.z}; }
@@ -36,25 +46,200 @@ inline static glm::vec3 cast(const btVector3& v) { return glm::vec3(v.x(), v.y()
 using namespace Hydra::System;
 using namespace Hydra::Component;
 
+int BulletPhysicsSystem::collidesWith(int group) {
+	switch (group) {
+	case BulletPhysicsSystem::COLL_PLAYER: return BulletPhysicsSystem::playerCollidesWith;
+	case BulletPhysicsSystem::COLL_ENEMY: return BulletPhysicsSystem::enemyCollidesWith;
+	case BulletPhysicsSystem::COLL_WALL: return BulletPhysicsSystem::wallCollidesWith;
+	case BulletPhysicsSystem::COLL_PLAYER_PROJECTILE: return BulletPhysicsSystem::playerProjCollidesWith;
+	case BulletPhysicsSystem::COLL_ENEMY_PROJECTILE: return BulletPhysicsSystem::enemyProjCollidesWith;
+	case BulletPhysicsSystem::COLL_MISC_OBJECT: return BulletPhysicsSystem::miscObjectCollidesWith;
+	case BulletPhysicsSystem::COLL_PICKUP_OBJECT: return BulletPhysicsSystem::pickupObjectCollidesWith;
+	case BulletPhysicsSystem::COLL_FLOOR: return BulletPhysicsSystem::floorCollidesWith;
+	case BulletPhysicsSystem::COLL_SPAWNER: return BulletPhysicsSystem::spawnerCollidesWith;
+	default: return BulletPhysicsSystem::COLL_NOTHING;
+	}
+}
+
+// Runs the parallelFor calls of the Mt classes on a WorkerPool of its own, as its size follows setNumThreads.
+// It is shared by every BulletPhysicsSystem, as Bullet only has one task scheduler.
+class WorkerTaskScheduler final : public btITaskScheduler {
+public:
+	WorkerTaskScheduler() : btITaskScheduler("Hydra"), _pool(std::make_unique<Hydra::World::WorkerPool>(0)) {}
+
+	int getMaxNumThreads() const final { return BT_MAX_THREAD_COUNT; }
+	int getNumThreads() const final { return (int)_pool->getThreadCount(); }
+
+	void setNumThreads(int numThreads) final {
+		numThreads = std::max(1, std::min(numThreads, (int)BT_MAX_THREAD_COUNT));
+		if (numThreads != getNumThreads())
+			_pool = std::make_unique<Hydra::World::WorkerPool>(numThreads - 1);
+	}
+
+	void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) final {
+		if (iBegin >= iEnd)
+			return;
+		_pool->parallelFor((size_t)iBegin, (size_t)iEnd, (size_t)std::max(grainSize, 1), [&body](size_t begin, size_t end) { body.forLoop((int)begin, (int)end); });
+	}
+
+private:
+	std::unique_ptr<Hydra::World::WorkerPool> _pool;
+};
+
+static WorkerTaskScheduler& taskScheduler() {
+	static WorkerTaskScheduler scheduler;
+	return scheduler;
+}
+
+// Everything a contact needs to know about a collision object, so that the contacts don't look up the entity or its
+// components. The pointers are taken again when the entity gets or loses a component, which Entity::componentGeneration
+// tells even if a component was removed and added back.
+// It is made when the object is enabled and deleted when it is disabled, and the components disable their objects
+// before they are destroyed.
+struct BulletPhysicsSystem::Body final {
+	EntityID id;
+	int collisionType;
+	Entity* entity = nullptr;
+	size_t componentGeneration = 0;
+	BulletComponent* bullet = nullptr;
+	LifeComponent* life = nullptr;
+	PlayerComponent* player = nullptr;
+	PickUpComponent* pickup = nullptr;
+	PerkComponent* perk = nullptr;
+	RigidBodyComponent* rigidBody = nullptr;
+	AIComponent* ai = nullptr;
+	SpawnerComponent* spawner = nullptr;
+
+	Body(EntityID id, int collisionType) : id(id), collisionType(collisionType) {}
+
+	// False if the entity is gone
+	inline bool refresh() {
+		if (entity && entity->componentGeneration == componentGeneration)
+			return true;
+		Entity* e = entity ? entity : Hydra::World::World::getEntity(id).get();
+		if (!e)
+			return false;
+		take(e);
+		return true;
+	}
+
+	void take(Entity* e) {
+		entity = e;
+		componentGeneration = e->componentGeneration;
+		bullet = e->getComponent<BulletComponent>().get();
+		life = e->getComponent<LifeComponent>().get();
+		player = e->getComponent<PlayerComponent>().get();
+		pickup = e->getComponent<PickUpComponent>().get();
+		perk = e->getComponent<PerkComponent>().get();
+		rigidBody = e->getComponent<RigidBodyComponent>().get();
+		ai = e->getComponent<AIComponent>().get();
+		spawner = e->getComponent<SpawnerComponent>().get();
+	}
+};
+
+// Found after the step and handled after all of them have been found, in the same order
+struct BulletPhysicsSystem::ContactEvent final {
+	enum class Type {
+		PickUp, // a picks up b, player is the player of either of them
+		Ground, // player stands on something, floor if it is the floor
+		BulletHit // Bullet a hit b at point
+	};
+	Type type;
+	Body* a;
+	Body* b;
+	Body* player;
+	bool floor;
+	glm::vec3 point;
+	glm::vec3 normal;
+};
+
 struct BulletPhysicsSystem::Data {
 	std::unique_ptr<btDefaultCollisionConfiguration> config;
 	std::unique_ptr<btCollisionDispatcher> dispatcher;
 	std::unique_ptr<btBroadphaseInterface> broadphase;
-	std::unique_ptr<btSequentialImpulseConstraintSolver> solver;
+	std::unique_ptr<btConstraintSolver> solver;
 	std::unique_ptr<btDiscreteDynamicsWorld> dynamicsWorld;
+	// Cleared every tick but keeps its memory
+	std::vector<ContactEvent> contacts;
+	// The rays can be tested from many threads
+	std::atomic<size_t> rays{0};
+	std::atomic<size_t> rayHits{0};
 };
 
 BulletPhysicsSystem::BulletPhysicsSystem() {
 	_data = new Data;
 	_data->config = std::make_unique<btDefaultCollisionConfiguration>();
-	_data->dispatcher = std::make_unique<btCollisionDispatcher>(_data->config.get());
 	_data->broadphase = std::make_unique<btDbvtBroadphase>();
-	_data->solver = std::make_unique<btSequentialImpulseConstraintSolver>();
-	_data->dynamicsWorld = std::make_unique<btDiscreteDynamicsWorld>(_data->dispatcher.get(), _data->broadphase.get(), _data->solver.get(), _data->config.get());
-	_data->dynamicsWorld->setGravity(btVector3(0, -10, 0));
+	_createWorld();
 }
 
-BulletPhysicsSystem::~BulletPhysicsSystem() { delete _data; }
+BulletPhysicsSystem::~BulletPhysicsSystem() {
+	btCollisionObjectArray& objects = _data->dynamicsWorld->getCollisionObjectArray();
+	for (int i = 0; i < objects.size(); i++) {
+		delete static_cast<Body*>(objects[i]->getUserPointer());
+		objects[i]->setUserPointer(nullptr);
+	}
+	delete _data;
+}
+
+void BulletPhysicsSystem::setThreadCount(size_t threads) {
+	if (threads == SIZE_MAX)
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	threads = std::min(threads, (size_t)BT_MAX_THREAD_COUNT);
+	if (threads == _threads)
+		return;
+	_threads = threads;
+
+	struct Object {
+		btCollisionObject* object;
+		int group;
+		int mask;
+		btVector3 gravity;
+	};
+	std::vector<Object> objects;
+	btCollisionObjectArray& array = _data->dynamicsWorld->getCollisionObjectArray();
+	for (int i = array.size() - 1; i >= 0; i--) {
+		btCollisionObject* object = array[i];
+		btRigidBody* body = btRigidBody::upcast(object);
+		objects.push_back(Object{object, object->getBroadphaseHandle()->m_collisionFilterGroup, object->getBroadphaseHandle()->m_collisionFilterMask, body ? body->getGravity() : btVector3()});
+		if (body)
+			_data->dynamicsWorld->removeRigidBody(body);
+		else
+			_data->dynamicsWorld->removeCollisionObject(object);
+	}
+
+	_createWorld();
+
+	// addRigidBody gives the body the gravity of the world, some bodies have their own
+	for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+		if (btRigidBody* body = btRigidBody::upcast(it->object)) {
+			_data->dynamicsWorld->addRigidBody(body, it->group, it->mask);
+			body->setGravity(it->gravity);
+		} else
+			_data->dynamicsWorld->addCollisionObject(it->object, it->group, it->mask);
+	}
+}
+
+void BulletPhysicsSystem::_createWorld() {
+	_data->dynamicsWorld.reset();
+	_data->solver.reset();
+	_data->dispatcher.reset();
+	if (!_threads) {
+		_data->dispatcher = std::make_unique<btCollisionDispatcher>(_data->config.get());
+		_data->solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+		_data->dynamicsWorld = std::make_unique<btDiscreteDynamicsWorld>(_data->dispatcher.get(), _data->broadphase.get(), _data->solver.get(), _data->config.get());
+	} else {
+		// The scheduler has to be set before any of the Mt classes are made
+		WorkerTaskScheduler& scheduler = taskScheduler();
+		scheduler.setNumThreads(std::max(scheduler.getNumThreads(), (int)_threads));
+		btSetTaskScheduler(&scheduler);
+		_data->dispatcher = std::make_unique<btCollisionDispatcherMt>(_data->config.get());
+		auto solver = std::make_unique<btConstraintSolverPoolMt>((int)_threads);
+		_data->dynamicsWorld = std::make_unique<btDiscreteDynamicsWorldMt>(_data->dispatcher.get(), _data->broadphase.get(), solver.get(), _data->config.get());
+		_data->solver = std::move(solver);
+	}
+	_data->dynamicsWorld->setGravity(btVector3(0, -10, 0));
+}
 
 void BulletPhysicsSystem::enable(RigidBodyComponent* component) {
 	if (component->_handler)
@@ -95,12 +280,16 @@ void BulletPhysicsSystem::enable(RigidBodyComponent* component) {
 		_data->dynamicsWorld->addRigidBody(rigidBody, COLL_NOTHING, COLL_NOTHING);
 		break;
 	}
+	rigidBody->setUserPointer(new Body(rigidBody->getUserIndex(), rigidBody->getUserIndex2()));
 }
 
 void BulletPhysicsSystem::disable(RigidBodyComponent* component) {
 	if (!component->_handler)
 		return;
-	_data->dynamicsWorld->removeRigidBody(static_cast<btRigidBody*>(component->getRigidBody()));
+	btRigidBody* rigidBody = static_cast<btRigidBody*>(component->getRigidBody());
+	_data->dynamicsWorld->removeRigidBody(rigidBody);
+	delete static_cast<Body*>(rigidBody->getUserPointer());
+	rigidBody->setUserPointer(nullptr);
 	component->_handler = nullptr;
 }
 
@@ -143,154 +332,232 @@ void Hydra::System::BulletPhysicsSystem::enable(GhostObjectComponent * component
 		_data->dynamicsWorld->addCollisionObject(component->ghostObject, COLL_NOTHING, COLL_NOTHING);
 		break;
 	}
+	if (!component->ghostObject->getUserPointer())
+		component->ghostObject->setUserPointer(new Body(component->ghostObject->getUserIndex(), component->ghostObject->getUserIndex2()));
 }
 
 void Hydra::System::BulletPhysicsSystem::disable(GhostObjectComponent * component){
 	_data->dynamicsWorld->removeCollisionObject(component->ghostObject);
+	delete static_cast<Body*>(component->ghostObject->getUserPointer());
+	component->ghostObject->setUserPointer(nullptr);
 	component->_handler = nullptr;
 }
 
-void* Hydra::System::BulletPhysicsSystem::rayTestFromTo(const glm::vec3& from, const glm::vec3& to)
-{
-	btVector3 playerPos(cast(from));
-	btVector3 directionBoi(cast(to));
-	btCollisionWorld::ClosestRayResultCallback* callback = new btCollisionWorld::ClosestRayResultCallback(playerPos, directionBoi);
-
-	_data->dynamicsWorld->rayTest(playerPos, directionBoi, *callback);
-	return callback;
+bool BulletPhysicsSystem::rayTest(const glm::vec3& from, const glm::vec3& to, int group, RayHit& hit) const {
+	return rayTest(from, to, group, collidesWith(group), hit);
 }
 
-void BulletPhysicsSystem::tick(float delta) {
-	_data->dynamicsWorld->stepSimulation(delta, 3);
-	// Gets all collisions happening between all rigidbody entities.
-	//_data->dynamicsWorld->stepSimulation(delta, 3, btScalar(1.0) / btScalar(180.));
-	int numManifolds = _data->dynamicsWorld->getDispatcher()->getNumManifolds();
-	for (int i = 0; i < numManifolds; i++) {
-		btPersistentManifold* contactManifold = _data->dynamicsWorld->getDispatcher()->getManifoldByIndexInternal(i);
-		const btCollisionObject* obA = contactManifold->getBody0();
-		const btCollisionObject* obB = contactManifold->getBody1();
-		Entity* eA = Hydra::World::World::getEntity(obA->getUserIndex()).get();
-		Entity* eB = Hydra::World::World::getEntity(obB->getUserIndex()).get();
-
-		if (!eA || !eB)
-			continue;
+bool BulletPhysicsSystem::rayTest(const glm::vec3& from, const glm::vec3& to, int group, int mask, RayHit& hit) const {
+	btCollisionWorld::ClosestRayResultCallback callback(cast(from), cast(to));
+	callback.m_collisionFilterGroup = group;
+	callback.m_collisionFilterMask = mask;
+	_data->dynamicsWorld->rayTest(callback.m_rayFromWorld, callback.m_rayToWorld, callback);
+	_data->rays++;
+	if (!callback.hasHit())
+		return false;
+	_data->rayHits++;
+	hit.entity = callback.m_collisionObject->getUserIndex();
+	hit.point = cast(callback.m_hitPointWorld);
+	hit.normal = cast(callback.m_hitNormalWorld);
+	hit.fraction = callback.m_closestHitFraction;
+	hit.collisionType = callback.m_collisionObject->getUserIndex2();
+	return true;
+}
 
-		BulletComponent* bulletComponent = nullptr;
-		LifeComponent* lifeComponent = nullptr;
-		PlayerComponent* playerComponent = nullptr;
-		PickUpComponent* pickupComponent = nullptr;
-		PerkComponent* perkComponent = nullptr;
-
-		if ((bulletComponent = eA->getComponent<BulletComponent>().get()))
-			lifeComponent = eB->getComponent<LifeComponent>().get();
-		else if ((bulletComponent = eB->getComponent<BulletComponent>().get()))
-			lifeComponent = eA->getComponent<LifeComponent>().get();
-
-		playerComponent = eA->getComponent<PlayerComponent>().get();
-		if (!playerComponent)
-			playerComponent = eB->getComponent<PlayerComponent>().get();
-
-		if ((pickupComponent = eA->getComponent<PickUpComponent>().get()))
-			perkComponent = eB->getComponent<PerkComponent>().get();
-		else if ((pickupComponent = eB->getComponent<PickUpComponent>().get()))
-			perkComponent = eA->getComponent<PerkComponent>().get();
-
-		if (pickupComponent && perkComponent) { // What does this code do? - Stevan.
-			if (IEngine::getInstance()->getDeadSystem())
-				_spawnText(Hydra::World::World::getEntity(playerComponent->entityID)->getComponent<Hydra::Component::TransformComponent>()->position, "eyyy\n");
-			
-			_addPickUp(pickupComponent, perkComponent);
+// The callbacks are on the stack. The Dbvt broadphase keeps one ray stack per thread when BT_THREADSAFE is on, so
+// the chunks can walk it at the same time.
+size_t BulletPhysicsSystem::rayTest(const Ray* rays, size_t count, RayHit* hits, bool parallel) const {
+	const btCollisionWorld* world = _data->dynamicsWorld.get();
+	auto testRays = [world, rays, hits](size_t begin, size_t end) {
+		size_t hitCount = 0;
+		for (size_t i = begin; i < end; i++) {
+			btCollisionWorld::ClosestRayResultCallback callback(cast(rays[i].from), cast(rays[i].to));
+			callback.m_collisionFilterGroup = rays[i].group;
+			callback.m_collisionFilterMask = rays[i].mask;
+			world->rayTest(callback.m_rayFromWorld, callback.m_rayToWorld, callback);
+			RayHit& hit = hits[i];
+			if (!callback.hasHit()) {
+				hit = RayHit{Hydra::World::World::invalidID, rays[i].to, glm::vec3(0), 1.0f, COLL_NOTHING};
+				continue;
+			}
+			hit.entity = callback.m_collisionObject->getUserIndex();
+			hit.point = cast(callback.m_hitPointWorld);
+			hit.normal = cast(callback.m_hitNormalWorld);
+			hit.fraction = callback.m_closestHitFraction;
+			hit.collisionType = callback.m_collisionObject->getUserIndex2();
+			hitCount++;
 		}
+		return hitCount;
+	};
+
+	size_t hitCount = 0;
+	if (parallel && count > RAY_GRAIN_SIZE) {
+		std::atomic<size_t> hitCounter{0};
+		Hydra::World::WorkerPool::instance().parallelFor(0, count, RAY_GRAIN_SIZE, [&](size_t begin, size_t end) {
+			hitCounter += testRays(begin, end);
+		});
+		hitCount = hitCounter;
+	} else
+		hitCount = testRays(0, count);
+	_data->rays += count;
+	_data->rayHits += hitCount;
+	return hitCount;
+}
 
-		// Gets the contact points
-		int numContacts = contactManifold->getNumContacts();
-		for (int j = 0; j < numContacts; j++) {
-			auto entityAMesh = eA->getComponent<Hydra::Component::MeshComponent>();
-			auto entityBMesh = eB->getComponent<Hydra::Component::MeshComponent>();
+size_t BulletPhysicsSystem::getRayCount() const { return _data->rays; }
+size_t BulletPhysicsSystem::getRayHitCount() const { return _data->rayHits; }
 
-			btManifoldPoint& pt = contactManifold->getContactPoint(j);
-			btVector3 collPosB = pt.getPositionWorldOnB();
-			btVector3 normalOnB = pt.m_normalWorldOnB;
+void BulletPhysicsSystem::resetRayCounters() {
+	_data->rays = 0;
+	_data->rayHits = 0;
+}
 
-			if (playerComponent && normalOnB.y() > 0.7){
-				playerComponent->onGround = true;
-				if (obA->getUserIndex2() == COLL_FLOOR || obB->getUserIndex2() == COLL_FLOOR) {
-					playerComponent->onFloor = true;
-				}
-				else {
-					playerComponent->onFloor = false;
-				}
-			}
-			if (lifeComponent) {
-				// Terrible HeadShot code.
-				auto rgbcA = eA->getComponent<Hydra::Component::RigidBodyComponent>();
-				bool headshot = false;
-				float accumulatedDamage = bulletComponent->damage;
-				glm::vec3 textColor = { 1.0,1.0,1.0 };
-				glm::vec3 textScale = { 10,10,10 };
-				Hydra::Component::ParticleComponent::ParticleTexture particleTexture;
-				auto compound = static_cast<btCompoundShape*>(static_cast<btRigidBody*>(rgbcA->getRigidBody())->getCollisionShape());
-				if (compound->getNumChildShapes() > 1) {
-					glm::vec3 child1Pos = rgbcA->getPosition(0);
-					glm::vec3 child2Pos = rgbcA->getPosition(1);
-					float distance1 = glm::distance(child1Pos, cast(collPosB));
-					float distance2 = glm::distance(child2Pos, cast(collPosB));
-					if (distance2 < distance1) {
-						accumulatedDamage *= 2.0f; // 2.0 multiplier on HS.
-						textColor = glm::vec3(4, 0.5, 0.5);
-						textScale = glm::vec3(15, 15, 15);
-						headshot = true;
-					}
-				}
+void BulletPhysicsSystem::applyBulletHit(Entity* target, float damage, const glm::vec3& point, const glm::vec3& normal) {
+	if (!target)
+		return;
+	// The Body of an enabled rigid body already has the components
+	RigidBodyComponent* rigidBody = target->getComponent<RigidBodyComponent>().get();
+	Body* body = rigidBody && rigidBody->_handler ? static_cast<Body*>(static_cast<btRigidBody*>(rigidBody->getRigidBody())->getUserPointer()) : nullptr;
+	if (body && body->refresh()) {
+		_applyBulletHit(*body, damage, point, normal);
+		return;
+	}
+	Body temporary(target->id, COLL_NOTHING);
+	temporary.take(target);
+	_applyBulletHit(temporary, damage, point, normal);
+}
 
-				if (!Hydra::IEngine::getInstance()->getDeadSystem()) {
-					lifeComponent->applyDamage(accumulatedDamage);
-				}
+void BulletPhysicsSystem::_applyBulletHit(Body& target, float damage, const glm::vec3& point, const glm::vec3& normal) {
+	LifeComponent* lifeComponent = target.life;
+	if (!lifeComponent)
+		return;
 
-				auto targetEntity = Hydra::World::World::getEntity(lifeComponent->entityID);
-				auto aiComponent = targetEntity->getComponent<Hydra::Component::AIComponent>();
-
-				if (!targetEntity->getComponent<Hydra::Component::PlayerComponent>() && aiComponent) {
-					_spawnText(cast(collPosB), std::to_string(accumulatedDamage), textColor, textScale);
-					switch (aiComponent->behaviour->type) {
-					case Hydra::Physics::Behaviour::Behaviour::Type::ALIEN: {
-						if (headshot)
-							particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::AlienHS;
-						else
-							particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::AlienBlood;
-						_spawnParticleEmitterAt(cast(collPosB), cast(normalOnB), particleTexture);
-						break;
-					}
-					case Hydra::Physics::Behaviour::Behaviour::Type::ROBOT: {
-						if (headshot)
-							particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::AlienHS;
-						else
-							particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::Energy;
-						_spawnParticleEmitterAt(cast(collPosB), cast(normalOnB), particleTexture);
-						break;
-					}
-					default:
-						break;
-					}
-				} else if (targetEntity->getComponent<SpawnerComponent>()) {
-					_spawnText(cast(collPosB), std::to_string(accumulatedDamage), textColor, textScale);
-					particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::Energy;
-					_spawnParticleEmitterAt(cast(collPosB), cast(normalOnB), particleTexture);
-				}
+	// Terrible HeadShot code.
+	RigidBodyComponent* rgbc = target.rigidBody;
+	bool headshot = false;
+	float accumulatedDamage = damage;
+	glm::vec3 textColor = { 1.0,1.0,1.0 };
+	glm::vec3 textScale = { 10,10,10 };
+	Hydra::Component::ParticleComponent::ParticleTexture particleTexture;
+	if (rgbc) {
+		auto compound = static_cast<btCompoundShape*>(static_cast<btRigidBody*>(rgbc->getRigidBody())->getCollisionShape());
+		if (compound->getNumChildShapes() > 1) {
+			glm::vec3 child1Pos = rgbc->getPosition(0);
+			glm::vec3 child2Pos = rgbc->getPosition(1);
+			float distance1 = glm::distance(child1Pos, point);
+			float distance2 = glm::distance(child2Pos, point);
+			if (distance2 < distance1) {
+				accumulatedDamage *= 2.0f; // 2.0 multiplier on HS.
+				textColor = glm::vec3(4, 0.5, 0.5);
+				textScale = glm::vec3(15, 15, 15);
+				headshot = true;
 			}
+		}
+	}
 
-			// Set the bullet entity to dead.
-			if (bulletComponent)
-				World::World::World::getEntity(bulletComponent->entityID)->dead = true;
+	if (!Hydra::IEngine::getInstance()->getDeadSystem()) {
+		lifeComponent->applyDamage(accumulatedDamage);
+	}
 
-			// Breaks because just wanna check the first collision point.
+	AIComponent* aiComponent = target.ai;
+
+	if (!target.player && aiComponent) {
+		_spawnText(point, std::to_string(accumulatedDamage), textColor, textScale);
+		switch (aiComponent->behaviour->type) {
+		case Hydra::Physics::Behaviour::Behaviour::Type::ALIEN: {
+			if (headshot)
+				particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::AlienHS;
+			else
+				particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::AlienBlood;
+			_spawnParticleEmitterAt(point, normal, particleTexture);
+			break;
+		}
+		case Hydra::Physics::Behaviour::Behaviour::Type::ROBOT: {
+			if (headshot)
+				particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::AlienHS;
+			else
+				particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::Energy;
+			_spawnParticleEmitterAt(point, normal, particleTexture);
 			break;
 		}
+		default:
+			break;
+		}
+	} else if (target.spawner) {
+		_spawnText(point, std::to_string(accumulatedDamage), textColor, textScale);
+		particleTexture = Hydra::Component::ParticleComponent::ParticleTexture::Energy;
+		_spawnParticleEmitterAt(point, normal, particleTexture);
 	}
+}
+
+void BulletPhysicsSystem::tick(float delta) {
+	const auto start = std::chrono::high_resolution_clock::now();
+	_data->dynamicsWorld->stepSimulation(delta, 3);
+	_stepTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	//_data->dynamicsWorld->stepSimulation(delta, 3, btScalar(1.0) / btScalar(180.));
+	_collectContacts();
+	_handleContacts();
 
 	entities.clear();
 }
 
+// Only the first contact point of a manifold is looked at
+void BulletPhysicsSystem::_collectContacts() {
+	std::vector<ContactEvent>& contacts = _data->contacts;
+	contacts.clear();
+	btDispatcher* dispatcher = _data->dynamicsWorld->getDispatcher();
+	const int numManifolds = dispatcher->getNumManifolds();
+	for (int i = 0; i < numManifolds; i++) {
+		btPersistentManifold* contactManifold = dispatcher->getManifoldByIndexInternal(i);
+		Body* a = static_cast<Body*>(contactManifold->getBody0()->getUserPointer());
+		Body* b = static_cast<Body*>(contactManifold->getBody1()->getUserPointer());
+		if (!a || !b || !a->refresh() || !b->refresh())
+			continue;
+
+		Body* player = a->player ? a : (b->player ? b : nullptr);
+		Body* pickup = a->pickup ? a : (b->pickup ? b : nullptr);
+		Body* picker = pickup == a ? b : a;
+		if (pickup && picker->perk)
+			contacts.push_back(ContactEvent{ContactEvent::Type::PickUp, pickup, picker, player, false, glm::vec3(0), glm::vec3(0)});
+
+		if (!contactManifold->getNumContacts())
+			continue;
+		const btManifoldPoint& pt = contactManifold->getContactPoint(0);
+		const glm::vec3 point = cast(pt.getPositionWorldOnB());
+		const glm::vec3 normal = cast(pt.m_normalWorldOnB);
+
+		if (player && normal.y > 0.7f) {
+			const bool floor = a->collisionType == COLL_FLOOR || b->collisionType == COLL_FLOOR;
+			contacts.push_back(ContactEvent{ContactEvent::Type::Ground, player, nullptr, player, floor, point, normal});
+		}
+
+		Body* bullet = a->bullet ? a : (b->bullet ? b : nullptr);
+		if (bullet)
+			contacts.push_back(ContactEvent{ContactEvent::Type::BulletHit, bullet, bullet == a ? b : a, nullptr, false, point, normal});
+	}
+}
+
+void BulletPhysicsSystem::_handleContacts() {
+	for (const ContactEvent& contact : _data->contacts) {
+		switch (contact.type) {
+		case ContactEvent::Type::PickUp:
+			if (IEngine::getInstance()->getDeadSystem() && contact.player)
+				_spawnText(contact.player->entity->getComponent<Hydra::Component::TransformComponent>()->position, "eyyy\n");
+			_addPickUp(contact.a->pickup, contact.b->perk);
+			break;
+		case ContactEvent::Type::Ground:
+			contact.player->player->onGround = true;
+			contact.player->player->onFloor = contact.floor;
+			break;
+		case ContactEvent::Type::BulletHit:
+			_applyBulletHit(*contact.b, contact.a->bullet->damage, contact.point, contact.normal);
+			// Set the bullet entity to dead.
+			contact.a->entity->kill();
+			break;
+		}
+	}
+}
+
 void BulletPhysicsSystem::_spawnParticleEmitterAt(const glm::vec3& pos, const glm::vec3& normal, const Hydra::Component::ParticleComponent::ParticleTexture& effect) {
 	auto pE = Hydra::World::World::newEntity("Collision Particle Spawner", Hydra::World::World::rootID);
 
@@ -359,7 +626,7 @@ void Hydra::System::BulletPhysicsSystem::_addPickUp(PickUpComponent * pickupComp
 			perkComponent->newPerks.push_back(PerkComponent::Perk(perksNotFound[newPerk]));
 		}
 		if(IEngine::getInstance()->getDeadSystem())
-			World::World::World::getEntity(pickupComponent->entityID)->dead = true;
+			World::World::World::getEntity(pickupComponent->entityID)->kill();
 	}
 		break;
 	case PickUpComponent::PICKUP_HEALTH: {
@@ -387,4 +654,12 @@ void Hydra::System::BulletPhysicsSystem::_addPickUp(PickUpComponent * pickupComp
 
 }
 
-void BulletPhysicsSystem::registerUI() {}
+void BulletPhysicsSystem::registerUI() {
+	int threads = (int)_threads;
+	if (ImGui::InputInt("Threads (0 is single threaded)", &threads))
+		setThreadCount((size_t)std::max(threads, 0));
+	ImGui::Text("Step: %.2f ms", _stepTime);
+	ImGui::Text("Rays: %zu (%zu hits)", getRayCount(), getRayHitCount());
+	if (ImGui::Button("Reset ray counters"))
+		resetRayCounters();
+}
@@ -1,4 +1,5 @@
 #include <hydra/system/bulletsystem.hpp>
+#include <hydra/world/commandbuffer.hpp>
 
 #include <hydra/ext/openmp.hpp>
 
@@ -16,30 +17,33 @@ BulletSystem::BulletSystem() {}
 BulletSystem::~BulletSystem() {}
 
 void BulletSystem::tick(float delta) {
-	using world = Hydra::World::World;
-
 	//Process WeaponComponent
-	world::getEntitiesWithComponents<Hydra::Component::WeaponComponent>(entities);
+	auto& weapons = _weapons.getEntities();
 	#pragma omp parallel for
-	for (int_openmp_t i = 0; i < (int_openmp_t)entities.size(); i++) {
-		auto w = entities[i]->getComponent<Hydra::Component::WeaponComponent>();
+	for (int_openmp_t i = 0; i < (int_openmp_t)weapons.size(); i++) {
+		auto w = weapons[i]->getComponent<Hydra::Component::WeaponComponent>();
 
 		if (w->fireRateTimer > 0)
 			w->fireRateTimer -= delta;
 	}
 
 	//Process BulletComponent
-	world::getEntitiesWithComponents<Hydra::Component::BulletComponent>(entities);
+	auto& bullets = _bullets.getEntities();
 	#pragma omp parallel for
-	for (int_openmp_t i = 0; i < (int_openmp_t)entities.size(); i++) {
-		auto b = entities[i]->getComponent<Hydra::Component::BulletComponent>();
+	for (int_openmp_t i = 0; i < (int_openmp_t)bullets.size(); i++) {
+		auto b = bullets[i]->getComponent<Hydra::Component::BulletComponent>();
 
 		b->deleteTimer -= delta;
 		if (b->deleteTimer <= 0)
-			entities[i]->dead = true;
+			Hydra::World::World::commands().destroy(bullets[i]->id);
 	}
+}
 
-	entities.clear();
+Hydra::World::SystemAccess BulletSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.writes = ComponentBits::Weapon | ComponentBits::Bullet;
+	return access;
 }
 
 void BulletSystem::registerUI() {}
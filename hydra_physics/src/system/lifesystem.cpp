@@ -1,4 +1,5 @@
 #include <hydra/system/lifesystem.hpp>
+#include <hydra/world/commandbuffer.hpp>
 #include <hydra/component/lifecomponent.hpp>
 #include <hydra/component/particlecomponent.hpp>
 #include <hydra/component/textcomponent.hpp>
@@ -18,16 +19,17 @@ LifeSystem::~LifeSystem() {
 }
 
 void LifeSystem::tick(float delta) {
-	using world = Hydra::World::World;
 	_isKilled.clear();
 
-	world::getEntitiesWithComponents<Hydra::Component::LifeComponent>(entities);
+	auto& entities = _lives.getEntities();
 	#pragma omp parallel for
 	for (int_openmp_t i = 0; i < (int_openmp_t)entities.size(); i++) {
 		auto lifeC = entities[i]->getComponent<Hydra::Component::LifeComponent>();
 		if (lifeC->health <= 0) {
-			entities[i]->dead = true;
-			_isKilled.push_back(lifeC->entityID);
+			const Hydra::World::EntityID id = lifeC->entityID;
+			auto& commands = Hydra::World::World::commands();
+			commands.destroy(id);
+			commands.defer([this, id]() { _isKilled.push_back(id); });
 			//if (auto enemy = entities[i]->getComponent<AIComponent>()){
 			//	auto activeAbilities = enemy->getPlayerEntity()->getComponent<PerkComponent>()->activeAbilities;
 			//	
@@ -40,8 +42,14 @@ void LifeSystem::tick(float delta) {
 			if (lifeC->tickDownWithTime || entities[i]->getComponent<Hydra::Component::ParticleComponent>() || entities[i]->getComponent<Hydra::Component::TextComponent>())
 				lifeC->health -= 1 * delta;
 	}
+}
 
-	entities.clear();
+Hydra::World::SystemAccess LifeSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::Particle | ComponentBits::Text;
+	access.writes = ComponentBits::Life;
+	return access;
 }
 
 void LifeSystem::registerUI() {
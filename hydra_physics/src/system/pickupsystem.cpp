@@ -27,4 +27,12 @@ void PickUpSystem::tick(float delta) {
 	entities.clear();
 }
 
+Hydra::World::SystemAccess PickUpSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::PickUp;
+	access.writes = ComponentBits::RigidBody;
+	return access;
+}
+
 void PickUpSystem::registerUI() {}
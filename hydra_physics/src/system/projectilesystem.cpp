@@ -0,0 +1,138 @@
+/**
+ * Moves the bullets that the weapons fire, without an entity or a rigid body for every bullet.
+ *
+ * License: Mozilla Public License Version 2.0 (https://www.mozilla.org/en-US/MPL/2.0/ OR See accompanying file LICENSE)
+ * Authors:
+ *  - Dan Printzell
+ */
+#include <hydra/system/projectilesystem.hpp>
+
+#include <imgui/imgui.h>
+
+using namespace Hydra::System;
+
+const char* const ProjectileSystem::meshes[ProjectileSystem::MESH_COUNT] = {
+	"assets/objects/Bullet.mATTIC",
+	"assets/objects/Star.mATTIC",
+	"assets/objects/Trident.mATTIC",
+	"assets/objects/Banana.mATTIC",
+	"assets/objects/Duck.mATTIC",
+	"assets/objects/Rock.mATTIC",
+};
+
+void Projectile::serialize(nlohmann::json& json) const {
+	json["velocity"] = velocity;
+	json["damage"] = damage;
+	json["size"] = size;
+	json["lifetime"] = lifetime;
+	json["collisionType"] = collisionType;
+	json["meshType"] = meshType;
+	json["colour"] = {colour.x, colour.y, colour.z};
+	json["glow"] = glow;
+	json["glowIntensity"] = glowIntensity;
+}
+
+void Projectile::deserialize(const nlohmann::json& json) {
+	velocity = json.value<float>("velocity", 0);
+	damage = json.value<float>("damage", 6);
+	size = json.value<float>("size", 0.5f);
+	lifetime = json.value<float>("lifetime", 10);
+	collisionType = json.value<int>("collisionType", BulletPhysicsSystem::COLL_PLAYER_PROJECTILE);
+	meshType = json.value<int>("meshType", 0);
+	auto c = json.find("colour");
+	if (c != json.end() && c->is_array() && c->size() == 3)
+		colour = glm::vec3((*c)[0].get<float>(), (*c)[1].get<float>(), (*c)[2].get<float>());
+	glow = json.value<bool>("glow", true);
+	glowIntensity = json.value<float>("glowIntensity", 1);
+}
+
+ProjectileSystem::ProjectileSystem(BulletPhysicsSystem& physics) : _physics(physics) {}
+ProjectileSystem::~ProjectileSystem() {}
+
+void ProjectileSystem::fire(const Projectile& projectile) {
+	std::lock_guard<std::mutex> lock(_firedMutex);
+	_fired.push_back(projectile);
+}
+
+void ProjectileSystem::clear() {
+	{
+		std::lock_guard<std::mutex> lock(_firedMutex);
+		_fired.clear();
+	}
+	while (size())
+		_remove(size() - 1);
+}
+
+void ProjectileSystem::tick(float delta) {
+	{
+		std::lock_guard<std::mutex> lock(_firedMutex);
+		_adding.swap(_fired);
+	}
+	for (const Projectile& projectile : _adding)
+		_add(projectile);
+	_adding.clear();
+
+	_rays.resize(size());
+	_rayHits.resize(size());
+	for (size_t i = 0; i < size(); i++)
+		_rays[i] = BulletPhysicsSystem::Ray{_positions[i], _positions[i] + _velocities[i] * delta, _collisionTypes[i], BulletPhysicsSystem::collidesWith(_collisionTypes[i])};
+	_physics.rayTest(_rays.data(), _rays.size(), _rayHits.data(), true);
+
+	// Backwards, so the bullet that _remove moves into i has already been moved this tick. The rays stay where they
+	// are, i is only read once.
+	for (size_t i = size(); i-- > 0;) {
+		const BulletPhysicsSystem::RayHit& hit = _rayHits[i];
+		if (hit.fraction < 1) {
+			// applyBulletHit can spawn entities, that is fine as this system is structural
+			_physics.applyBulletHit(Hydra::World::World::getEntity(hit.entity).get(), _damages[i], hit.point, hit.normal);
+			_hits++;
+			_remove(i);
+			continue;
+		}
+		_positions[i] = _rays[i].to;
+		_lifetimes[i] -= delta;
+		if (_lifetimes[i] <= 0)
+			_remove(i);
+	}
+}
+
+void ProjectileSystem::registerUI() {
+	ImGui::Text("Bullets: %zu", size());
+	ImGui::Text("Hits: %zu", _hits);
+}
+
+void ProjectileSystem::_add(const Projectile& projectile) {
+	_positions.push_back(projectile.position);
+	_velocities.push_back(projectile.direction * projectile.velocity);
+	_lifetimes.push_back(projectile.lifetime);
+	_collisionTypes.push_back(projectile.collisionType);
+	_rotations.push_back(projectile.rotation);
+	_sizes.push_back(projectile.size);
+	_damages.push_back(projectile.damage);
+	_meshTypes.push_back((uint8_t)glm::clamp(projectile.meshType, 0, MESH_COUNT - 1));
+	_colours.push_back(glm::vec4(projectile.colour, projectile.glow ? projectile.glowIntensity : 0.0f));
+}
+
+void ProjectileSystem::_remove(size_t i) {
+	const size_t last = size() - 1;
+	if (i != last) {
+		_positions[i] = _positions[last];
+		_velocities[i] = _velocities[last];
+		_lifetimes[i] = _lifetimes[last];
+		_collisionTypes[i] = _collisionTypes[last];
+		_rotations[i] = _rotations[last];
+		_sizes[i] = _sizes[last];
+		_damages[i] = _damages[last];
+		_meshTypes[i] = _meshTypes[last];
+		_colours[i] = _colours[last];
+	}
+	_positions.pop_back();
+	_velocities.pop_back();
+	_lifetimes.pop_back();
+	_collisionTypes.pop_back();
+	_rotations.pop_back();
+	_sizes.pop_back();
+	_damages.pop_back();
+	_meshTypes.pop_back();
+	_colours.pop_back();
+}
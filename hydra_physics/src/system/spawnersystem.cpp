@@ -1,4 +1,5 @@
 #include "hydra/system/spawnersystem.hpp"
+#include <hydra/world/commandbuffer.hpp>
 
 #include <hydra/ext/openmp.hpp>
 
@@ -61,54 +62,56 @@ void SpawnerSystem::tick(float delta)
 					{
 						if (spawner->spawnTimer >= 10)
 						{
-							auto alienSpawn = world::newEntity("SlowAlien2", world::root());
-							didJustSpawn.push_back(alienSpawn.get());
-							alienSpawn->addComponent<Hydra::Component::NetworkSyncComponent>();
-							alienSpawn->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/characters/AlienModel2.mATTIC");
-							auto as = alienSpawn->addComponent<Hydra::Component::AIComponent>();
-							as->behaviour = std::make_shared<AlienBehaviour>(alienSpawn);
-							as->behaviour->setPathMap(spawner->map);
-							as->damage = 4;
-							as->behaviour->originalRange = 4.0f;
-							as->behaviour->savedRange = as->behaviour->originalRange;
-							as->radius = 1;
-
-
-							auto hs = alienSpawn->addComponent<Hydra::Component::LifeComponent>();
-							hs->maxHP = 80;
-							hs->health = 80;
-
-							auto ws = alienSpawn->addComponent<Hydra::Component::WeaponComponent>();
-							ws->meshType = 5;
-							ws->bulletSpread = 0.2f;
-							ws->bulletsPerShot = 1;
-							ws->damage = 4;
-							ws->bulletSize = 0.3;
-							ws->maxmagammo = 0;
-							ws->currmagammo = 0;
-							ws->maxammo = 0;
-							ws->userdata = userdata;
-							ws->onShoot = onShoot;
-
-							auto ms = alienSpawn->addComponent<Hydra::Component::MovementComponent>();
-							ms->movementSpeed = 5.0f;
-
-							auto ts = alienSpawn->addComponent<Hydra::Component::TransformComponent>();
-							ts->position.x = transform->position.x;
-							ts->position.y = 1.0;
-							ts->position.z = transform->position.z;
-							ts->scale = glm::vec3{ 1,1,1 };
-
-							auto rgbcs = alienSpawn->addComponent<Hydra::Component::RigidBodyComponent>();
-							rgbcs->createBox(glm::vec3(0.5f, 1.0f, 0.5f) * ts->scale, glm::vec3(0, 1 * ts->scale.y, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_ENEMY, 100.0f, 0, 0, 0.6f, 1.0f);
-							rgbcs->createCapsuleY(0.5f, 1.0f * ts->scale.y, glm::vec3(0, 2.6 * ts->scale.y, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_HEAD, 10000, 0, 0, 0.0f, 0);
-							rgbcs->setActivationState(Hydra::Component::RigidBodyComponent::ActivationState::disableDeactivation);
-							rgbcs->setAngularForce(glm::vec3(0));
-							spawner->spawnGroup.push_back(alienSpawn->id);
+							const glm::vec3 position = transform->position;
+							world::commands().spawn("SlowAlien2", world::rootID, [this, spawner, position](const std::shared_ptr<Hydra::World::Entity>& alienSpawn) {
+								didJustSpawn.push_back(alienSpawn.get());
+								alienSpawn->addComponent<Hydra::Component::NetworkSyncComponent>();
+								alienSpawn->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/characters/AlienModel2.mATTIC");
+								auto as = alienSpawn->addComponent<Hydra::Component::AIComponent>();
+								as->behaviour = std::make_shared<AlienBehaviour>(alienSpawn);
+								as->behaviour->setPathMap(spawner->map);
+								as->damage = 4;
+								as->behaviour->originalRange = 4.0f;
+								as->behaviour->savedRange = as->behaviour->originalRange;
+								as->radius = 1;
+
+
+								auto hs = alienSpawn->addComponent<Hydra::Component::LifeComponent>();
+								hs->maxHP = 80;
+								hs->health = 80;
+
+								auto ws = alienSpawn->addComponent<Hydra::Component::WeaponComponent>();
+								ws->meshType = 5;
+								ws->bulletSpread = 0.2f;
+								ws->bulletsPerShot = 1;
+								ws->damage = 4;
+								ws->bulletSize = 0.3;
+								ws->maxmagammo = 0;
+								ws->currmagammo = 0;
+								ws->maxammo = 0;
+								ws->userdata = userdata;
+								ws->onShoot = onShoot;
+
+								auto ms = alienSpawn->addComponent<Hydra::Component::MovementComponent>();
+								ms->movementSpeed = 5.0f;
+
+								auto ts = alienSpawn->addComponent<Hydra::Component::TransformComponent>();
+								ts->position.x = position.x;
+								ts->position.y = 1.0;
+								ts->position.z = position.z;
+								ts->scale = glm::vec3{ 1,1,1 };
+
+								auto rgbcs = alienSpawn->addComponent<Hydra::Component::RigidBodyComponent>();
+								rgbcs->createBox(glm::vec3(0.5f, 1.0f, 0.5f) * ts->scale, glm::vec3(0, 1 * ts->scale.y, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_ENEMY, 100.0f, 0, 0, 0.6f, 1.0f);
+								rgbcs->createCapsuleY(0.5f, 1.0f * ts->scale.y, glm::vec3(0, 2.6 * ts->scale.y, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_HEAD, 10000, 0, 0, 0.0f, 0);
+								rgbcs->setActivationState(Hydra::Component::RigidBodyComponent::ActivationState::disableDeactivation);
+								rgbcs->setAngularForce(glm::vec3(0));
+								spawner->spawnGroup.push_back(alienSpawn->id);
+
+								static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem())->enable(rgbcs.get());
+							});
 							spawner->spawnTimer = 0;
 
-							static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem())->enable(rgbcs.get());
-
 						}
 					}
 				}break;
@@ -118,52 +121,54 @@ void SpawnerSystem::tick(float delta)
 					{
 						if (spawner->spawnTimer >= 10)
 						{
-							auto robotSpawn = world::newEntity("Robot2", world::root());
-							didJustSpawn.push_back(robotSpawn.get());
-							robotSpawn->addComponent<Hydra::Component::NetworkSyncComponent>();
-							robotSpawn->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/characters/RobotModel2.mATTIC");
-							auto as = robotSpawn->addComponent<Hydra::Component::AIComponent>();
-							as->behaviour = std::make_shared<RobotBehaviour>(robotSpawn);
-							as->behaviour->setPathMap(spawner->map);
-							as->damage = 6;
-							as->behaviour->originalRange = 18.0f;
-							as->behaviour->savedRange = as->behaviour->originalRange;
-							as->radius = 1;
-
-							auto hs = robotSpawn->addComponent<Hydra::Component::LifeComponent>();
-							hs->maxHP = 70;
-							hs->health = 70;
-
-							auto ws = robotSpawn->addComponent<Hydra::Component::WeaponComponent>();
-							ws->bulletSpread = 0.3f;
-							ws->fireRateRPM = 70;
-							ws->bulletsPerShot = 1;
-							ws->damage = 6;
-							ws->bulletSize = 0.3;
-							ws->maxmagammo = 0;
-							ws->currmagammo = 0;
-							ws->maxammo = 0;
-							ws->userdata = userdata;
-							ws->onShoot = onShoot;
-
-							auto ms = robotSpawn->addComponent<Hydra::Component::MovementComponent>();
-							ms->movementSpeed = 3.0f;
-							auto ts = robotSpawn->addComponent<Hydra::Component::TransformComponent>();
-							ts->position.x = transform->position.x;
-							ts->position.y = 1.0;
-							ts->position.z = transform->position.z;
-							ts->scale = glm::vec3{ 1,1,1 };
-
-							auto rgbcs = robotSpawn->addComponent<Hydra::Component::RigidBodyComponent>();
-							rgbcs->createBox(glm::vec3(0.5f, 1.0f, 0.5f) * ts->scale, glm::vec3(0, 1 * ts->scale.y, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_ENEMY, 100.0f, 0, 0, 0.6f, 1.0f);
-							rgbcs->createCapsuleY(0.5f, 1.0f * ts->scale.y, glm::vec3(0, 2.6 * ts->scale.y, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_HEAD, 10000, 0, 0, 0.0f, 0);
-							rgbcs->setActivationState(Hydra::Component::RigidBodyComponent::ActivationState::disableDeactivation);
-							rgbcs->setAngularForce(glm::vec3(0));
-							spawner->spawnGroup.push_back(robotSpawn->id);
+							const glm::vec3 position = transform->position;
+							world::commands().spawn("Robot2", world::rootID, [this, spawner, position](const std::shared_ptr<Hydra::World::Entity>& robotSpawn) {
+								didJustSpawn.push_back(robotSpawn.get());
+								robotSpawn->addComponent<Hydra::Component::NetworkSyncComponent>();
+								robotSpawn->addComponent<Hydra::Component::MeshComponent>()->loadMesh("assets/objects/characters/RobotModel2.mATTIC");
+								auto as = robotSpawn->addComponent<Hydra::Component::AIComponent>();
+								as->behaviour = std::make_shared<RobotBehaviour>(robotSpawn);
+								as->behaviour->setPathMap(spawner->map);
+								as->damage = 6;
+								as->behaviour->originalRange = 18.0f;
+								as->behaviour->savedRange = as->behaviour->originalRange;
+								as->radius = 1;
+
+								auto hs = robotSpawn->addComponent<Hydra::Component::LifeComponent>();
+								hs->maxHP = 70;
+								hs->health = 70;
+
+								auto ws = robotSpawn->addComponent<Hydra::Component::WeaponComponent>();
+								ws->bulletSpread = 0.3f;
+								ws->fireRateRPM = 70;
+								ws->bulletsPerShot = 1;
+								ws->damage = 6;
+								ws->bulletSize = 0.3;
+								ws->maxmagammo = 0;
+								ws->currmagammo = 0;
+								ws->maxammo = 0;
+								ws->userdata = userdata;
+								ws->onShoot = onShoot;
+
+								auto ms = robotSpawn->addComponent<Hydra::Component::MovementComponent>();
+								ms->movementSpeed = 3.0f;
+								auto ts = robotSpawn->addComponent<Hydra::Component::TransformComponent>();
+								ts->position.x = position.x;
+								ts->position.y = 1.0;
+								ts->position.z = position.z;
+								ts->scale = glm::vec3{ 1,1,1 };
+
+								auto rgbcs = robotSpawn->addComponent<Hydra::Component::RigidBodyComponent>();
+								rgbcs->createBox(glm::vec3(0.5f, 1.0f, 0.5f) * ts->scale, glm::vec3(0, 1 * ts->scale.y, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_ENEMY, 100.0f, 0, 0, 0.6f, 1.0f);
+								rgbcs->createCapsuleY(0.5f, 1.0f * ts->scale.y, glm::vec3(0, 2.6 * ts->scale.y, 0), Hydra::System::BulletPhysicsSystem::CollisionTypes::COLL_HEAD, 10000, 0, 0, 0.0f, 0);
+								rgbcs->setActivationState(Hydra::Component::RigidBodyComponent::ActivationState::disableDeactivation);
+								rgbcs->setAngularForce(glm::vec3(0));
+								spawner->spawnGroup.push_back(robotSpawn->id);
+
+								static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem())->enable(rgbcs.get());
+							});
 							spawner->spawnTimer = 0;
 
-							static_cast<Hydra::System::BulletPhysicsSystem*>(Hydra::IEngine::getInstance()->getState()->getPhysicsSystem())->enable(rgbcs.get());
-
 						}
 					}
 				}break;
@@ -176,5 +181,13 @@ void SpawnerSystem::tick(float delta)
 	entities.clear();
 }
 
+Hydra::World::SystemAccess SpawnerSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::Transform;
+	access.writes = ComponentBits::Spawner | ComponentBits::Life;
+	return access;
+}
+
 void SpawnerSystem::registerUI() {}
 
@@ -10,6 +10,7 @@ namespace Hydra::System {
 		~SoundFxSystem() final;
 
 		void tick(float delta) final;
+		Hydra::World::SystemAccess access() const final;
 		inline const std::string type() const final { return "SoundFxSystem"; }
 		void registerUI() final;
 		
@@ -20,5 +21,7 @@ namespace Hydra::System {
 		std::vector<std::string> soundPath = std::vector<std::string>();
 		std::vector<Mix_Chunk*> soundChunk = std::vector<Mix_Chunk*>();
 		float removeTimer = 5;
+		Hydra::World::Query<Hydra::Component::PlayerComponent> _players;
+		Hydra::World::Query<Hydra::Component::SoundFxComponent, Hydra::Component::TransformComponent> _sounds;
 	};
 }
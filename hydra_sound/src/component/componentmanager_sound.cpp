@@ -7,7 +7,7 @@ using namespace Hydra::World;
 namespace Hydra::Component::ComponentManager {
 	void registerComponents_sound(std::map<std::string, createOrGetComponent_f>& creators) {
 		(void)creators;
-		SoundFxComponent::componentHandler = new ComponentHandler<SoundFxComponent>();
+		SoundFxComponent::componentHandler = new ComponentHandler<SoundFxComponent>("SoundFxComponent");
 		creators["SoundFxComponent"] = &createOrGetComponentHelper<SoundFxComponent>;
 	}
 }
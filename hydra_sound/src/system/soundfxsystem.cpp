@@ -25,12 +25,10 @@ SoundFxSystem::~SoundFxSystem() {
 }
 
 void SoundFxSystem::tick(float delta) {
-	std::shared_ptr<Hydra::World::Entity> player;
-	world::getEntitiesWithComponents<PlayerComponent>(entities);
-	if (entities.empty())
+	if (_players.getEntities().empty())
 		return;
 
-	player = entities[0];
+	const std::shared_ptr<Hydra::World::Entity>& player = _players.getEntities()[0];
 	auto playerCamera = player->getComponent<CameraComponent>();
 	auto playerT = player->getComponent<TransformComponent>();
 	glm::mat4 rotation = glm::mat4_cast(playerT->rotation);
@@ -38,7 +36,7 @@ void SoundFxSystem::tick(float delta) {
 	const glm::vec3 forward = glm::vec3(glm::vec4{ 0, 0, 1, 0 } * rotation);
 	const glm::vec3 playerPos = player->getComponent<TransformComponent>()->position;
 
-	world::getEntitiesWithComponents<SoundFxComponent, TransformComponent>(entities);
+	auto& entities = _sounds.getEntities();
 	for (int_openmp_t i = 0; i < (int_openmp_t)entities.size(); i++) {
 		auto transform = entities[i]->getComponent<TransformComponent>();
 		auto soundFx = entities[i]->getComponent<SoundFxComponent>();
@@ -81,7 +79,6 @@ void SoundFxSystem::tick(float delta) {
 			Mix_SetPosition(soundFx->playingChannels[i], angleToPlayer, distance);
 		}
 	}
-	entities.clear();
 	
 	//Removing used sound effects
 	removeTimer -= delta;
@@ -190,4 +187,13 @@ void Hydra::System::SoundFxSystem::startMusic(std::string songPath){
 	Mix_VolumeMusic(MIX_MAX_VOLUME/4);
 }
 
+Hydra::World::SystemAccess SoundFxSystem::access() const {
+	using Hydra::Component::ComponentBits;
+	Hydra::World::SystemAccess access;
+	access.reads = ComponentBits::Transform | ComponentBits::Camera;
+	access.writes = ComponentBits::SoundFx;
+	access.mainThread = true; // SDL_mixer
+	return access;
+}
+
 void SoundFxSystem::registerUI() {}
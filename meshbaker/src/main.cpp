@@ -0,0 +1,123 @@
+#include <hydra/io/bakedmesh.hpp>
+#include <hydra/ext/mappedfile.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <filesystem>
+#else
+#include <experimental/filesystem>
+#endif
+
+using namespace Hydra::IO;
+using namespace Hydra::Ext;
+
+static std::vector<std::string> findMeshes(const std::string& dir) {
+	std::vector<std::string> files;
+	for (auto& p : std::experimental::filesystem::recursive_directory_iterator(dir)) {
+		const std::string file = p.path().generic_string();
+		if (file.size() > 7 && file.compare(file.size() - 7, 7, ".mATTIC") == 0)
+			files.push_back(file);
+	}
+	return files;
+}
+
+static bool writeFile(const std::string& file, const std::vector<uint8_t>& data) {
+	const std::string tmp = file + ".tmp";
+	{
+		std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+		out.write((const char*)data.data(), data.size());
+		if (!out.good())
+			return false;
+	}
+	std::error_code ec;
+	std::experimental::filesystem::rename(tmp, file, ec);
+	return !ec;
+}
+
+static int bakeAll(const std::vector<std::string>& files) {
+	int failed = 0;
+	std::vector<uint8_t> data;
+	for (const std::string& file : files) {
+		const std::string baked = BakedMesh::bakedPath(file);
+		if (!BakedMesh::bake(file, data)) {
+			printf("FAILED %s\n", file.c_str());
+			failed++;
+		} else if (!writeFile(baked, data)) {
+			printf("FAILED to write %s\n", baked.c_str());
+			failed++;
+		} else
+			printf("%s (%zu kB)\n", baked.c_str(), data.size() / 1024);
+	}
+	printf("Baked %zu of %zu meshes\n", files.size() - failed, files.size());
+	return failed ? 1 : 0;
+}
+
+// Only measures the CPU side of loading, the time to get the vertices, indices and animation matrices ready for upload.
+// The source files are parsed the same way as GLMesh did before the baked files.
+static int benchmark(const std::vector<std::string>& files, int iterations) {
+	using clock = std::chrono::high_resolution_clock;
+	double sourceTime = 0;
+	double bakedTime = 0;
+	size_t bakedBytes = 0;
+	size_t meshes = 0;
+	std::vector<uint8_t> data;
+
+	for (int i = 0; i < iterations; i++) {
+		for (const std::string& file : files) {
+			auto start = clock::now();
+			const bool ok = BakedMesh::bake(file, data);
+			sourceTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+			if (!ok)
+				continue;
+
+			start = clock::now();
+			MappedFile mapped(BakedMesh::bakedPath(file));
+			BakedMesh::View view;
+			if (!mapped.isOpen() || !BakedMesh::parse(mapped.data(), mapped.size(), view)) {
+				printf("%s is not baked, run meshbaker first\n", file.c_str());
+				return 1;
+			}
+			// Touch every page, like the upload would
+			volatile uint8_t sum = 0;
+			for (size_t offset = 0; offset < mapped.size(); offset += 4096)
+				sum += mapped.data()[offset];
+			bakedTime += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+			bakedBytes += mapped.size();
+			meshes++;
+		}
+	}
+
+	printf("%zu meshes, %d iterations\n", meshes / iterations, iterations);
+	printf("Source files: %8.2f ms per pass\n", sourceTime / iterations);
+	printf("Baked files:  %8.2f ms per pass (%.1f MB)\n", bakedTime / iterations, bakedBytes / (double)iterations / (1024 * 1024));
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	std::string dir = "assets/objects";
+	bool runBenchmark = false;
+	int iterations = 5;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--benchmark"))
+			runBenchmark = true;
+		else if (!strcmp(argv[i], "--iterations") && i + 1 < argc)
+			iterations = std::max(atoi(argv[++i]), 1);
+		else if (argv[i][0] != '-')
+			dir = argv[i];
+		else {
+			printf("Usage: %s [--benchmark] [--iterations N] [directory]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	const std::vector<std::string> files = findMeshes(dir);
+	return runBenchmark ? benchmark(files, iterations) : bakeAll(files);
+}
@@ -1,18 +1,57 @@
 #pragma once
+#include <memory>
 #include <vector>
 #include <SDL2/SDL_net.h>
 #include <server/packets.hpp>
+#include <hydra/network/packetbuffer.hpp>
 
 #define MAX_NETWORK_LENGTH 100000
 
 namespace BarcodeServer {
-	class ClientHandler {
+	class IClientHandler {
+	public:
+		virtual ~IClientHandler() = 0;
+
+		///<summary>
+		///Starts listening for clients on said port. Clients above maxConnections are disconnected directly.
+		///</summary>
+		virtual bool listen(int port, size_t maxConnections) = 0;
+
+		///<summary>
+		///Returns id of new client, returns -1 otherwise.
+		///</summary>
+		virtual int checkForNewClients() = 0;
+
+		///<summary>
+		///The packets point into the receive buffers and are only valid until the next call, don't delete them.
+		///</summary>
+		virtual std::vector<Hydra::Network::Packet*> receiveData() = 0;
+
+		virtual int sendData(char* data, int len, int clientID) = 0;
+
+		///<summary>
+		///Returns true if the client has so much unsent data that packets that can be skipped should be skipped.
+		///</summary>
+		virtual bool isCongested(int clientID) = 0;
+
+		virtual std::vector<int> getAllClients() = 0;
+		virtual std::vector<int> getDisconnectedClients() = 0;
+		virtual void disconnectClient(int id) = 0;
+		virtual int getNrOfClients() = 0;
+	};
+	inline IClientHandler::~IClientHandler() {}
+
+	///<summary>
+	///SDL_net backend, sends are blocking.
+	///</summary>
+	class ClientHandler final : public IClientHandler {
 	private:
 		struct Client {
 			bool isDead;
 			TCPsocket socket;
 			int id;
 			int socketSet;
+			Hydra::Network::PacketRingBuffer buffer{MAX_NETWORK_LENGTH};
 		};
 
 		struct SocketSet {
@@ -28,15 +67,21 @@ namespace BarcodeServer {
 		std::vector<SocketSet> _sets;
 		std::vector<Client*> _clients;
 		std::vector<int> _disconnectedClients;
-		char* _msg;
+		// Buffers of disconnected clients, kept until the next receiveData as packets from them still can be in use
+		std::vector<std::unique_ptr<Client>> _retiredClients;
 		int _currID;
+		TCPsocket _sock = nullptr;
+		size_t _maxConnections = 0;
 
 		int _generateClientID();
 	public:
 		ClientHandler();
-		~ClientHandler();
+		~ClientHandler() final;
 
-		void initialize(char* msg);
+		bool listen(int port, size_t maxConnections) final;
+		int checkForNewClients() final;
+		std::vector<Hydra::Network::Packet*> receiveData() final;
+		bool isCongested(int /*clientID*/) final { return false; }
 		TCPsocket getSocketFromID(int id);
 		///<summary>
 		///Returns the number of clients that have pending packets.
@@ -44,7 +89,7 @@ namespace BarcodeServer {
 		int getActivity();
 
 		///<summary>
-		///Delete packets after use!
+		///The packets are only valid until the next call, don't delete them.
 		///</summary>
 		std::vector<Hydra::Network::Packet*> getReceivedData(int pending);
 
@@ -52,14 +97,14 @@ namespace BarcodeServer {
 		///Returns id of new client. Quite inefficient, However shouldn't be a problem as this function is rarely called.
 		///</summary>
 		int addNewConnection(TCPsocket sock);
-		int sendData(char* data, int len, int clientID);
+		int sendData(char* data, int len, int clientID) final;
 
-		std::vector<int> getAllClients();
+		std::vector<int> getAllClients() final;
 
-		std::vector<int> getDisconnectedClients();
+		std::vector<int> getDisconnectedClients() final;
 
-		void disconnectClient(int id);
+		void disconnectClient(int id) final;
 
-		int getNrOfClients();
+		int getNrOfClients() final;
 	};
 }
@@ -0,0 +1,67 @@
+#pragma once
+#ifdef __linux__
+#include <vector>
+#include <unordered_map>
+#include <server/clienthandler.hpp>
+
+namespace BarcodeServer {
+	///<summary>
+	///Linux epoll backend with nonblocking sockets. Data that can't be sent directly is queued per client and sent when
+	///the socket is writable again, so a slow client never stalls the server.
+	///</summary>
+	class EpollClientHandler final : public IClientHandler {
+	public:
+		// A client with more unsent data than this is disconnected
+		static constexpr size_t MAX_QUEUED_BYTES = 8 * 1024 * 1024;
+		// Above this isCongested returns true
+		static constexpr size_t CONGESTED_BYTES = 256 * 1024;
+
+		EpollClientHandler();
+		~EpollClientHandler() final;
+
+		// Only accept connections from this machine, call it before listen
+		inline void setLoopbackOnly(bool loopbackOnly) { _loopbackOnly = loopbackOnly; }
+
+		bool listen(int port, size_t maxConnections) final;
+		int checkForNewClients() final;
+		std::vector<Hydra::Network::Packet*> receiveData() final;
+		int sendData(char* data, int len, int clientID) final;
+		bool isCongested(int clientID) final;
+		std::vector<int> getAllClients() final;
+		std::vector<int> getDisconnectedClients() final;
+		void disconnectClient(int id) final;
+		int getNrOfClients() final;
+
+	private:
+		struct Client {
+			int fd;
+			Hydra::Network::PacketRingBuffer readBuffer{MAX_NETWORK_LENGTH};
+			std::vector<uint8_t> writeQueue;
+			size_t writeOffset = 0; // Bytes at the start of writeQueue that already have been sent
+			bool waitingForWrite = false;
+
+			inline size_t queuedBytes() const { return writeQueue.size() - writeOffset; }
+		};
+
+		int _epoll = -1;
+		int _listen = -1;
+		size_t _maxConnections = 0;
+		bool _loopbackOnly = false;
+		int _currID = 0;
+		std::unordered_map<int /* id */, Client> _clients;
+		std::vector<int> _newClients;
+		std::vector<int> _disconnectedClients;
+		// Only filled by the _poll in receiveData, after the packets of the last call have been released
+		std::vector<Hydra::Network::Packet*> _packets;
+		// Buffers of disconnected clients, kept until the next receiveData as packets from them still can be in use
+		std::vector<Hydra::Network::PacketRingBuffer> _retiredBuffers;
+
+		void _poll();
+		void _accept();
+		bool _read(int id, Client& client);
+		bool _flush(Client& client);
+		void _setWaitingForWrite(int id, Client& client, bool wait);
+		void _drop(int id);
+	};
+}
+#endif
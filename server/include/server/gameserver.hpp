@@ -2,15 +2,19 @@
 #include <server/server.hpp>
 #include <server/tilegeneration.hpp>
 #include <hydra/world/world.hpp>
+#include <hydra/world/jobgraph.hpp>
+#include <hydra/world/spatialindex.hpp>
 #include <chrono>
 #include <hydra/system/deadsystem.hpp>
 #include <hydra/system/bulletphysicssystem.hpp>
 #include <hydra/system/aisystem.hpp>
 #include <hydra/system/bulletsystem.hpp>
+#include <hydra/system/projectilesystem.hpp>
 #include <hydra/system/spawnersystem.hpp>
 #include <hydra/system/perksystem.hpp>
 #include <hydra/system/lifesystem.hpp>
 #include <hydra/system/pickupsystem.hpp>
+#include <hydra/network/snapshot.hpp>
 #include <json.hpp>
 
 namespace BarcodeServer {
@@ -20,6 +24,7 @@ namespace BarcodeServer {
 		bool connected = false;
 		nlohmann::json bullet;
 		float shootAnimation = 0;
+		uint32_t lastSnapshot = 0;
 
 		Player() {}
 	};
@@ -28,24 +33,58 @@ namespace BarcodeServer {
 	public:
 		GameServer();
 		~GameServer();
-		bool initialize(int port);
+		// Ticks are skipped instead of simulated if the server falls behind more than this
+		static constexpr size_t MAX_CATCH_UP_TICKS = 5;
+		// Seconds between the tick stats log lines
+		static constexpr float STATS_INTERVAL = 5.0f;
+		// About how far apart the players are, see SpatialIndex
+		static constexpr float PLAYER_CELL_SIZE = 32.0f;
+
+		bool initialize(int port, Server::Backend backend = Server::Backend::sdlnet, size_t maxConnections = 64);
 		void start();
+		///<summary>
+		///Handles the network and simulates as many ticks as needed to keep up with the tick rate, then sleeps until
+		///the next tick.
+		///</summary>
 		void run();
+		void setTickRate(int tickRate);
 		void quit();
 		Hydra::System::BulletPhysicsSystem _physicsSystem;
+		inline Hydra::System::ProjectileSystem& getProjectileSystem() { return _projectileSystem; }
 		inline BarcodeServer::Server* getServer() { return this->_server; }
 		void syncEntity(Hydra::World::Entity* entity);
 		void deleteEntity(Hydra::World::EntityID ent);
 	private:
+		// Timings since the last log line, in milliseconds
+		struct TickStats {
+			std::vector<float> systems; // In the order the systems were added to _jobGraph
+			float criticalPath = 0;
+			float total = 0;
+			float max = 0;
+			float time = 0; // Seconds
+			size_t ticks = 0;
+			size_t droppedTicks = 0;
+		};
 
 		std::chrono::time_point<std::chrono::high_resolution_clock> _lastTime;
-		float _packetDelay;
+		int _tickRate = 30;
+		float _accumulator = 0; // Seconds that have not been simulated yet
+		float _tickTime = 0; // Milliseconds, sent to the clients in ServerPongPacket
+		TickStats _tickStats;
 		Server* _server = nullptr;
 		std::vector<Hydra::World::EntityID> _networkEntities;
 		std::vector<Player*> _players;
+		Hydra::World::SpatialIndex _playerIndex;
+		// The entities that look up their closest player every tick
+		Hydra::World::Query<Hydra::Component::AIComponent, Hydra::Component::TransformComponent> _aiQuery;
+		Hydra::World::Query<Hydra::Component::SpawnerComponent, Hydra::Component::TransformComponent> _spawnerQuery;
+		Hydra::Network::SnapshotHistory _snapshots;
+		uint32_t _snapshotSequence = 0;
+		Hydra::Network::SnapshotPackets _snapshotPackets;
 		std::unique_ptr<TileGeneration> _tileGeneration;
-		bool** _pathfindingMap = nullptr;
-		std::string _pvsData;
+		const PathMap* _pathfindingMap = nullptr;
+		std::vector<uint8_t> _pathMapData;
+		std::vector<uint8_t> _pvsData;
 		size_t level = 0;
 		struct SyncBoi
 		{
@@ -57,15 +96,19 @@ namespace BarcodeServer {
 		Hydra::System::DeadSystem _deadSystem;
 		Hydra::System::AISystem _aiSystem;
 		Hydra::System::BulletSystem _bulletSystem;
+		Hydra::System::ProjectileSystem _projectileSystem;
 		Hydra::System::SpawnerSystem _spawnerSystem;
 		Hydra::System::PerkSystem _perkSystem;
 		Hydra::System::LifeSystem _lifeSystem;
 		Hydra::System::PickUpSystem _pickupSystem;
+		Hydra::World::JobGraph _jobGraph;
 
 		void _makeWorld();
 		void _spawnBoss();
+		void _tick(float delta);
+		void _logTickStats();
 		void _sendWorld();
-		void _convertEntityToTransform(Hydra::Network::ServerUpdatePacket::EntUpdate& dest, Hydra::World::EntityID ent);
+		Hydra::Network::TransformInfo _convertEntityToTransform(Hydra::World::EntityID ent);
 		void _resolvePackets(std::vector<Hydra::Network::Packet*> packets);
 		int64_t _getEntityID(int serverid);
 		void _setEntityID(int serverID, int64_t entityID);
@@ -75,7 +118,7 @@ namespace BarcodeServer {
 		bool _addPlayer(int id);
 		void _sendPathInfo();
 
-		static void _onRobotShoot(WeaponComponent& weapon, Entity* bullet, void* userdata);
+		static void _onRobotShoot(WeaponComponent& weapon, const Hydra::System::Projectile& bullet, void* userdata);
 		void _resolveClientRequestAIInfoPacket(Hydra::Network::ClientRequestAIInfoPacket* packet);
 	};
 }
@@ -3,6 +3,10 @@
 #include <hydra/world/world.hpp>
 #include <hydra/network/packets.hpp>
 
+namespace Hydra::System {
+	class ProjectileSystem;
+}
+
 namespace BarcodeServer {
 	class Server;
 	class Player;
@@ -17,5 +21,5 @@ namespace BarcodeServer {
 	void resolveClientUpdatePacket(Player* p, Hydra::Network::ClientUpdatePacket* cup, Hydra::World::EntityID entityID);
 	Hydra::World::Entity* resolveClientSpawnEntityPacket(Hydra::Network::ClientSpawnEntityPacket* csep, Hydra::World::EntityID entityID, Server* s);
 	void resolveClientUpdateBulletPacket(Hydra::Network::ClientUpdateBulletPacket* cubp, nlohmann::json& dest);
-	Hydra::World::Entity* resolveClientShootPacket(Hydra::Network::ClientShootPacket* csp, Player* p, Hydra::World::ISystem* bp);
+	void resolveClientShootPacket(Hydra::Network::ClientShootPacket* csp, Player* p, Hydra::System::ProjectileSystem& projectiles);
 }
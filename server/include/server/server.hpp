@@ -1,6 +1,7 @@
 #pragma once
 #include <SDL2/SDL_net.h>
 #include <vector>
+#include <memory>
 #include <server/clienthandler.hpp>
 
 //This class should (only) set up TCP connections with clients aswell as send and receive data from clients.
@@ -8,13 +9,18 @@
 namespace BarcodeServer {
 	class Server {
 	public:
+		enum class Backend {
+			sdlnet = 0,
+			epoll // Linux only
+		};
+
 		Server();
 		~Server();
 
 		///<summary>
 		///Starts up a server on said port and returns true if successfull.
 		///</summary>
-		bool initialize(int port);
+		bool initialize(int port, Backend backend = Backend::sdlnet, size_t maxConnections = 64);
 
 		///<summary>
 		///Checks for incoming connections and returns client id on new connection, returns -1 otherwise.
@@ -31,6 +37,11 @@ namespace BarcodeServer {
 		///</summary>
 		int sendDataToClient(char* data, int length, int clientID);
 
+		///<summary>
+		///Returns true if the client is behind on receiving data, so packets that can be skipped should be skipped.
+		///</summary>
+		bool isCongested(int clientID);
+
 		///<summary>
 		///Sends data to every connected client except one specified client.
 		///</summary>
@@ -39,16 +50,15 @@ namespace BarcodeServer {
 		std::vector<int> getDisconnects();
 
 		///<summary>
-		///Delete packets after use.
+		///The packets are only valid until the next call, don't delete them.
 		///</summary>
 		std::vector<Hydra::Network::Packet*> receiveData();
 
 		bool isRunning();
 
 	private:
-		ClientHandler _clientHandler;
+		std::unique_ptr<IClientHandler> _clientHandler;
 
-		TCPsocket _sock;
 		bool _running;
 		int _port;
 	};
@@ -27,13 +27,14 @@
 #include <hydra/component/roomcomponent.hpp>
 #include <hydra/component/weaponcomponent.hpp>
 #include <hydra/system/deadsystem.hpp>
+#include <hydra/pathing/pathmap.hpp>
 #define PICKUP_CHANCE 60
 
 namespace BarcodeServer {
 	class TileGeneration {
 	public:
 		std::shared_ptr<Hydra::Component::RoomComponent> roomGrid[ROOM_GRID_SIZE][ROOM_GRID_SIZE];
-		bool** pathfindingMap = nullptr;
+		PathMap* pathfindingMap = nullptr;
 		size_t maxRooms = 31;
 		size_t roomCounter = 0;
 		size_t numberOfPlayers = 4;
@@ -1,4 +1,5 @@
 #include <server/clienthandler.hpp>
+#include <cstdio>
 #define SocketSetSize 4
 
 using namespace BarcodeServer;
@@ -16,12 +17,36 @@ ClientHandler::~ClientHandler() {
 		SDLNet_TCP_Close(this->_clients[i]->socket);
 		delete this->_clients[i];
 	}
-	delete this->_msg;
+	for (size_t i = 0; i < this->_sets.size(); i++)
+		SDLNet_FreeSocketSet(this->_sets[i].set);
+	if (this->_sock)
+		SDLNet_TCP_Close(this->_sock);
 }
 
-void ClientHandler::initialize(char * msg) {
-	this->_msg = msg;
-	this->_currID = 0;
+bool ClientHandler::listen(int port, size_t maxConnections) {
+	IPaddress ip;
+	if (SDLNet_ResolveHost(&ip, NULL, port) == -1)
+		return false;
+
+	this->_sock = SDLNet_TCP_Open(&ip);
+	this->_maxConnections = maxConnections;
+	return this->_sock != nullptr;
+}
+
+int ClientHandler::checkForNewClients() {
+	TCPsocket sock = SDLNet_TCP_Accept(this->_sock);
+	if (!sock)
+		return -1;
+	if (this->_clients.size() >= this->_maxConnections) {
+		printf("Refusing client, already at the limit of %zu connections\n", this->_maxConnections);
+		SDLNet_TCP_Close(sock);
+		return -1;
+	}
+	return this->addNewConnection(sock);
+}
+
+std::vector<Hydra::Network::Packet*> ClientHandler::receiveData() {
+	return this->getReceivedData(this->getActivity());
 }
 
 TCPsocket ClientHandler::getSocketFromID(int id) {
@@ -43,36 +68,36 @@ int ClientHandler::getActivity() {
 
 std::vector<Hydra::Network::Packet*> ClientHandler::getReceivedData(int pending) {
 	std::vector<Hydra::Network::Packet*> packets;
-	Hydra::Network::Packet* tmp;
-	Hydra::Network::Packet* tmp2;
-	size_t curr = 0;
-	size_t offset = 0;
 	std::vector<int> tmpvec;
+	// The packets from the last call are not used anymore
+	this->_retiredClients.clear();
 	for (size_t i = 0; i < this->_clients.size(); i++) {
-		curr = 0;
-		offset = 0;
-		while (SDLNet_SocketReady(this->_clients[i]->socket)) {
-			long lenTmp = SDLNet_TCP_Recv(this->_clients[i]->socket, this->_msg + offset, MAX_NETWORK_LENGTH - offset) + offset;
-			if (lenTmp > 0) {
-				size_t len = lenTmp;
-				while (curr < len && curr < MAX_NETWORK_LENGTH) {
-					tmp = (Hydra::Network::Packet*)(&this->_msg[curr]);
-					if (curr + tmp->len > len) {
-						memmove(_msg, _msg + curr, len - curr);
-						offset = len - curr;
-						curr = 0;
-					}
-					curr += tmp->len;
-					tmp->client = this->_clients[i]->id;
-					tmp2 = (Hydra::Network::Packet*)(new char[tmp->len]);
-					memcpy(tmp2, tmp, tmp->len);
-					packets.push_back(tmp2);
-				}
-				if (curr == len)
-					offset = 0;
-			} else
-				tmpvec.push_back(this->_clients[i]->id);
+		auto& buffer = this->_clients[i]->buffer;
+		bool dead = false;
+		buffer.release();
+		if (pending && SDLNet_SocketReady(this->_clients[i]->socket)) {
+			size_t size;
+			uint8_t* data = buffer.writePointer(size);
+			// If the buffer is full the data is read the next time, after the packets have been released
+			if (size) {
+				long lenTmp = SDLNet_TCP_Recv(this->_clients[i]->socket, data, size);
+				if (lenTmp > 0)
+					buffer.commitWrite(lenTmp);
+				else
+					dead = true;
+			}
+		}
+
+		while (Hydra::Network::Packet* p = buffer.next()) {
+			p->client = this->_clients[i]->id;
+			packets.push_back(p);
+		}
+		if (buffer.isBroken()) {
+			printf("Client %d sent a packet with an invalid length, disconnecting it\n", this->_clients[i]->id);
+			dead = true;
 		}
+		if (dead)
+			tmpvec.push_back(this->_clients[i]->id);
 	}
 	for (size_t i = 0; i < tmpvec.size(); i++) {
 		this->_disconnectedClients.push_back(tmpvec[i]);
@@ -142,7 +167,7 @@ void ClientHandler::disconnectClient(int id) {
 			SDLNet_TCP_Close(this->_clients[i]->socket);
 			SDLNet_TCP_DelSocket(this->_sets[_clients[i]->socketSet].set, _clients[i]->socket);
 			this->_sets[_clients[i]->socketSet].nrOfClients--;
-			delete this->_clients[i];
+			this->_retiredClients.emplace_back(this->_clients[i]);
 			this->_clients.erase(this->_clients.begin() + i);
 			break;
 		}
@@ -0,0 +1,284 @@
+#include <server/epollclienthandler.hpp>
+#ifdef __linux__
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+using namespace BarcodeServer;
+
+static constexpr uint64_t ListenID = UINT64_MAX;
+
+// EWOULDBLOCK is EAGAIN on Linux, and testing both trips -Wlogical-op
+static inline bool wouldBlock(int error) {
+#if EWOULDBLOCK != EAGAIN
+	if (error == EWOULDBLOCK)
+		return true;
+#endif
+	return error == EAGAIN;
+}
+
+EpollClientHandler::EpollClientHandler() {}
+
+EpollClientHandler::~EpollClientHandler() {
+	for (auto& c : _clients)
+		close(c.second.fd);
+	if (_listen != -1)
+		close(_listen);
+	if (_epoll != -1)
+		close(_epoll);
+}
+
+bool EpollClientHandler::listen(int port, size_t maxConnections) {
+	_maxConnections = maxConnections;
+	_epoll = epoll_create1(EPOLL_CLOEXEC);
+	if (_epoll == -1)
+		return false;
+
+	_listen = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (_listen == -1)
+		return false;
+	int one = 1;
+	setsockopt(_listen, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(_loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+	addr.sin_port = htons(port);
+	if (bind(_listen, (sockaddr*)&addr, sizeof(addr)) == -1 || ::listen(_listen, SOMAXCONN) == -1) {
+		perror("EpollClientHandler::listen");
+		return false;
+	}
+
+	epoll_event ev{};
+	ev.events = EPOLLIN;
+	ev.data.u64 = ListenID;
+	return epoll_ctl(_epoll, EPOLL_CTL_ADD, _listen, &ev) == 0;
+}
+
+int EpollClientHandler::checkForNewClients() {
+	// Only accepts, reading here would parse packets into buffers that receiveData releases before handing them out
+	if (_listen != -1)
+		_accept();
+	if (_newClients.empty())
+		return -1;
+	int id = _newClients.front();
+	_newClients.erase(_newClients.begin());
+	return id;
+}
+
+std::vector<Hydra::Network::Packet*> EpollClientHandler::receiveData() {
+	// The packets from the last call are not used anymore
+	_retiredBuffers.clear();
+	for (auto& c : _clients)
+		c.second.readBuffer.release();
+
+	_poll();
+	std::vector<Hydra::Network::Packet*> packets;
+	packets.swap(_packets);
+	return packets;
+}
+
+int EpollClientHandler::sendData(char* data, int len, int clientID) {
+	auto it = _clients.find(clientID);
+	if (it == _clients.end())
+		return -1;
+	Client& client = it->second;
+
+	int sent = 0;
+	// Only send directly if nothing is queued, otherwise the data would end up out of order
+	if (!client.queuedBytes()) {
+		ssize_t r = send(client.fd, data, len, MSG_NOSIGNAL);
+		if (r == -1 && !wouldBlock(errno) && errno != EINTR) {
+			_drop(clientID);
+			return -1;
+		}
+		sent = r > 0 ? r : 0;
+	}
+
+	if (sent < len) {
+		if (client.queuedBytes() + (len - sent) > MAX_QUEUED_BYTES) {
+			printf("Client %d has more than %zu bytes queued, disconnecting it\n", clientID, MAX_QUEUED_BYTES);
+			_drop(clientID);
+			return -1;
+		}
+		client.writeQueue.insert(client.writeQueue.end(), data + sent, data + len);
+		_setWaitingForWrite(clientID, client, true);
+	}
+	return len;
+}
+
+bool EpollClientHandler::isCongested(int clientID) {
+	auto it = _clients.find(clientID);
+	return it != _clients.end() && it->second.queuedBytes() > CONGESTED_BYTES;
+}
+
+std::vector<int> EpollClientHandler::getAllClients() {
+	std::vector<int> vec;
+	vec.reserve(_clients.size());
+	for (auto& c : _clients)
+		vec.push_back(c.first);
+	return vec;
+}
+
+std::vector<int> EpollClientHandler::getDisconnectedClients() {
+	std::vector<int> result;
+	result.swap(_disconnectedClients);
+	return result;
+}
+
+void EpollClientHandler::disconnectClient(int id) {
+	auto it = _clients.find(id);
+	if (it == _clients.end())
+		return;
+	close(it->second.fd);
+	_retiredBuffers.push_back(std::move(it->second.readBuffer));
+	_clients.erase(it);
+}
+
+int EpollClientHandler::getNrOfClients() {
+	return _clients.size();
+}
+
+void EpollClientHandler::_poll() {
+	if (_epoll == -1)
+		return;
+
+	// Clients with full buffers stay readable, so the number of rounds is limited. Level triggered events that are
+	// returned are moved to the back of the ready list, so every client still gets a turn.
+	epoll_event events[64];
+	int count;
+	size_t rounds = _clients.size() / 64 + 1;
+	do {
+		count = epoll_wait(_epoll, events, 64, 0);
+		for (int i = 0; i < count; i++) {
+			if (events[i].data.u64 == ListenID) {
+				_accept();
+				continue;
+			}
+
+			const int id = (int)events[i].data.u64;
+			auto it = _clients.find(id);
+			if (it == _clients.end())
+				continue; // Dropped earlier in this batch
+
+			bool alive = true;
+			if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				alive = _read(id, it->second);
+			if (alive && (events[i].events & EPOLLOUT)) {
+				alive = _flush(it->second);
+				if (alive && !it->second.queuedBytes())
+					_setWaitingForWrite(id, it->second, false);
+			}
+			if (!alive)
+				_drop(id);
+		}
+	} while (count == 64 && --rounds);
+}
+
+void EpollClientHandler::_accept() {
+	while (true) {
+		int fd = accept4(_listen, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd == -1) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+		if (_clients.size() >= _maxConnections) {
+			printf("Refusing client, already at the limit of %zu connections\n", _maxConnections);
+			close(fd);
+			continue;
+		}
+
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		const int id = _currID++;
+		epoll_event ev{};
+		ev.events = EPOLLIN;
+		ev.data.u64 = (uint64_t)id;
+		if (epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &ev) == -1) {
+			close(fd);
+			continue;
+		}
+		_clients[id].fd = fd;
+		_newClients.push_back(id);
+	}
+}
+
+bool EpollClientHandler::_read(int id, Client& client) {
+	auto& buffer = client.readBuffer;
+	// The socket is level triggered, so if the buffer gets full the rest is read after the next release
+	size_t size;
+	uint8_t* data;
+	// The packets that came before the FIN or the error are still handed out
+	bool open = true;
+	while ((data = buffer.writePointer(size), size)) {
+		ssize_t r = recv(client.fd, data, size, 0);
+		if (r == 0) {
+			open = false;
+			break;
+		}
+		if (r == -1) {
+			if (errno == EINTR)
+				continue;
+			if (!wouldBlock(errno))
+				open = false;
+			break;
+		}
+		buffer.commitWrite(r);
+	}
+
+	while (Hydra::Network::Packet* p = buffer.next()) {
+		p->client = id;
+		_packets.push_back(p);
+	}
+	if (buffer.isBroken()) {
+		printf("Client %d sent a packet with an invalid length, disconnecting it\n", id);
+		return false;
+	}
+	return open;
+}
+
+bool EpollClientHandler::_flush(Client& client) {
+	while (client.queuedBytes()) {
+		ssize_t r = send(client.fd, client.writeQueue.data() + client.writeOffset, client.queuedBytes(), MSG_NOSIGNAL);
+		if (r == -1) {
+			if (errno == EINTR)
+				continue;
+			if (wouldBlock(errno))
+				break;
+			return false;
+		}
+		client.writeOffset += r;
+	}
+
+	if (!client.queuedBytes()) {
+		client.writeQueue.clear();
+		client.writeOffset = 0;
+	} else if (client.writeOffset > client.writeQueue.size() / 2) {
+		client.writeQueue.erase(client.writeQueue.begin(), client.writeQueue.begin() + client.writeOffset);
+		client.writeOffset = 0;
+	}
+	return true;
+}
+
+void EpollClientHandler::_setWaitingForWrite(int id, Client& client, bool wait) {
+	if (client.waitingForWrite == wait)
+		return;
+	client.waitingForWrite = wait;
+	epoll_event ev{};
+	ev.events = wait ? EPOLLIN | EPOLLOUT : EPOLLIN;
+	ev.data.u64 = (uint64_t)id;
+	epoll_ctl(_epoll, EPOLL_CTL_MOD, client.fd, &ev);
+}
+
+void EpollClientHandler::_drop(int id) {
+	_disconnectedClients.push_back(id);
+	disconnectClient(id);
+}
+#endif
@@ -12,63 +12,33 @@
 #include <hydra/component/lifecomponent.hpp>
 #include <hydra/component/rigidbodycomponent.hpp>
 #include <hydra/component/pickupcomponent.hpp>
+#include <hydra/pathing/pvs.hpp>
+#include <hydra/pathing/flowfield.hpp>
 
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <glm/glm.hpp>
 
-#ifdef __linux__
-#include <unistd.h>
-#elif defined(_WIN32)
-#include <windows.h>
-#else
-#error DERP;
-#endif
-
 using namespace BarcodeServer;
 using namespace Hydra::Network;
 
 using world = Hydra::World::World;
 
-enum Tile {
-	Void = 0,
-	Air,
-	RoomContent,
-	Wall,
-	Portal,
-	MAX_COUNT
-};
-static const glm::ivec3 colors[Tile::MAX_COUNT]{
-	{0xFF, 0xFF, 0xFF},
-	{0x3F, 0x3F, 0x3F},
-	{0xFF, 0xFF, 0x00},
-	{0x00, 0x00, 0x00},
-	{0x00, 0xFF, 0xFF}
-};
-
-static void mySleep(int sleepMs) {
-#ifdef __linux__
-	usleep(sleepMs * 1000);   // usleep takes sleep time in us (1 millionth of a second)
-#elif defined(_WIN32)
-	Sleep(sleepMs);
-#else
-#error DERP;
-#endif
+GameServer::GameServer() : _playerIndex(PLAYER_CELL_SIZE), _projectileSystem(_physicsSystem) {
+	for (Hydra::World::ISystem* system : std::initializer_list<Hydra::World::ISystem*>{ &_deadSystem, &_physicsSystem, &_projectileSystem, &_aiSystem, &_bulletSystem, &_spawnerSystem, &_lifeSystem, &_pickupSystem })
+		_jobGraph.add(system);
 }
 
-GameServer::GameServer() {}
-
 GameServer::~GameServer() { quit(); }
 
-bool GameServer::initialize(int port) {
+bool GameServer::initialize(int port, Server::Backend backend, size_t maxConnections) {
 	if (!this->_server) {
 		this->_server = new Server();
 		_lastTime = std::chrono::high_resolution_clock::now();
-		_packetDelay = 0;
-		if (this->_server->initialize(port)) {
+		if (this->_server->initialize(port, backend, maxConnections)) {
 			printf("I am a scurb\n");
-			printf("Server started on port %d.\n", port);
+			printf("Server started on port %d (%s, max %zu clients).\n", port, backend == Server::Backend::epoll ? "epoll" : "SDL_net", maxConnections);
 
 			return true;
 		}
@@ -322,11 +292,13 @@ void GameServer::_makeWorld() {
 		mapID = _tileGeneration->mapentity->id;
 
 	_tileGeneration.reset();
+	// The bullets would hit the walls of the old level
+	_projectileSystem.clear();
 	for (auto c : Hydra::Component::NetworkSyncComponent::componentHandler->getActiveComponents()) {
 		auto e = world::getEntity(c->entityID);
 		if (e->dead)
 			continue;
-		e->dead = true;
+		e->kill();
 		dp.id = c->entityID;
 		_server->sendDataToAll((char*)&dp, dp.len);
 	}
@@ -334,7 +306,7 @@ void GameServer::_makeWorld() {
 		auto e = world::getEntity(c->entityID);
 		if (e->dead)
 			continue;
-		e->dead = true;
+		e->kill();
 		dp.id = c->entityID;
 		_server->sendDataToAll((char*)&dp, dp.len);
 	}
@@ -381,7 +353,10 @@ void GameServer::_makeWorld() {
 	_tileGeneration->spawnPickUps();
 	_tileGeneration->finalize();
 	_pathfindingMap = _tileGeneration->pathfindingMap;
+	_pathMapData = _pathfindingMap->toBytes();
+	FlowField::clearAll();
 	PathFinding::setRoomGrid(_tileGeneration->roomGrid);
+	PathFinding::buildRoomCache(_pathfindingMap);
 	std::vector<std::shared_ptr<Hydra::World::Entity>> allSpawners;
 	world::getEntitiesWithComponents<Hydra::Component::SpawnerComponent>(allSpawners);
 	for (int_openmp_t i = 0; i < (int_openmp_t)allSpawners.size(); i++) {
@@ -396,23 +371,13 @@ void GameServer::_makeWorld() {
 	}
 
 	{
-		std::string map = _tileGeneration->getPathMapAsString();
-		ServerPathMapPacket* spm = (ServerPathMapPacket*)new char[sizeof(ServerPathMapPacket) + WORLD_MAP_SIZE*WORLD_MAP_SIZE];
-		*spm = ServerPathMapPacket(WORLD_MAP_SIZE*WORLD_MAP_SIZE);
-
-		for (int y = 0; y < WORLD_MAP_SIZE; y++)
-			for (int x = 0; x < WORLD_MAP_SIZE; x++)
-				spm->data[y * WORLD_MAP_SIZE + x] = _tileGeneration->pathfindingMap[x][y];
+		ServerPathMapPacket* spm = (ServerPathMapPacket*)new char[sizeof(ServerPathMapPacket) + _pathMapData.size()];
+		*spm = ServerPathMapPacket(_pathMapData.size());
+		memcpy(spm->data, _pathMapData.data(), _pathMapData.size());
 		_server->sendDataToAll((char*)spm, spm->len);
 		delete[](char*)spm;
 	}
 
-	SDL_Surface* map = SDL_CreateRGBSurface(0, WORLD_MAP_SIZE, WORLD_MAP_SIZE, 32, 0, 0, 0, 0);
-	{
-		auto color = colors[Tile::Void];
-		SDL_FillRect(map, nullptr, SDL_MapRGB(map->format, color.x, color.y, color.z));
-	}
-
 	for (size_t x = 0; x < ROOM_GRID_SIZE; x++)
 		printf("|   %zu  ", x);
 	printf("|\n");
@@ -420,75 +385,20 @@ void GameServer::_makeWorld() {
 	for (int y = 0; y < ROOM_GRID_SIZE; y++) {
 		for (int x = 0; x < ROOM_GRID_SIZE; x++) {
 			std::shared_ptr<Hydra::Component::RoomComponent> rc = _tileGeneration->roomGrid[x][y];
-			if (rc) {
+			if (rc)
 				printf("| %c%c%c%c ",
 					rc->door[Hydra::Component::RoomComponent::NORTH] ? 'N' : ' ',
 					rc->door[Hydra::Component::RoomComponent::EAST] ? 'E' : ' ',
 					rc->door[Hydra::Component::RoomComponent::SOUTH] ? 'S' : ' ',
 					rc->door[Hydra::Component::RoomComponent::WEST] ? 'W' : ' '
 				);
-
-				// Walls
-				auto pfm = _pathfindingMap;
-				auto drawWallPixel = [pfm, map](int x, int y) {
-					SDL_Rect rect{ x, y, 1, 1 };
-					auto color = colors[Tile::Wall];
-					if (pfm[x][y] && x > 0 && y > 0 && x < WORLD_MAP_SIZE - 1 && y < WORLD_MAP_SIZE - 1)
-						color = colors[Tile::Portal];
-					SDL_FillRect(map, &rect, SDL_MapRGB(map->format, color.x, color.y, color.z));
-				};
-				auto drawRoomPixel = [pfm, map](int x, int y) {
-					SDL_Rect rect{ x, y, 1, 1 };
-					auto color = colors[Tile::Air];
-					if (pfm[x][y] && x > 0 && y > 0 && x < WORLD_MAP_SIZE - 1 && y < WORLD_MAP_SIZE - 1)
-						color = colors[Tile::RoomContent];
-					SDL_FillRect(map, &rect, SDL_MapRGB(map->format, color.x, color.y, color.z));
-				};
-
-				for (int i = 0; i < ROOM_MAP_SIZE; i++)
-					drawWallPixel(x * ROOM_MAP_SIZE + i, y * ROOM_MAP_SIZE);
-
-				for (int i = 0; i < ROOM_MAP_SIZE; i++)
-					drawWallPixel(x * ROOM_MAP_SIZE + i, (y + 1) * ROOM_MAP_SIZE - 1);
-
-				for (int i = 0; i < ROOM_MAP_SIZE; i++)
-					drawWallPixel(x * ROOM_MAP_SIZE, y * ROOM_MAP_SIZE + i);
-
-				for (int i = 0; i < ROOM_MAP_SIZE; i++)
-					drawWallPixel((x + 1) * ROOM_MAP_SIZE - 1, y * ROOM_MAP_SIZE + i);
-
-				// Center of room
-				SDL_Rect rect = { x * ROOM_MAP_SIZE + 1, y * ROOM_MAP_SIZE + 1, ROOM_MAP_SIZE - 2, ROOM_MAP_SIZE - 2 };
-				auto color = colors[Tile::Air];
-				SDL_FillRect(map, &rect, SDL_MapRGB(map->format, color.x, color.y, color.z));
-
-				for (int i = 1; i < ROOM_MAP_SIZE - 1; i++)
-					for (int j = 1; j < ROOM_MAP_SIZE - 1; j++)
-						drawRoomPixel(x * ROOM_MAP_SIZE + i, y * ROOM_MAP_SIZE + j);
-			}
-			else {
+			else
 				printf("|      ");
-			}
 		}
 		printf("|\n");
 	}
 
-	SDL_SaveBMP(map, "map.bmp");
-	SDL_FreeSurface(map);
-#ifdef _WIN32
-	system("PVSTest.exe -f map.bmp -s 32 -o map.pvs");
-#else
-	system("bin/PVSTest -f map.bmp -s 32 -o map.pvs");
-#endif
-
-	{
-		FILE* fp = fopen("map.pvs", "rb");
-		fseek(fp, 0, SEEK_END);
-		_pvsData.resize(ftell(fp));
-		fseek(fp, 0, SEEK_SET);
-		fread(_pvsData.data(), _pvsData.size(), 1, fp);
-		fclose(fp);
-}
+	_pvsData = PVS::compute(_tileGeneration->roomGrid, _pathfindingMap).toBytes();
 
 	{
 		std::vector<std::shared_ptr<Entity>> entities;
@@ -532,12 +442,17 @@ void GameServer::_makeWorld() {
 		freeze.action = ServerFreezePlayerPacket::Action::unfreeze;
 		_server->sendDataToAll((char*)&freeze, freeze.len);
 	}
+
+	// Don't try to catch up on the time it took to generate the world
+	_lastTime = std::chrono::high_resolution_clock::now();
 }
 
 void GameServer::run() {
-	//Check for new Clients
+	// Network packets are handled every call, but the world is only simulated in steps of exactly 1 / _tickRate seconds
 	auto nowTime = std::chrono::high_resolution_clock::now();
-	float delta = std::chrono::duration<float, std::chrono::milliseconds::period>(nowTime - _lastTime).count() / 1000.f;
+	const float elapsed = std::chrono::duration<float>(nowTime - _lastTime).count();
+	_accumulator += elapsed;
+	_tickStats.time += elapsed;
 	_lastTime = nowTime;
 	{
 		this->_handleDisconnects();
@@ -549,177 +464,195 @@ void GameServer::run() {
 		this->_resolvePackets(this->_server->receiveData());
 	}
 
-	//Update World
-	{
-		static std::vector<std::shared_ptr<Entity>> ents;
-		world::getEntitiesWithComponents<Hydra::Component::AIComponent>(ents);
-		for (size_t k = 0; k < ents.size(); k++) {
-			TransformComponent* ptc = ents[k]->getComponent<TransformComponent>().get();
-			float distance = FLT_MAX;
-			int target = -1;
-			for (size_t i = 0; i < this->_players.size(); i++) {
-				TransformComponent* tc = world::getEntity(this->_players[i]->entityid)->getComponent<TransformComponent>().get();
-				float f = glm::distance(ptc->position, tc->position);
-				if (f < distance) {
-					target = i;
-					distance = f;
-				}
-			}
-			auto ai = ents[k]->getComponent<AIComponent>().get();
-			if (target != -1) {
-				ai->behaviour->setTargetPlayer(world::getEntity(this->_players[target]->entityid));
-			}
-		}
-		ents.clear();
-
-		static std::vector<std::shared_ptr<Entity>> spawnEnts;
-		world::getEntitiesWithComponents<Hydra::Component::SpawnerComponent>(spawnEnts);
-		for (size_t k = 0; k < spawnEnts.size(); k++) {
-			TransformComponent* ptc = spawnEnts[k]->getComponent<TransformComponent>().get();
-			float distance = FLT_MAX;
-			int target = -1;
-			for (size_t i = 0; i < this->_players.size(); i++) {
-				TransformComponent* tc = world::getEntity(this->_players[i]->entityid)->getComponent<TransformComponent>().get();
-				float f = glm::distance(ptc->position, tc->position);
-				if (f < distance) {
-					target = i;
-					distance = f;
-				}
-			}
-			auto spawn = spawnEnts[k]->getComponent<Hydra::Component::SpawnerComponent>().get();
-			if (target != -1) {
-				spawn->setTargetPlayer(world::getEntity(this->_players[target]->entityid));
-			}
-		}
-		spawnEnts.clear();
-
-		_deadSystem.tick(delta);
-		_physicsSystem.tick(delta);
-		_aiSystem.tick(delta);
-		_bulletSystem.tick(delta);
-		////_abilitySystem.tick(delta);
-		_spawnerSystem.tick(delta);
-		{
-			for (size_t i = 0; i < _spawnerSystem.didJustSpawn.size(); i++) {
-				auto e = _spawnerSystem.didJustSpawn[i];
-				_networkEntities.push_back(e->id);
-				auto p = createServerSpawnEntity(e);
-				_server->sendDataToAll((char*)p, p->len);
-				delete[](char*)p;
-			}
-		}
+	const float tickDelta = 1.0f / _tickRate;
+	if (_accumulator > tickDelta * MAX_CATCH_UP_TICKS) {
+		// Too far behind to catch up, skip the time instead of making it even worse
+		_tickStats.droppedTicks += (size_t)(_accumulator / tickDelta) - MAX_CATCH_UP_TICKS;
+		_accumulator = tickDelta * MAX_CATCH_UP_TICKS;
+	}
 
-		//_perkSystem.tick(delta);
-		_lifeSystem.tick(delta);
-		_pickupSystem.tick(delta);
-
-		//�NNU MER FUSK KOD JAAAAAA
-		//std::vector<std::shared_ptr<Entity>> children;
-		//world::getEntitiesWithComponents<PickUpComponent>(children);
-		//for (size_t i = 0; i < children.size(); i++) {
-		//	auto putc = children[i]->getComponent<TransformComponent>();
-		//	for (size_t j = 0; j < _players.size(); j++) {
-		//		auto ptc = world::getEntity(_players[j]->entityid)->getComponent<TransformComponent>();
-		//		if (glm::distance(putc->position, ptc->position) < 10.f) {
-		//			ServerDeleteEntityPacket p{};
-		//			p.id = children[i]->id;
-		//			_server->sendDataToAllExcept((char*)&p, p.len, _players[j]->serverid);
-		//
-		//			_networkEntities.erase(std::remove_if(_networkEntities.begin(), _networkEntities.end(), [p](const auto& e) { return e == p.id; }), _networkEntities.end());
-		//			children[i]->dead = true;
-		//			continue;
-		//		}
-		//	}
-		//}
+	bool ticked = false;
+	while (_accumulator >= tickDelta) {
+		auto tickStart = std::chrono::high_resolution_clock::now();
+		_tick(tickDelta);
+		_accumulator -= tickDelta;
+		ticked = true;
+
+		_tickTime = std::chrono::duration<float, std::chrono::milliseconds::period>(std::chrono::high_resolution_clock::now() - tickStart).count();
+		_tickStats.total += _tickTime;
+		_tickStats.max = std::max(_tickStats.max, _tickTime);
+		_tickStats.ticks++;
+	}
 
-		//END
+	//Send updated world to clients
+	if (ticked) {
+		this->_sendWorld();
+		_sendPathInfo();
+	}
 
-		for (Hydra::World::EntityID eID : _lifeSystem.isKilled()) {
-			if (auto e = world::getEntity(eID)) {
-				if (auto ai = e->getComponent<Hydra::Component::AIComponent>(); ai) {
-					auto oldTransform = e->getComponent<Hydra::Component::TransformComponent>();
-					auto oldMesh = e->getComponent<Hydra::Component::MeshComponent>();
-					if (!oldTransform || !oldMesh)
-						continue;
+	if (_tickStats.time >= STATS_INTERVAL)
+		_logTickStats();
 
-					char name[64] = { 0 };
-					snprintf(name, sizeof(name), "Dead body [%zu]", eID);
-					auto deadBody = world::newEntity(name, e->parent);
-					auto t = deadBody->addComponent<Hydra::Component::TransformComponent>();
-					t->position = oldTransform->position;
-					t->scale = oldTransform->scale;
-					t->rotation = oldTransform->rotation;
-					t->dirty = true;
-					auto mesh = deadBody->addComponent<Hydra::Component::MeshComponent>();
-					mesh->loadMesh(oldMesh->meshFile);
-					auto life = deadBody->addComponent<Hydra::Component::LifeComponent>();
-					life->health = life->maxHP = 25.0f / 24.0f;
-					life->tickDownWithTime = true;
-
-					switch (ai->behaviour->type) {
-					case Behaviour::Type::ALIEN:
-						mesh->currentFrame = 1;
-						mesh->animationIndex = 3;
-						break;
+	std::this_thread::sleep_until(nowTime + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<float>(tickDelta - _accumulator)));
+}
 
-					case Behaviour::Type::ROBOT:
-						mesh->currentFrame = 1;
-						mesh->animationIndex = 3;
-						break;
+void GameServer::setTickRate(int tickRate) {
+	_tickRate = std::max(1, tickRate);
+}
 
-					case Behaviour::Type::BOSS_HAND:
-					case Behaviour::Type::BOSS_ARMS:
-					case Behaviour::Type::STATINARY_BOSS:
-						// TODO:
-						break;
-					}
+void GameServer::_tick(float delta) {
+	// There are only a few players, so the index is filled again every tick instead of following joins and leaves.
+	// Every alien and spawner below looks up its closest player in it, instead of every player in the world.
+	_playerIndex.clear();
+	for (Player* player : _players)
+		_playerIndex.set(player->entityid, world::getEntity(player->entityid)->getComponent<TransformComponent>()->position);
+
+	for (auto& entity : _aiQuery.getEntities()) {
+		TransformComponent* ptc = entity->getComponent<TransformComponent>().get();
+		const EntityID target = _playerIndex.nearest(ptc->position);
+		auto ai = entity->getComponent<AIComponent>().get();
+		if (target != world::invalidID) {
+			ai->behaviour->setTargetPlayer(world::getEntity(target));
+		}
+	}
 
-					printf("Syncing (%zu): %s\n", deadBody->id, deadBody->name.c_str());
-					auto p = createServerSpawnEntity(deadBody.get());
-					_server->sendDataToAll((char*)p, p->len);
-					delete[](char*)p;
-					deadBody->dead = true;
-				}
+	for (auto& entity : _spawnerQuery.getEntities()) {
+		TransformComponent* ptc = entity->getComponent<TransformComponent>().get();
+		const EntityID target = _playerIndex.nearest(ptc->position);
+		auto spawn = entity->getComponent<Hydra::Component::SpawnerComponent>().get();
+		if (target != world::invalidID) {
+			spawn->setTargetPlayer(world::getEntity(target));
+		}
+	}
+
+	_jobGraph.run(delta);
+	{
+		const auto& timings = _jobGraph.getTimings();
+		_tickStats.systems.resize(timings.size());
+		for (size_t i = 0; i < timings.size(); i++)
+			_tickStats.systems[i] += timings[i].time;
+		float criticalPath;
+		_jobGraph.getCriticalPath(&criticalPath);
+		_tickStats.criticalPath += criticalPath;
+	}
+
+	for (size_t i = 0; i < _spawnerSystem.didJustSpawn.size(); i++) {
+		auto e = _spawnerSystem.didJustSpawn[i];
+		_networkEntities.push_back(e->id);
+		auto p = createServerSpawnEntity(e);
+		_server->sendDataToAll((char*)p, p->len);
+		delete[](char*)p;
+	}
 
-				deleteEntity(eID);
+	//�NNU MER FUSK KOD JAAAAAA
+	//std::vector<std::shared_ptr<Entity>> children;
+	//world::getEntitiesWithComponents<PickUpComponent>(children);
+	//for (size_t i = 0; i < children.size(); i++) {
+	//	auto putc = children[i]->getComponent<TransformComponent>();
+	//	for (size_t j = 0; j < _players.size(); j++) {
+	//		auto ptc = world::getEntity(_players[j]->entityid)->getComponent<TransformComponent>();
+	//		if (glm::distance(putc->position, ptc->position) < 10.f) {
+	//			ServerDeleteEntityPacket p{};
+	//			p.id = children[i]->id;
+	//			_server->sendDataToAllExcept((char*)&p, p.len, _players[j]->serverid);
+	//
+	//			_networkEntities.erase(std::remove_if(_networkEntities.begin(), _networkEntities.end(), [p](const auto& e) { return e == p.id; }), _networkEntities.end());
+	//			children[i]->dead = true;
+	//			continue;
+	//		}
+	//	}
+	//}
+
+	//END
+
+	for (Hydra::World::EntityID eID : _lifeSystem.isKilled()) {
+		if (auto e = world::getEntity(eID)) {
+			if (auto ai = e->getComponent<Hydra::Component::AIComponent>(); ai) {
+				auto oldTransform = e->getComponent<Hydra::Component::TransformComponent>();
+				auto oldMesh = e->getComponent<Hydra::Component::MeshComponent>();
+				if (!oldTransform || !oldMesh)
+					continue;
+
+				char name[64] = { 0 };
+				snprintf(name, sizeof(name), "Dead body [%zu]", eID);
+				auto deadBody = world::newEntity(name, e->parent);
+				auto t = deadBody->addComponent<Hydra::Component::TransformComponent>();
+				t->position = oldTransform->position;
+				t->scale = oldTransform->scale;
+				t->rotation = oldTransform->rotation;
+				t->dirty = true;
+				auto mesh = deadBody->addComponent<Hydra::Component::MeshComponent>();
+				mesh->loadMesh(oldMesh->meshFile);
+				auto life = deadBody->addComponent<Hydra::Component::LifeComponent>();
+				life->health = life->maxHP = 25.0f / 24.0f;
+				life->tickDownWithTime = true;
+
+				switch (ai->behaviour->type) {
+				case Behaviour::Type::ALIEN:
+					mesh->currentFrame = 1;
+					mesh->animationIndex = 3;
+					break;
+
+				case Behaviour::Type::ROBOT:
+					mesh->currentFrame = 1;
+					mesh->animationIndex = 3;
+					break;
+
+				case Behaviour::Type::BOSS_HAND:
+				case Behaviour::Type::BOSS_ARMS:
+				case Behaviour::Type::STATINARY_BOSS:
+					// TODO:
+					break;
+				}
 
-				_players.erase(std::remove_if(_players.begin(), _players.end(), [eID](const auto& p) { return p->entityid == eID; }), _players.end());
+				printf("Syncing (%zu): %s\n", deadBody->id, deadBody->name.c_str());
+				auto p = createServerSpawnEntity(deadBody.get());
+				_server->sendDataToAll((char*)p, p->len);
+				delete[](char*)p;
+				deadBody->kill();
 			}
+
+			deleteEntity(eID);
+
+			_players.erase(std::remove_if(_players.begin(), _players.end(), [eID](const auto& p) { return p->entityid == eID; }), _players.end());
 		}
-		if (!Hydra::Component::AIComponent::componentHandler->getActiveComponents().size() || (level == 2 && !world::getEntity(_bossID))) {
-			level++;
-			if (level > 2) {
-				ServerFreezePlayerPacket freeze{};
-				freeze.action = ServerFreezePlayerPacket::Action::win;
-				_server->sendDataToAll((char*)&freeze, freeze.len);
-
-				level = 0;
-				_makeWorld();
-
-				printf("\n\n\n\n");
-				printf("================SERVER INFO================\n");
-				printf("The boss has been defeated, resetting server\n");
-				printf("===========================================\n");
-			} else
-				_makeWorld();
-		}
+	}
+	if (!Hydra::Component::AIComponent::componentHandler->getActiveComponents().size() || (level == 2 && !world::getEntity(_bossID))) {
+		level++;
+		if (level > 2) {
+			ServerFreezePlayerPacket freeze{};
+			freeze.action = ServerFreezePlayerPacket::Action::win;
+			_server->sendDataToAll((char*)&freeze, freeze.len);
+
+			level = 0;
+			_makeWorld();
+
+			printf("\n\n\n\n");
+			printf("================SERVER INFO================\n");
+			printf("The boss has been defeated, resetting server\n");
+			printf("===========================================\n");
+		} else
+			_makeWorld();
 	}
 
 	for (Player* p : _players) {
 #undef max
 		p->shootAnimation = std::max(0.0f, p->shootAnimation - delta);
 	}
+}
 
-	//Send updated world to clients
-	{
-		_packetDelay += delta;
-		/*if (_packetDelay >= 1.0f/30.0f)*/ {
-			this->_sendWorld();
-			_packetDelay = 0;
-		}
-		mySleep(1000 / 30);
-	}
-	_sendPathInfo();
+void GameServer::_logTickStats() {
+	const float budget = 1000.0f / _tickRate;
+	const float ticks = std::max<size_t>(_tickStats.ticks, 1);
+	printf("Tick stats: %zu ticks in %.1f s at %d Hz, avg %.2f ms max %.2f ms (budget %.2f ms), %zu dropped, %d players |", _tickStats.ticks, _tickStats.time, _tickRate,
+		_tickStats.total / ticks, _tickStats.max, budget, _tickStats.droppedTicks, (int)_players.size());
+	const auto& timings = _jobGraph.getTimings();
+	for (size_t i = 0; i < _tickStats.systems.size() && i < timings.size(); i++)
+		printf(" %s %.2f", timings[i].system->type().c_str(), _tickStats.systems[i] / ticks);
+	printf(" | critical path %.2f ms on %zu threads\n", _tickStats.criticalPath / ticks, _jobGraph.getThreadCount());
+	if (_tickStats.max > budget || _tickStats.droppedTicks)
+		printf("Warning: The server is overloaded, ticks take longer than %.2f ms\n", budget);
+	_tickStats = TickStats();
 }
 
 void GameServer::quit() {
@@ -740,39 +673,36 @@ void GameServer::syncEntity(Hydra::World::Entity* entity) {
 }
 
 void GameServer::_sendWorld() {
-	ServerUpdatePacket* packet = (ServerUpdatePacket*)new char[(sizeof(ServerUpdatePacket) + (sizeof(ServerUpdatePacket::EntUpdate) * this->_networkEntities.size()))];
-	*packet = ServerUpdatePacket(_networkEntities.size());
-	for (size_t i = 0; i < this->_networkEntities.size(); i++) {
-		ServerUpdatePacket::EntUpdate& entupdate = packet->data[i];
-		Entity* entity = world::getEntity(this->_networkEntities[i]).get();
-		if (entity) {
-			this->_convertEntityToTransform(packet->data[i], this->_networkEntities[i]);
-
-			auto life = entity->getComponent<LifeComponent>();
-			if (life)
-				entupdate.life = life->health;
-			else
-				entupdate.life = INT32_MAX;
-
-			auto mesh = entity->getComponent<MeshComponent>();
-			if (mesh)
-				entupdate.animationIndex = mesh->animationIndex;
-			else
-				entupdate.animationIndex = 0;
-		} else
-			this->_networkEntities.erase(_networkEntities.begin() + i);
+	_networkEntities.erase(std::remove_if(_networkEntities.begin(), _networkEntities.end(), [](const auto& e) { return !world::getEntity(e); }), _networkEntities.end());
+
+	Snapshot& snapshot = _snapshots.push(++_snapshotSequence);
+	for (EntityID id : _networkEntities) {
+		Entity* entity = world::getEntity(id).get();
+		auto life = entity->getComponent<LifeComponent>();
+		auto mesh = entity->getComponent<MeshComponent>();
+		snapshot.entities.emplace_back(id, _convertEntityToTransform(id), life ? (int32_t)life->health : INT32_MAX, mesh ? mesh->animationIndex : 0);
 	}
+	std::sort(snapshot.entities.begin(), snapshot.entities.end(), [](const EntitySnapshot& a, const EntitySnapshot& b) { return a.entityid < b.entityid; });
+
+	// Every player gets a delta against the last snapshot it has received
+	_snapshotPackets.clear();
+	for (Player* player : _players) {
+		// The snapshot is skipped for clients that are behind, the next one will be a delta against an older baseline
+		if (_server->isCongested(player->serverid))
+			continue;
 
-	this->_server->sendDataToAll((char*)packet, packet->len);
-	delete[] packet;
+		auto& buffer = _snapshotPackets.get(_snapshots, _snapshotSequence, player->lastSnapshot);
+		_server->sendDataToClient((char*)buffer.data(), buffer.size(), player->serverid);
+	}
 }
 
-void GameServer::_convertEntityToTransform(ServerUpdatePacket::EntUpdate& dest, EntityID ent) {
+TransformInfo GameServer::_convertEntityToTransform(EntityID ent) {
 	Hydra::Component::TransformComponent* tc = World::getEntity(ent)->getComponent<Hydra::Component::TransformComponent>().get();
-	dest.entityid = ent;
-	dest.ti.pos = tc->position;
-	dest.ti.scale = tc->scale;
-	dest.ti.rot = tc->rotation;
+	TransformInfo ti;
+	ti.pos = tc->position;
+	ti.scale = tc->scale;
+	ti.rot = tc->rotation;
+	return ti;
 }
 
 void GameServer::_resolvePackets(std::vector<Hydra::Network::Packet*> packets) {
@@ -800,19 +730,23 @@ void GameServer::_resolvePackets(std::vector<Hydra::Network::Packet*> packets) {
 			break;
 
 		case PacketType::ClientShoot:
-			resolveClientShootPacket((ClientShootPacket*)p, player, &_physicsSystem); //SUPER INEFFICIENT
+			resolveClientShootPacket((ClientShootPacket*)p, player, _projectileSystem);
 			createAndSendPlayerShootPacket(player, (ClientShootPacket*)p, this->_server);
 			break;
 		case PacketType::ClientRequestAIInfo:
 			_resolveClientRequestAIInfoPacket((ClientRequestAIInfoPacket*)p);
 			break;
+		case PacketType::ClientPing: {
+			ServerPongPacket pong{};
+			pong.time = ((ClientPingPacket*)p)->time;
+			pong.tickTime = _tickTime;
+			_server->sendDataToClient((char*)&pong, pong.len, player->serverid);
+			break;
+		}
 		default:
 			break;
 		}
 	}
-
-	for (size_t i = 0; i < packets.size(); i++)
-		delete packets[i];
 }
 
 int64_t GameServer::_getEntityID(int serverid) {
@@ -841,7 +775,7 @@ void GameServer::deleteEntity(EntityID ent) {
 	_networkEntities.erase(std::remove_if(_networkEntities.begin(), _networkEntities.end(), [ent](const auto& e) { return e == ent; }), _networkEntities.end());
 
 	if (auto e = world::getEntity(ent); e)
-		e->dead = true;
+		e->kill();
 }
 
 void GameServer::_handleDisconnects() {
@@ -988,13 +922,9 @@ bool GameServer::_addPlayer(int id) {
 		}
 
 		{
-			std::string map = _tileGeneration->getPathMapAsString();
-			ServerPathMapPacket* spm = (ServerPathMapPacket*)new char[sizeof(ServerPathMapPacket) + WORLD_MAP_SIZE*WORLD_MAP_SIZE];
-			*spm = ServerPathMapPacket(WORLD_MAP_SIZE*WORLD_MAP_SIZE);
-
-			for (int y = 0; y < WORLD_MAP_SIZE; y++)
-				for (int x = 0; x < WORLD_MAP_SIZE; x++)
-					spm->data[y * WORLD_MAP_SIZE + x] = _tileGeneration->pathfindingMap[x][y];
+			ServerPathMapPacket* spm = (ServerPathMapPacket*)new char[sizeof(ServerPathMapPacket) + _pathMapData.size()];
+			*spm = ServerPathMapPacket(_pathMapData.size());
+			memcpy(spm->data, _pathMapData.data(), _pathMapData.size());
 			_server->sendDataToClient((char*)spm, spm->len, id);
 			delete[](char*)spm;
 		}
@@ -1037,6 +967,10 @@ void BarcodeServer::GameServer::_sendPathInfo()
 			{
 				if (a->behaviour->doDiddeliDoneDatPathfinding)
 				{
+					//The enemies follow a flow field instead of searching, so the path is traced from it
+					auto t = e->getComponent<Hydra::Component::TransformComponent>();
+					if (a->behaviour->flowField && t)
+						a->behaviour->flowField->trace(t->position, a->behaviour->pathFinding->pathToEnd);
 					size_t open = a->behaviour->pathFinding->openList.size();
 					size_t closed = a->behaviour->pathFinding->visitedList.size();
 					size_t pathToEnd = a->behaviour->pathFinding->pathToEnd.size();
@@ -1055,16 +989,16 @@ void BarcodeServer::GameServer::_sendPathInfo()
 					int i = 0;
 					for (size_t o = 0; o < a->behaviour->pathFinding->openList.size(); o++)
 					{
-						packet->data[i] = a->behaviour->pathFinding->openList[o]->pos.x();
+						packet->data[i] = a->behaviour->pathFinding->openList[o].x();
 						i++;
-						packet->data[i] = a->behaviour->pathFinding->openList[o]->pos.z();
+						packet->data[i] = a->behaviour->pathFinding->openList[o].z();
 						i++;
 					}
 					for (size_t c = 0; c < a->behaviour->pathFinding->visitedList.size(); c++)
 					{
-						packet->data[i] = a->behaviour->pathFinding->visitedList[c]->pos.x();
+						packet->data[i] = a->behaviour->pathFinding->visitedList[c].x();
 						i++;
-						packet->data[i] = a->behaviour->pathFinding->visitedList[c]->pos.z();
+						packet->data[i] = a->behaviour->pathFinding->visitedList[c].z();
 						i++;
 					}
 					for (size_t p = 0; p < a->behaviour->pathFinding->pathToEnd.size(); p++)
@@ -1085,16 +1019,16 @@ void BarcodeServer::GameServer::_sendPathInfo()
 	}
 }
 
-void GameServer::_onRobotShoot(WeaponComponent& weapon, Entity* bullet, void* userdata) {
+void GameServer::_onRobotShoot(WeaponComponent& weapon, const Hydra::System::Projectile& bullet, void* userdata) {
 	GameServer* this_ = static_cast<GameServer*>(userdata);
 
 	{
 		nlohmann::json json;
-		bullet->serialize(json);
+		bullet.serialize(json);
 		std::vector<uint8_t> vec = nlohmann::json::to_msgpack(json);
 		ServerUpdateBulletPacket* packet = (ServerUpdateBulletPacket*)new char[sizeof(ServerUpdateBulletPacket) + vec.size()];
 		*packet = ServerUpdateBulletPacket(vec.size());
-		packet->serverPlayerID = bullet->id; //TODO: FIX!
+		packet->serverPlayerID = weapon.entityID;
 		memcpy(packet->data, vec.data(), vec.size());
 		this_->_server->sendDataToAll((char*)packet, packet->len);
 		delete[] packet;
@@ -1102,14 +1036,11 @@ void GameServer::_onRobotShoot(WeaponComponent& weapon, Entity* bullet, void* us
 
 	{
 		ServerShootPacket* packet = new ServerShootPacket();
-		auto tc = bullet->getComponent<Hydra::Component::TransformComponent>().get();
-		auto direction = bullet->getComponent<Hydra::Component::BulletComponent>()->direction;
-
-		packet->direction = direction;
-		packet->ti.pos = tc->position;
-		packet->ti.scale = tc->scale;
-		packet->ti.rot = tc->rotation;
-		packet->serverPlayerID = bullet->id;
+		packet->direction = bullet.direction;
+		packet->ti.pos = bullet.position;
+		packet->ti.scale = glm::vec3(bullet.size);
+		packet->ti.rot = bullet.rotation;
+		packet->serverPlayerID = weapon.entityID;
 
 		this_->_server->sendDataToAll((char*)packet, sizeof(ServerShootPacket));
 		delete packet;
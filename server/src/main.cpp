@@ -14,6 +14,7 @@
 #include <server/packets.hpp>
 
 #include <cstdio>
+#include <cstring>
 #include <chrono>
 
 #ifdef _WIN32
@@ -33,10 +34,7 @@ static inline void setup() {
 #endif
 
 static void onQuit() {
-	// Mirror Hydra::World::World::reset, but without creating a new world root
-	Hydra::World::World::_isResetting = true;
-	Hydra::World::World::_entities.clear();
-	Hydra::World::World::_map.clear();
+	Hydra::World::World::clear();
 }
 
 using namespace Hydra;
@@ -49,8 +47,10 @@ namespace GServer {
 		public:
 			void(*point)(EntityID);
 			void* psystem = nullptr;
+			void* projectiles = nullptr;
 			void runFrame(float delta) {} void load() {} void onMainMenu() {} IO::ITextureLoader* getTextureLoader() { return (IO::ITextureLoader*)this->point; } IO::IMeshLoader* getMeshLoader() { return nullptr; } IO::ITextFactory* getTextFactory() { return nullptr; }
 			Hydra::World::ISystem* getPhysicsSystem() { return (ISystem*)psystem; }
+			Hydra::World::ISystem* getProjectileSystem() { return (ISystem*)projectiles; }
 		} _state;
 
 		Engine() {
@@ -59,10 +59,7 @@ namespace GServer {
 		}
 
 		~Engine() final {
-			// Mirror Hydra::World::World::reset, but without creating a new world root
-			Hydra::World::World::_isResetting = true;
-			Hydra::World::World::_entities.clear();
-			Hydra::World::World::_map.clear();
+			Hydra::World::World::clear();
 		}
 
 		void run() final {}
@@ -104,8 +101,22 @@ void onPickUp(EntityID id) {
 
 int main(int argc, char** argv) {
 	srand(time(NULL));
-	(void)argc;
-	(void)argv;
+	BarcodeServer::Server::Backend backend = BarcodeServer::Server::Backend::sdlnet;
+	size_t maxConnections = 64;
+	int tickRate = 30;
+	size_t physicsThreads = 0;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--epoll"))
+			backend = BarcodeServer::Server::Backend::epoll;
+		else if (!strcmp(argv[i], "--max-clients") && i + 1 < argc)
+			maxConnections = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--tick-rate") && i + 1 < argc)
+			tickRate = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--physics-threads"))
+			physicsThreads = (i + 1 < argc && argv[i + 1][0] != '-') ? strtoul(argv[++i], nullptr, 10) : SIZE_MAX;
+		else
+			printf("Usage: %s [--epoll] [--max-clients N] [--tick-rate HZ] [--physics-threads [N]]\n", argv[0]);
+	}
 	setup();
 	SDLNet_Init();
 	using namespace Hydra::Component::ComponentManager;
@@ -117,8 +128,11 @@ int main(int argc, char** argv) {
 	registerComponents_physics(map);
 	//registerComponents_sound(map);
 	((GServer::Engine::Bogdan*)engine.getState())->psystem = (void*)(&server._physicsSystem);
+	((GServer::Engine::Bogdan*)engine.getState())->projectiles = (void*)(&server.getProjectileSystem());
 	engine._state.point = &onPickUp;
-	if (server.initialize(4545)) {
+	server.setTickRate(tickRate);
+	server._physicsSystem.setThreadCount(physicsThreads);
+	if (server.initialize(4545, backend, maxConnections)) {
 		Hydra::World::World::reset();
 		server.start();
 		while (true) {
@@ -4,6 +4,7 @@
 #include <hydra/component/rigidbodycomponent.hpp>
 #include <hydra/component/meshcomponent.hpp>
 #include <hydra/system/bulletphysicssystem.hpp>
+#include <hydra/system/projectilesystem.hpp>
 #include <server/server.hpp>
 #include <server/gameserver.hpp>
 
@@ -27,6 +28,8 @@ ServerPlayerPacket* BarcodeServer::createServerPlayerPacket(const std::string& n
 }
 
 void BarcodeServer::resolveClientUpdatePacket(Player* p, ClientUpdatePacket* cup, Hydra::World::EntityID entityID) {
+	p->lastSnapshot = std::max(p->lastSnapshot, cup->lastSnapshot);
+
 	std::vector<Hydra::World::EntityID> children = World::root()->children;
 	if (cup->client == 1) {
 		int j = 0;
@@ -126,27 +129,18 @@ void BarcodeServer::resolveClientUpdateBulletPacket(ClientUpdateBulletPacket * c
 	printf("Successfully updated bullet.\n");
 }
 
-Hydra::World::Entity* BarcodeServer::resolveClientShootPacket(ClientShootPacket * csp, Player * p, Hydra::World::ISystem* physics) {
-	Hydra::System::BulletPhysicsSystem* bps = static_cast<Hydra::System::BulletPhysicsSystem*>(physics);
-	std::shared_ptr<Hydra::World::Entity> ptr = world::newEntity("BULLET", world::root());
-	ptr->deserialize(p->bullet);
-	auto otherptr = ptr->getComponent<Hydra::Component::BulletComponent>();
-	otherptr->direction = csp->direction;
-	auto transform = ptr->getComponent<Hydra::Component::TransformComponent>();
-	transform->setPosition(csp->ti.pos);
-	transform->setScale(csp->ti.scale);
-	transform->setRotation(csp->ti.rot);
-	auto r = ptr->getComponent<Hydra::Component::RigidBodyComponent>();
-	if (r) {
-		r->setLinearVelocity(otherptr->direction * otherptr->velocity);
-		bps->enable(r.get());
-		r->setGravity(glm::vec3(0, 0, 0));
-	}
+void BarcodeServer::resolveClientShootPacket(ClientShootPacket * csp, Player * p, Hydra::System::ProjectileSystem& projectiles) {
+	Hydra::System::Projectile bullet;
+	bullet.deserialize(p->bullet);
+	bullet.position = csp->ti.pos;
+	bullet.size = csp->ti.scale.x;
+	bullet.rotation = csp->ti.rot;
+	bullet.direction = csp->direction;
+	projectiles.fire(bullet);
 
 	if (auto player = world::getEntity(p->entityid); player)
 		if (auto mesh = player->getComponent<Hydra::Component::MeshComponent>(); mesh) {
 			mesh->animationIndex = 2;
 			p->shootAnimation = 0.25;
 		}
-	return ptr.get();
 }
@@ -1,4 +1,5 @@
 #include <server/server.hpp>
+#include <server/epollclienthandler.hpp>
 
 using namespace BarcodeServer;
 
@@ -6,67 +7,59 @@ Server::Server() {
 	this->_running = false;
 }
 
-Server::~Server() {
-	SDLNet_TCP_Close(this->_sock);
-}
+Server::~Server() {}
 
-bool Server::initialize(int port) {
-	this->_clientHandler.initialize(new char[MAX_NETWORK_LENGTH]);
+bool Server::initialize(int port, Backend backend, size_t maxConnections) {
 	this->_port = port;
 
-	IPaddress ip;
-	if (SDLNet_ResolveHost(&ip, NULL, this->_port) == -1) {
-		return this->_running;
-	}
-
-	this->_sock = SDLNet_TCP_Open(&ip);
-	if (!this->_sock) {
-		const char* c = SDLNet_GetError();
-		return this->_running;
-	}
-	this->_running = true;
+#ifdef __linux__
+	if (backend == Backend::epoll)
+		this->_clientHandler = std::make_unique<EpollClientHandler>();
+#else
+	if (backend == Backend::epoll)
+		printf("The epoll backend is only available on Linux, using SDL_net\n");
+#endif
+	if (!this->_clientHandler)
+		this->_clientHandler = std::make_unique<ClientHandler>();
+
+	this->_running = this->_clientHandler->listen(this->_port, maxConnections);
 	return this->_running;
 }
 
 int Server::checkForNewClients() {
-	TCPsocket new_tcpsock;
-	new_tcpsock = SDLNet_TCP_Accept(this->_sock);
-	if (!new_tcpsock) {
-		return -1;
-	}
-	else {
-		return this->_clientHandler.addNewConnection(new_tcpsock);
-	}
-	
+	return this->_clientHandler->checkForNewClients();
 }
 
 void Server::sendDataToAll(char * data, int length) {
-	std::vector<int> clients = this->_clientHandler.getAllClients();
+	std::vector<int> clients = this->_clientHandler->getAllClients();
 	for (size_t i = 0; i < clients.size(); i++) {
-		this->_clientHandler.sendData(data, length, clients[i]);
+		this->_clientHandler->sendData(data, length, clients[i]);
 	}
 }
 
 int Server::sendDataToClient(char * data, int length, int clientID) {
-	return this->_clientHandler.sendData(data, length, clientID);
-	
+	return this->_clientHandler->sendData(data, length, clientID);
+}
+
+bool Server::isCongested(int clientID) {
+	return this->_clientHandler->isCongested(clientID);
 }
 
 void Server::sendDataToAllExcept(char * data, int length, int clientID) {
-	std::vector<int> clients = this->_clientHandler.getAllClients();
+	std::vector<int> clients = this->_clientHandler->getAllClients();
 	for (size_t i = 0; i < clients.size(); i++) {
 		if (clients[i] != clientID) {
-			this->_clientHandler.sendData(data, length, clients[i]);
+			this->_clientHandler->sendData(data, length, clients[i]);
 		}
 	}
 }
 
 std::vector<int> Server::getDisconnects() {
-	return this->_clientHandler.getDisconnectedClients();
+	return this->_clientHandler->getDisconnectedClients();
 }
 
 std::vector<Hydra::Network::Packet*> Server::receiveData() {
-	return this->_clientHandler.getReceivedData(this->_clientHandler.getActivity());
+	return this->_clientHandler->receiveData();
 }
 
 
@@ -20,6 +20,7 @@
 #include <hydra/component/spawnercomponent.hpp>
 #include <hydra/component/networksynccomponent.hpp>
 #include <hydra/component/lightcomponent.hpp>
+#include <hydra/pathing/pathqueue.hpp>
 using world = Hydra::World::World;
 
 using namespace BarcodeServer;
@@ -28,24 +29,21 @@ TileGeneration::TileGeneration(size_t maxRooms, const std::string& middleRoomPat
 	_level = level;
 	mapentity = world::newEntity("Map", world::root());
 	_obtainRoomFiles();
-	pathfindingMap = new bool*[WORLD_MAP_SIZE];
-	for (int i = 0; i < WORLD_MAP_SIZE; i++) {
-		pathfindingMap[i] = new bool[WORLD_MAP_SIZE];
-		for (int j = 0; j < WORLD_MAP_SIZE; j++)
-			pathfindingMap[i][j] = false;
-	}
+	pathfindingMap = new PathMap();
 	_setUpMiddleRoom(middleRoomPath);
 }
 
 TileGeneration::~TileGeneration() {
-	mapentity->dead = true;
+	//The workers may still be searching the map and the room grid
+	PathQueue::instance().clear();
+	mapentity->kill();
 	for (size_t x = 0; x < ROOM_GRID_SIZE; x++)
 		for (size_t y = 0; y < ROOM_GRID_SIZE; y++)
 			roomGrid[x][y].reset();
 
-	for (size_t i = 0; i < WORLD_MAP_SIZE; i++)
-		delete[] pathfindingMap[i];
-	delete[] pathfindingMap;
+	//A new map may be allocated at the same address
+	PathFinding::clearRoomCache();
+	delete pathfindingMap;
 }
 
 void TileGeneration::buildMap() {
@@ -67,7 +65,7 @@ std::string BarcodeServer::TileGeneration::getPathMapAsString()
 	{
 		for (int x = 0; x < WORLD_MAP_SIZE; x++)
 		{
-			map.append(std::to_string(pathfindingMap[x][y]));
+			map.append(std::to_string(pathfindingMap->get(x, y)));
 		}
 	}
 	return map;
@@ -129,7 +127,7 @@ void TileGeneration::_createMapRecursivly(const glm::ivec2& pos) {
 					_createMapRecursivly(glm::ivec2(pos.x + offset[direction].x, pos.y + offset[direction].y));
 				}
 				else
-					loadedRoom->dead = true;
+					loadedRoom->kill();
 			}
 		}
 	}
@@ -237,7 +235,7 @@ bool TileGeneration::_generatePlayerSpawnPoints() {
 		if (sp->playerSpawn && !entities[i]->dead) {
 			auto t = entities[i]->getComponent<Hydra::Component::TransformComponent>();
 			playerSpawns.push_back(t->getMatrix()[3]);
-			entities[i]->dead = true;
+			entities[i]->kill();
 		}
 	}
 	if (playerSpawns.size() < numberOfPlayers) {
@@ -262,7 +260,7 @@ void TileGeneration::spawnEnemies() {
 			auto t = entities[i]->getComponent<Hydra::Component::TransformComponent>();
 			t->dirty = true;
 			_spawnRandomEnemy(t->getMatrix()[3]);
-			entities[i]->dead = true;
+			entities[i]->kill();
 			spawned++;
 		}
 	}
@@ -430,12 +428,12 @@ void TileGeneration::_createSpawner(std::shared_ptr<Hydra::World::Entity>& room,
 			auto t = entities[i]->getComponent<Hydra::Component::TransformComponent>();
 			t->dirty = true;
 			pos = t->getMatrix()[3];
-			entities[i]->dead = true;
+			entities[i]->kill();
 		}
 
 		if (sp->enemySpawn && !entities[i]->dead)
 		{
-			entities[i]->dead = true;
+			entities[i]->kill();
 		}
 	}
 
@@ -531,7 +529,7 @@ void TileGeneration::_clearSpawnPoints() {
 	world::getEntitiesWithComponents<Hydra::Component::SpawnPointComponent, Hydra::Component::TransformComponent>(entities);
 
 	for (auto e : entities)
-		e->dead = true;
+		e->kill();
 	deadSystem.tick(0);
 }
 
@@ -548,22 +546,22 @@ void TileGeneration::_insertPathFindingMap(const glm::ivec2& room, uint8_t rot)
 	case 0:
 		for (int localX = 0; localX < ROOM_MAP_SIZE; localX++)
 			for (int localY = 0; localY < ROOM_MAP_SIZE; localY++)
-				pathfindingMap[x + localX][y + localY] = roomC->localMap[localX][localY];
+				pathfindingMap->set(x + localX, y + localY, roomC->localMap[localX][localY]);
 		break;
 	case 1:
 		for (int localX = 0; localX < ROOM_MAP_SIZE; localX++)
 			for (int localY = 0; localY < ROOM_MAP_SIZE; localY++)
-				pathfindingMap[x + localX][y + localY] = roomC->localMap[ROOM_MAP_SIZE - 1 - localY][localX];
+				pathfindingMap->set(x + localX, y + localY, roomC->localMap[ROOM_MAP_SIZE - 1 - localY][localX]);
 		break;
 	case 2:
 		for (int localX = 0; localX < ROOM_MAP_SIZE; localX++)
 			for (int localY = 0; localY < ROOM_MAP_SIZE; localY++)
-				pathfindingMap[x + localX][y + localY] = roomC->localMap[ROOM_MAP_SIZE - 1 - localX][ROOM_MAP_SIZE - 1 - localY];
+				pathfindingMap->set(x + localX, y + localY, roomC->localMap[ROOM_MAP_SIZE - 1 - localX][ROOM_MAP_SIZE - 1 - localY]);
 		break;
 	case 3:
 		for (int localX = 0; localX < ROOM_MAP_SIZE; localX++)
 			for (int localY = 0; localY < ROOM_MAP_SIZE; localY++)
-				pathfindingMap[x + localX][y + localY] = roomC->localMap[localY][ROOM_MAP_SIZE - 1 - localX];
+				pathfindingMap->set(x + localX, y + localY, roomC->localMap[localY][ROOM_MAP_SIZE - 1 - localX]);
 		break;
 	default:
 		break;